@@ -4,16 +4,7 @@ local lanes = {}
 -- Gets the index to the nearest vertex to a position.
 --]]
 local function nearestVertex( vertices, pos )
-   local n = nil
-   local nd = math.huge
-   for k,v in ipairs(vertices) do
-      local d = v:dist2(pos)
-      if d < nd then
-         nd = d
-         n = k
-      end
-   end
-   return n
+   return (pos:nearest( vertices ))
 end
 
 --[[
@@ -294,15 +285,9 @@ end
 -- Gets squared distance and nearest point to safe lanes from a position
 --]]
 function lanes.getDistance2( L, pos )
-   local d = math.huge
-   local lp = pos
-   for k,v in ipairs(L.lanes) do
-      local pp = closestPointLine( v[1], v[2], pos )
-      local dp = pos:dist2( pp )
-      if dp < d then
-         d = dp
-         lp = pp
-      end
+   local _k, d, lp = pos:nearestLine( L.lanes )
+   if not d then
+      return math.huge, pos
    end
    return d, lp
 end
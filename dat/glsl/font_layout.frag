@@ -0,0 +1,19 @@
+#include "lib/math.glsl"
+
+uniform vec4 outline_color;
+uniform sampler2D sampler;
+
+in vec2 tex_coord_out;
+in vec4 color_out_vs;
+in float m_out;
+out vec4 color_out;
+
+void main(void) {
+   // Same as font.frag, except colour and m come per vertex from the cached layout.
+   float d  = 0.5 - texture(sampler, tex_coord_out).r;
+   float alpha = smoothstep(-0.5    *m_out, +0.5*m_out, -d);
+   float beta  = smoothstep(-M_SQRT2*m_out, -1.0*m_out, -d);
+   vec4 fg_c   = mix( outline_color, color_out_vs, alpha );
+   color_out   = vec4( fg_c.rgb, beta*fg_c.a );
+   gl_FragDepth = d*0.5 + 0.5;
+}
@@ -0,0 +1,25 @@
+uniform mat4 projection;
+uniform vec4 color;
+uniform vec4 base;
+
+in vec4 vertex;
+in vec2 tex_coord;
+in vec4 vertex_color;
+in float vertex_m;
+out vec2 tex_coord_out;
+out vec4 color_out_vs;
+out float m_out;
+
+void main(void) {
+   // Alpha of vertex_color says where the colour comes from: 0 starting colour,
+   // 1 base colour, 2 colour code in rgb (with the alpha of the starting colour).
+   if (vertex_color.a < 0.5)
+      color_out_vs = color;
+   else if (vertex_color.a < 1.5)
+      color_out_vs = base;
+   else
+      color_out_vs = vec4( vertex_color.rgb, color.a );
+   tex_coord_out = tex_coord;
+   m_out         = vertex_m;
+   gl_Position   = projection * vertex;
+}
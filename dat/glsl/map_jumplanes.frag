@@ -0,0 +1,20 @@
+#include "lib/sdf.glsl"
+
+uniform float radius;
+
+in vec2 pos;
+in vec2 dimensions;
+in vec4 color;
+in vec4 color2;
+out vec4 color_out;
+
+/* Same as jumplane.frag with the per-lane parameters as inputs. */
+void main(void) {
+   vec2 uv        = pos * dimensions;
+   float d        = sdBox( uv, dimensions-vec2(1.0) );
+   float alpha    = smoothstep( -1.0,  0.0, -d);
+   color_out      = mix( color, color2, smoothstep(0.0,1.0,pos.x*0.5+0.5) );
+   color_out.a   *= 0.8 - 0.6*abs(pos.x);
+   color_out.a   *= smoothstep(dimensions.x, dimensions.x-radius, length(uv));
+   color_out.a   *= alpha;
+}
@@ -0,0 +1,30 @@
+uniform mat4 projection;
+uniform vec3 view; /* Screen offset (xy) and zoom (z). */
+
+in vec2 vertex;
+in vec4 vertex_lane; /* Start (xy) and end (zw) in map coordinates. */
+in vec4 vertex_color;
+in vec4 vertex_color2;
+in float vertex_width;
+
+out vec2 pos;
+out vec2 dimensions;
+out vec4 color;
+out vec4 color2;
+
+void main(void) {
+   vec2 p1  = view.xy + vertex_lane.xy * view.z;
+   vec2 p2  = view.xy + vertex_lane.zw * view.z;
+   vec2 d   = p2 - p1;
+   float l  = length(d);
+   vec2 dir = (l > 0.0) ? d / l : vec2(1.0, 0.0);
+   vec2 nrm = vec2(-dir.y, dir.x);
+
+   pos         = vertex;
+   dimensions  = vec2( 0.5*l, vertex_width );
+   color       = vertex_color;
+   color2      = vertex_color2;
+
+   vec2 p = 0.5*(p1+p2) + dir*dimensions.x*vertex.x + nrm*dimensions.y*vertex.y;
+   gl_Position = projection * vec4( p, 0.0, 1.0 );
+}
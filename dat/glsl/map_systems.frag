@@ -0,0 +1,17 @@
+#include "lib/sdf.glsl"
+
+in vec2 pos;
+in float r;
+in float filled;
+in vec4 color;
+out vec4 color_out;
+
+/* Same as circle.frag with the per-disk parameters as inputs. */
+void main(void) {
+   float d = sdCircle( pos*r, r-1.0 );
+   if (filled < 0.5)
+      d = abs(d);
+   float alpha = smoothstep(-1.0, 0.0, -d);
+   color_out   = color;
+   color_out.a *= alpha;
+}
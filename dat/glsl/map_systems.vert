@@ -0,0 +1,23 @@
+uniform mat4 projection;
+uniform vec3 view; /* Screen offset (xy) and zoom (z). */
+uniform float radius;
+
+in vec2 vertex;
+in vec2 vertex_center; /* Position in map coordinates. */
+in vec2 vertex_disk; /* Radius multiplier (x) and whether it is filled (y). */
+in vec4 vertex_color;
+
+out vec2 pos;
+out float r;
+out float filled;
+out vec4 color;
+
+void main(void) {
+   pos      = vertex;
+   r        = radius * vertex_disk.x;
+   filled   = vertex_disk.y;
+   color    = vertex_color;
+
+   vec2 p = view.xy + vertex_center * view.z + vertex * r;
+   gl_Position = projection * vec4( p, 0.0, 1.0 );
+}
@@ -0,0 +1,28 @@
+#include "lib/sdf.glsl"
+
+in vec2 pos;
+in vec2 dimensions;
+in float shape;
+in vec4 color;
+out vec4 color_out;
+
+/* Same as pilotmarker.frag (shape 0) and asteroidmarker.frag (shape 1) with
+ * the per-marker parameters as inputs. */
+void main(void) {
+   float d, alpha, beta;
+   if (shape < 0.5) {
+      vec2 uv = vec2( pos.y, pos.x );
+      float m = 1.0 / dimensions.x;
+      d = sdTriangleEquilateral( uv*1.15  ) / 1.15;
+      d = abs(d+2.0*m);
+      alpha = smoothstep(    -m, 0.0, -d);
+      beta  = smoothstep(-2.0*m,  -m, -d);
+   }
+   else {
+      vec2 uv = pos * dimensions;
+      d = sdBox( uv, dimensions-vec2(2.0) );
+      alpha = smoothstep(-1.0,  0.0, -d);
+      beta  = smoothstep(-2.0, -1.0, -d);
+   }
+   color_out   = color * vec4( vec3(alpha), beta );
+}
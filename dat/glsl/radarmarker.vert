@@ -0,0 +1,26 @@
+uniform mat4 projection;
+
+in vec2 vertex;
+in vec2 vertex_center; /* Position on screen. */
+in vec2 vertex_size; /* Half size (dimensions) of the marker. */
+in float vertex_angle;
+in float vertex_shape;
+in vec4 vertex_color;
+
+out vec2 pos;
+out vec2 dimensions;
+out float shape;
+out vec4 color;
+
+void main(void) {
+   pos         = vertex;
+   dimensions  = vertex_size;
+   shape       = vertex_shape;
+   color       = vertex_color;
+
+   float c = cos(vertex_angle);
+   float s = sin(vertex_angle);
+   vec2 p = vertex * vertex_size;
+   p = vertex_center + vec2( c*p.x - s*p.y, s*p.x + c*p.y );
+   gl_Position = projection * vec4( p, 0.0, 1.0 );
+}
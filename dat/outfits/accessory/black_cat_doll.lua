@@ -6,6 +6,9 @@ function onstealth( _p, po, stealthed )
    end
 end
 
-function update( p, po )
-   onstealth( p, po, p:flags("stealth") )
+-- Run once for all the pilots with the outfit
+function update_all( list )
+   for i,e in ipairs(list) do
+      onstealth( e.p, e.po, e.p:flags("stealth") )
+   end
 end
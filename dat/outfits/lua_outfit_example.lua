@@ -67,6 +67,14 @@ end
 function update( _p, _po, _dt )
 end
 
+-- The update_all function replaces update and is run once for all the pilots
+-- that have the outfit equipped, which is faster for common outfits. 'list' is
+-- an array of tables with the fields 'p', 'po', and 'mem' for each instance,
+-- and 'dt' is the same as in update. The global 'mem' is not set, and the
+-- tables in 'list' are reused so references to them should not be kept.
+function update_all( _list, _dt )
+end
+
 -- When the pilot is out of energy, this function triggers. Note that before
 -- this triggers, 'ontoggle( p, po false )' will be run if it exists.
 -- This is especially useful for outfits that can't be toggled, but want to
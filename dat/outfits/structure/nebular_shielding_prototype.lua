@@ -9,7 +9,7 @@ function init( _p, po )
    mem.force_off = false
 end
 
-function update( _p, po )
+local function update_one( _p, po )
    if mem.nebu_vol <= 0 or mem.force_off then
       return
    end
@@ -19,6 +19,14 @@ function update( _p, po )
    po:set( "energy_loss", regen )
 end
 
+-- Run once for all the pilots with the outfit, the global mem isn't set
+function update_all( list, dt )
+   for i,e in ipairs(list) do
+      mem = e.mem
+      update_one( e.p, e.po, dt )
+   end
+end
+
 
 function ontoggle( _p, po, on )
    if mem.nebu_vol <= 0 then
@@ -1,8 +1,11 @@
-function update( p, po )
-   local a = p:health()
-   if a > 50 then
-      po:state( "off" )
-   else
-      po:state( "on" )
+-- Run once for all the pilots with the outfit
+function update_all( list )
+   for i,e in ipairs(list) do
+      local a = e.p:health()
+      if a > 50 then
+         e.po:state( "off" )
+      else
+         e.po:state( "on" )
+      end
    end
 end
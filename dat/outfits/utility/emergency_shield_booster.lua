@@ -51,7 +51,7 @@ function init( p, po )
    po:state("off")
 end
 
-function update( p, po, dt )
+local function update_one( p, po, dt )
    mem.timer = mem.timer - dt
    if mem.active then
       po:progress( mem.timer / active )
@@ -67,6 +67,14 @@ function update( p, po, dt )
    end
 end
 
+-- Run once for all the pilots with the outfit, the global mem isn't set
+function update_all( list, dt )
+   for i,e in ipairs(list) do
+      mem = e.mem
+      update_one( e.p, e.po, dt )
+   end
+end
+
 function ontoggle( p, po, on )
    if on then
       return turnon( p, po )
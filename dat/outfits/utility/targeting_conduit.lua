@@ -1,8 +1,11 @@
-function update( p, po )
-   local _a, s = p:health()
-   if s < 70 then
-      po:state( "off" )
-   else
-      po:state( "on" )
+-- Run once for all the pilots with the outfit
+function update_all( list )
+   for i,e in ipairs(list) do
+      local _a, s = e.p:health()
+      if s < 70 then
+         e.po:state( "off" )
+      else
+         e.po:state( "on" )
+      end
    end
 end
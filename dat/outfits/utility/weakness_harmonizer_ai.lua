@@ -15,7 +15,7 @@ function init( p, po )
    mem.nearby = 0
 end
 
-function update( p, po, _dt )
+local function update_one( p, po, _dt )
    local h = p:getEnemies(range) -- Only consider visible ships
    local n = 0
    for k,v in ipairs(h) do
@@ -41,3 +41,11 @@ function update( p, po, _dt )
       mem.nearby = n
    end
 end
+
+-- Run once for all the pilots with the outfit, the global mem isn't set
+function update_all( list, dt )
+   for i,e in ipairs(list) do
+      mem = e.mem
+      update_one( e.p, e.po, dt )
+   end
+end
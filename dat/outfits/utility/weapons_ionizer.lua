@@ -7,7 +7,7 @@ function init( _p, po )
    po:state( "off" )
 end
 
-function update( p, po, _dt )
+local function update_one( p, po, _dt )
    -- Ignore if forced
    if mem.forced_on then return end
 
@@ -27,6 +27,14 @@ function update( p, po, _dt )
    po:state( "on" )
 end
 
+-- Run once for all the pilots with the outfit, the global mem isn't set
+function update_all( list, dt )
+   for i,e in ipairs(list) do
+      mem = e.mem
+      update_one( e.p, e.po, dt )
+   end
+end
+
 function ontoggle( _p, po, on )
    if on then
       po:state( "on" )
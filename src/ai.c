@@ -337,6 +337,7 @@ Pilot *cur_pilot           = NULL; /**< Current pilot.  All functions use this.
 static double pilot_acc    = 0.; /**< Current pilot's acceleration. */
 static double pilot_turn   = 0.; /**< Current pilot's turning. */
 static int pilot_flags     = 0; /**< Handle stuff like weapon firing. */
+static unsigned int pilot_weapsets = 0; /**< Weapon sets pressed during the current think. */
 static char aiL_distressmsg[STRMAX_SHORT]; /**< Buffer to store distress message. */
 
 /*
@@ -734,13 +735,10 @@ void ai_think( Pilot* pilot, const double dt )
    pilot_acc         = 0;
    pilot_turn        = 0.;
    pilot_flags       = 0;
-   /* So the way this works is that, for other than the player, we reset all
-    * the weapon sets every frame, so that the AI has to redo them over and
-    * over. Now, this is a horrible hack so shit works and needs a proper fix.
-    * TODO fix. */
-   /* pilot_setTarget( cur_pilot, cur_pilot->id ); */
-   if (cur_pilot->id != PLAYER_ID)
-      pilot_weapSetAIClear( cur_pilot );
+   /* The AI has to keep pressing the weapon sets it wants to fire every
+    * think. They stay active across frames and only the ones it didn't press
+    * again get released once it is done thinking. */
+   pilot_weapsets    = 0;
 
    /* Get current task. */
    t = ai_curTask( cur_pilot );
@@ -798,6 +796,10 @@ void ai_think( Pilot* pilot, const double dt )
       }
    }
 
+   /* Release the weapon sets that weren't held. */
+   if (cur_pilot->id != PLAYER_ID)
+      pilot_weapSetAIRelease( cur_pilot, pilot_weapsets );
+
    /* make sure pilot_acc and pilot_turn are legal */
    pilot_acc   = CLAMP( -1., 1., pilot_acc );
    pilot_turn  = CLAMP( -1., 1., pilot_turn );
@@ -2880,8 +2882,10 @@ static int aiL_weapSet( lua_State *L )
    }
    else {
       /* weapset type is weapon or change */
-      if (type)
+      if (type) {
+         pilot_weapsets |= (1U << id);
          pilot_weapSetPress( cur_pilot, id, +1 );
+      }
       else
          pilot_weapSetPress( cur_pilot, id, -1 );
    }
@@ -10,6 +10,7 @@
 
 #include "array.h"
 
+#include "nmemory.h"
 #include "nstring.h"
 
 void *_array_create_helper(size_t e_size, size_t capacity)
@@ -17,7 +18,7 @@ void *_array_create_helper(size_t e_size, size_t capacity)
    if ( capacity <= 0 )
       capacity = 1;
 
-   _private_container *c = malloc(sizeof(_private_container) + e_size * capacity);
+   _private_container *c = nmem_malloc(MEM_ARRAY, sizeof(_private_container) + e_size * capacity);
 #if DEBUG_ARRAYS
    c->_sentinel = ARRAY_SENTINEL;
 #endif
@@ -37,7 +38,7 @@ static void _array_resize_container(_private_container **c_, size_t e_size, size
          c->_reserved *= 2;
       while (new_size > c->_reserved);
 
-      c = realloc(c, sizeof(_private_container) + e_size * c->_reserved);
+      c = nmem_realloc(MEM_ARRAY, c, sizeof(_private_container) + e_size * c->_reserved);
    }
 
    c->_size = new_size;
@@ -57,7 +58,7 @@ void *_array_grow_helper(void **a, size_t e_size)
    if (c->_size == c->_reserved) {
       /* Array full, doubles the reserved memory */
       c->_reserved *= 2;
-      c = realloc(c, sizeof(_private_container) + e_size * c->_reserved);
+      c = nmem_realloc(MEM_ARRAY, c, sizeof(_private_container) + e_size * c->_reserved);
       *a = c->_array;
    }
 
@@ -84,10 +85,10 @@ void _array_shrink_helper(void **a, size_t e_size)
 {
    _private_container *c = _array_private_container(*a);
    if (c->_size != 0) {
-      c = realloc(c, sizeof(_private_container) + e_size * c->_size);
+      c = nmem_realloc(MEM_ARRAY, c, sizeof(_private_container) + e_size * c->_size);
       c->_reserved = c->_size;
    } else {
-      c = realloc(c, sizeof(_private_container) + e_size);
+      c = nmem_realloc(MEM_ARRAY, c, sizeof(_private_container) + e_size);
       c->_reserved = 1;
    }
    *a = c->_array;
@@ -97,7 +98,7 @@ void _array_free_helper(void *a)
 {
    if (a==NULL)
       return;
-   free(_array_private_container(a));
+   nmem_free(MEM_ARRAY, _array_private_container(a));
 }
 
 void *_array_copy_helper(size_t e_size, void *a)
@@ -37,6 +37,15 @@ typedef struct Debris_ {
    double alpha;  /**< Alpha value. */
 } Debris;
 
+/**
+ * @brief Exclusion zone affecting the field being updated.
+ */
+typedef struct AsteroidExclusionActive_ {
+   double x;   /**< X position. */
+   double y;   /**< Y position. */
+   double r2;  /**< Squared radius. */
+} AsteroidExclusionActive;
+
 const double DEBRIS_BUFFER = 1000.; /**< Buffer to smooth appearance of debris */
 
 static const double SCAN_FADE = 10.; /**< 1/time it takes to fade in/out scanning text. */
@@ -51,6 +60,7 @@ static AsteroidType *asteroid_types = NULL; /**< Asteroid types stack (array.h).
 static AsteroidTypeGroup *asteroid_groups = NULL; /**< Asteroid type groups stack (array.h). */
 static glTexture **asteroid_gfx = NULL; /**< Graphics for the asteroids (array.h). */
 static int asteroid_creating = 0;
+static AsteroidExclusionActive *asteroid_exclusions = NULL; /**< Exclusion zones affecting the field being updated (array.h). */
 
 /* Prototypes. */
 static int asttype_cmp( const void *p1, const void *p2 );
@@ -60,12 +70,152 @@ static int astgroup_cmp( const void *p1, const void *p2 );
 static int astgroup_parse( AsteroidTypeGroup *ag, const char *file );
 static int asttype_load (void);
 
+static void asteroid_updateMovement( AsteroidAnchor *ast, double dt );
+static void asteroid_updateStates( AsteroidAnchor *ast, double dt );
 static void asteroid_renderSingle( const Asteroid *a );
+static void asteroid_renderScan( const Asteroid *a );
 static void debris_renderSingle( const Debris *d, double cx, double cy );
 static void debris_init( Debris *deb );
 static int asteroid_init( Asteroid *ast, const AsteroidAnchor *field );
 
 
+/**
+ * @brief Updates the movement of the asteroids in a field.
+ *
+ * Only does the kinematics, state changes are done separately in asteroid_updateStates().
+ *
+ *    @param ast Asteroid field to update.
+ *    @param dt Current delta tick.
+ */
+static void asteroid_updateMovement( AsteroidAnchor *ast, double dt )
+{
+   const double cx = ast->pos.x;
+   const double cy = ast->pos.y;
+   const double r2 = pow2(ast->radius);
+   const double tdt = ast->thrust * dt;
+   const double vmax = ast->maxspeed;
+   const double vmax2 = pow2(ast->maxspeed);
+   const int nexc = array_size(asteroid_exclusions);
+
+   for (int j=0; j<ast->nb; j++) {
+      Asteroid *a = &ast->asteroids[j];
+      double offx, offy, d;
+      int setvel = 0;
+
+      /* Skip inexistent asteroids. */
+      if (a->state == ASTEROID_XX)
+         continue;
+
+      /* Push back towards center. */
+      offx = cx - a->pos.x;
+      offy = cy - a->pos.y;
+      d = pow2(offx)+pow2(offy);
+      if (d >= r2) {
+         d = tdt / sqrt(d);
+         a->vel.x += offx * d;
+         a->vel.y += offy * d;
+         setvel = 1;
+      }
+      else {
+         /* Push away from exclusion areas. */
+         for (int k=0; k<nexc; k++) {
+            const AsteroidExclusionActive *exc = &asteroid_exclusions[k];
+            double ex = a->pos.x - exc->x;
+            double ey = a->pos.y - exc->y;
+            double ed = pow2(ex) + pow2(ey);
+            if (ed <= exc->r2) {
+               ed = tdt / sqrt(ed);
+               a->vel.x += ex * ed;
+               a->vel.y += ey * ed;
+               setvel = 1;
+            }
+         }
+      }
+
+      /* Enforce max speed. */
+      if (setvel) {
+         d = pow2(a->vel.x) + pow2(a->vel.y);
+         if (d > vmax2) {
+            d = vmax / sqrt(d);
+            a->vel.x *= d;
+            a->vel.y *= d;
+         }
+      }
+
+      /* Integrate. */
+      a->pos.x += a->vel.x * dt;
+      a->pos.y += a->vel.y * dt;
+      a->ang   += a->spin * dt;
+   }
+}
+
+/**
+ * @brief Updates the timers and state machine of the asteroids in a field.
+ *
+ *    @param ast Asteroid field to update.
+ *    @param dt Current delta tick.
+ */
+static void asteroid_updateStates( AsteroidAnchor *ast, double dt )
+{
+   for (int j=0; j<ast->nb; j++) {
+      Asteroid *a = &ast->asteroids[j];
+
+      a->timer -= dt;
+
+      /* Inexistent asteroids only wait to appear. */
+      if (a->state == ASTEROID_XX) {
+         if (a->timer < 0.) {
+            a->state = ASTEROID_XX_TO_BG;
+            a->timer_max = a->timer = 1. + 3.*RNGF();
+         }
+         continue;
+      }
+
+      /* Update scanned state if necessary. */
+      if (a->scanned) {
+         if (a->state == ASTEROID_FG)
+            a->scan_alpha = MIN( a->scan_alpha+SCAN_FADE*dt, 1.);
+         else
+            a->scan_alpha = MAX( a->scan_alpha-SCAN_FADE*dt, 0.);
+      }
+
+      if (a->timer >= 0.)
+         continue;
+
+      switch (a->state) {
+         /* Transition states. */
+         case ASTEROID_FG:
+            pilot_untargetAsteroid( a->parent, a->id );
+            FALLTHROUGH;
+         case ASTEROID_XB:
+         case ASTEROID_BX:
+         case ASTEROID_XX_TO_BG:
+            a->timer_max = a->timer = 1. + 3.*RNGF();
+            break;
+
+         /* Longer states. */
+         case ASTEROID_FG_TO_BG:
+            a->timer_max = a->timer = 10. + 20.*RNGF();
+            break;
+         case ASTEROID_BG_TO_FG:
+            a->timer_max = a->timer = 90. + 30.*RNGF();
+            break;
+
+         /* Special case needs to respawn. */
+         case ASTEROID_BG_TO_XX:
+            asteroid_init( a, ast );
+            a->timer_max = a->timer = 10. + 20.*RNGF();
+            break;
+
+         case ASTEROID_XX:
+            /* Do nothing. */
+            break;
+      }
+      /* States should be in proper order. */
+      a->state = (a->state+1) % ASTEROID_STATE_MAX;
+   }
+}
+
 /**
  * @brief Controls fleet spawning.
  *
@@ -73,127 +223,30 @@ static int asteroid_init( Asteroid *ast, const AsteroidAnchor *field );
  */
 void asteroids_update( double dt )
 {
+   if (asteroid_exclusions == NULL)
+      asteroid_exclusions = array_create( AsteroidExclusionActive );
+
    /* Asteroids/Debris update */
    for (int i=0; i<array_size(cur_system->asteroids); i++) {
-      int has_exclusion = 0;
       AsteroidAnchor *ast = &cur_system->asteroids[i];
 
+      /* Only keep the exclusion zones that can affect the field. */
+      array_resize( &asteroid_exclusions, 0 );
       for (int k=0; k<array_size(cur_system->astexclude); k++) {
          AsteroidExclusion *exc = &cur_system->astexclude[k];
          if (vec2_dist2( &ast->pos, &exc->pos ) < pow2(ast->radius+exc->radius)) {
+            AsteroidExclusionActive *e = &array_grow( &asteroid_exclusions );
+            e->x  = exc->pos.x;
+            e->y  = exc->pos.y;
+            e->r2 = pow2(exc->radius);
             exc->affects = 1;
-            has_exclusion = 1;
          }
          else
             exc->affects = 0;
       }
 
-      for (int j=0; j<ast->nb; j++) {
-         double offx, offy, d;
-         Asteroid *a = &ast->asteroids[j];
-         int setvel = 0;
-
-         /* Skip inexistent asteroids. */
-         if (a->state == ASTEROID_XX) {
-            a->timer -= dt;
-            if (a->timer < 0.) {
-               a->state = ASTEROID_XX_TO_BG;
-               a->timer_max = a->timer = 1. + 3.*RNGF();
-            }
-            continue;
-         }
-
-         /* Push back towards center. */
-         offx = ast->pos.x - a->pos.x;
-         offy = ast->pos.y - a->pos.y;
-         d = pow2(offx)+pow2(offy);
-         if (d >= pow2(ast->radius)) {
-            d = sqrt(d);
-            a->vel.x += ast->thrust * dt * offx / d;
-            a->vel.y += ast->thrust * dt * offy / d;
-            setvel = 1;
-         }
-         else if (has_exclusion) {
-            /* Push away from exclusion areas. */
-            for (int k=0; k<array_size(cur_system->astexclude); k++) {
-               AsteroidExclusion *exc = &cur_system->astexclude[k];
-               double ex, ey, ed;
-
-               /* Ignore exclusion zones that shouldn't affect. */
-               if (!exc->affects)
-                  continue;
-
-               ex = a->pos.x - exc->pos.x;
-               ey = a->pos.y - exc->pos.y;
-               ed = pow2(ex) + pow2(ey);
-               if (ed <= pow2(exc->radius)) {
-                  ed = sqrt(ed);
-                  a->vel.x += ast->thrust * dt * ex / ed;
-                  a->vel.y += ast->thrust * dt * ey / ed;
-                  setvel = 1;
-               }
-            }
-         }
-
-         if (setvel) {
-            /* Enforce max speed. */
-            d = MOD(a->vel.x, a->vel.y);
-            if (d > ast->maxspeed) {
-               a->vel.x *= ast->maxspeed / d;
-               a->vel.y *= ast->maxspeed / d;
-            }
-         }
-
-         /* Update position. */
-         a->pos.x += a->vel.x * dt;
-         a->pos.y += a->vel.y * dt;
-
-         /* Update angle. */
-         a->ang += a->spin * dt;
-
-         /* Update scanned state if necessary. */
-         if (a->scanned) {
-            if (a->state == ASTEROID_FG)
-               a->scan_alpha = MIN( a->scan_alpha+SCAN_FADE*dt, 1.);
-            else
-               a->scan_alpha = MAX( a->scan_alpha-SCAN_FADE*dt, 0.);
-         }
-
-         a->timer -= dt;
-         if (a->timer < 0.) {
-            switch (a->state) {
-               /* Transition states. */
-               case ASTEROID_FG:
-                  pilot_untargetAsteroid( a->parent, a->id );
-                  FALLTHROUGH;
-               case ASTEROID_XB:
-               case ASTEROID_BX:
-               case ASTEROID_XX_TO_BG:
-                  a->timer_max = a->timer = 1. + 3.*RNGF();
-                  break;
-
-               /* Longer states. */
-               case ASTEROID_FG_TO_BG:
-                  a->timer_max = a->timer = 10. + 20.*RNGF();
-                  break;
-               case ASTEROID_BG_TO_FG:
-                  a->timer_max = a->timer = 90. + 30.*RNGF();
-                  break;
-
-               /* Special case needs to respawn. */
-               case ASTEROID_BG_TO_XX:
-                  asteroid_init( a, ast );
-                  a->timer_max = a->timer = 10. + 20.*RNGF();
-                  break;
-
-               case ASTEROID_XX:
-                  /* Do nothing. */
-                  break;
-            }
-            /* States should be in proper order. */
-            a->state = (a->state+1) % ASTEROID_STATE_MAX;
-         }
-      }
+      asteroid_updateMovement( ast, dt );
+      asteroid_updateStates( ast, dt );
    }
 
    /* Only have to update stuff if not simulating. */
@@ -772,11 +825,13 @@ void asteroids_renderOverlay (void)
    cy -= SCREEN_H/2.;
 
    /* Render the debris. */
+   gl_batchBegin();
    for (int j=0; j<array_size(debris_stack); j++) {
       Debris *d = &debris_stack[j];
       if (d->height > 1.)
          debris_renderSingle( d, cx, cy );
    }
+   gl_batchEnd();
 }
 
 /**
@@ -789,7 +844,8 @@ void asteroids_render (void)
    cx -= SCREEN_W/2.;
    cy -= SCREEN_H/2.;
 
-   /* Render the asteroids & debris. */
+   /* Render the asteroids & debris, sprites get batched by texture. */
+   gl_batchBegin();
    for (int i=0; i<array_size(cur_system->asteroids); i++) {
       AsteroidAnchor *ast = &cur_system->asteroids[i];
       for (int j=0; j<ast->nb; j++)
@@ -802,6 +858,14 @@ void asteroids_render (void)
       if (d->height <= 1.)
          debris_renderSingle( d, cx, cy );
    }
+   gl_batchEnd();
+
+   /* Scan information goes over the sprites. */
+   for (int i=0; i<array_size(cur_system->asteroids); i++) {
+      AsteroidAnchor *ast = &cur_system->asteroids[i];
+      for (int j=0; j<ast->nb; j++)
+        asteroid_renderScan( &ast->asteroids[j] );
+   }
 
    /* Render gatherable stuff. */
    gatherable_render();
@@ -812,8 +876,6 @@ void asteroids_render (void)
  */
 static void asteroid_renderSingle( const Asteroid *a )
 {
-   double nx, ny;
-   const AsteroidType *at;
    glColour col;
    double progress;
    const glColour darkcol = cGrey20;
@@ -850,12 +912,25 @@ static void asteroid_renderSingle( const Asteroid *a )
          break;
    }
 
-   at = a->type;
    gl_renderSpriteRotate( a->gfx, a->pos.x, a->pos.y, a->ang, 0, 0, &col );
+}
 
-   /* Add the commodities if scanned. */
-   if (!a->scanned)
+/**
+ * @brief Renders the scan information of an asteroid.
+ *
+ *    @param a Asteroid to render scan information of.
+ */
+static void asteroid_renderScan( const Asteroid *a )
+{
+   double nx, ny;
+   const AsteroidType *at;
+   glColour col;
+
+   /* Only scanned and visible asteroids. */
+   if (!a->scanned || (a->state == ASTEROID_XX))
       return;
+
+   at = a->type;
    col = cFontWhite;
    col.a = a->scan_alpha;
    gl_gameToScreenCoords( &nx, &ny, a->pos.x, a->pos.y );
@@ -906,6 +981,8 @@ void asteroids_free (void)
       gl_freeTexture(asteroid_gfx[i]);
    array_free(asteroid_gfx);
    array_free(debris_gfx);
+   array_free(asteroid_exclusions);
+   asteroid_exclusions = NULL;
 
    /* Free the asteroid types. */
    for (int i=0; i<array_size(asteroid_types); i++) {
@@ -918,10 +995,8 @@ void asteroids_free (void)
       array_free(at->gfxs);
 
       /* Free collision polygons. */
-      for (int j=0; j<array_size(at->polygon); j++) {
-         free(at->polygon[j].x);
-         free(at->polygon[j].y);
-      }
+      for (int j=0; j<array_size(at->polygon); j++)
+         FreePolygon( &at->polygon[j] );
       array_free(at->polygon);
    }
    array_free(asteroid_types);
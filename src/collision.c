@@ -22,6 +22,65 @@ static int pointInPolygon( const CollPoly* at, const vec2* ap,
       float x, float y );
 static int LineOnPolygon( const CollPoly* at, const vec2* ap,
       float x1, float y1, float x2, float y2, vec2* crash );
+static void PolygonComputeInternals( CollPoly* polygon );
+static int PolygonSeparatedAxes( const CollPoly* at, const CollPoly* bt,
+      float dx, float dy );
+static const uint64_t* CollideMaskRow( const glTexture* t, int sx, int sy, int y );
+static uint64_t CollideMaskBits( const uint64_t* row, int words, int off );
+static int CollideMaskTest( const glTexture* t, int sx, int sy, int x, int y );
+
+
+/**
+ * @brief Gets a row of the collision mask of a sprite.
+ *
+ *    @param t Texture to get row of.
+ *    @param sx X position of the sprite.
+ *    @param sy Y position of the sprite.
+ *    @param y Row of the sprite (flipped like the transparency map).
+ *    @return The row as an array of t->mask_words words.
+ */
+static const uint64_t* CollideMaskRow( const glTexture* t, int sx, int sy, int y )
+{
+   return &t->mask[ ((size_t)(sy*(int)t->sx + sx)*(int)t->sh + y) * t->mask_words ];
+}
+
+/**
+ * @brief Gets 64 bits of a mask row starting at an arbitrary bit.
+ *
+ *    @param row Row to get bits from.
+ *    @param words Number of words in the row.
+ *    @param off First bit to get.
+ *    @return The bits, with the ones past the end of the row set to 0.
+ */
+static uint64_t CollideMaskBits( const uint64_t* row, int words, int off )
+{
+   int w = off / 64;
+   int b = off % 64;
+   uint64_t m;
+
+   if (w >= words)
+      return 0;
+   m = row[w] >> b;
+   if ((b > 0) && (w+1 < words))
+      m |= row[w+1] << (64-b);
+   return m;
+}
+
+/**
+ * @brief Checks to see if a pixel of a sprite is opaque.
+ *
+ *    @param t Texture to check.
+ *    @param sx X position of the sprite.
+ *    @param sy Y position of the sprite.
+ *    @param x X position of the pixel in the sprite.
+ *    @param y Y position of the pixel in the sprite (flipped).
+ *    @return 1 if the pixel is opaque, 0 otherwise.
+ */
+static int CollideMaskTest( const glTexture* t, int sx, int sy, int x, int y )
+{
+   const uint64_t *row = CollideMaskRow( t, sx, sy, y );
+   return (row[ x/64 ] >> (x%64)) & 1;
+}
 
 /**
  * @brief Loads a polygon from an xml node.
@@ -74,7 +133,103 @@ void LoadPolygon( CollPoly* polygon, xmlNodePtr node )
       }
    } while (xml_nextNode(cur));
 
-   return;
+   PolygonComputeInternals( polygon );
+}
+
+/**
+ * @brief Frees the data of a polygon.
+ *
+ *    @param polygon Polygon to free.
+ */
+void FreePolygon( CollPoly* polygon )
+{
+   free( polygon->x );
+   free( polygon->y );
+   free( polygon->nx );
+   free( polygon->ny );
+}
+
+/**
+ * @brief Computes the bounding radius, edge normals and convexity of a polygon.
+ *
+ *    @param polygon Polygon to compute internals of.
+ */
+static void PolygonComputeInternals( CollPoly* polygon )
+{
+   int n = polygon->npt;
+   int sign = 0;
+   float area = 0.;
+
+   polygon->nx = malloc( MAX(n,1)*sizeof(float) );
+   polygon->ny = malloc( MAX(n,1)*sizeof(float) );
+   polygon->rad = 0.;
+   polygon->convex = (n >= 3);
+
+   for (int i=0; i<n; i++) {
+      int j = (i+1) % n;
+      int k = (i+2) % n;
+      float ex = polygon->x[j] - polygon->x[i];
+      float ey = polygon->y[j] - polygon->y[i];
+      float cross = ex * (polygon->y[k]-polygon->y[j]) - ey * (polygon->x[k]-polygon->x[j]);
+
+      polygon->rad = MAX( polygon->rad,
+            pow2(polygon->x[i]) + pow2(polygon->y[i]) );
+      area += polygon->x[i]*polygon->y[j] - polygon->x[j]*polygon->y[i];
+
+      /* Outward normal assuming counter-clockwise order, fixed below. */
+      polygon->nx[i] = ey;
+      polygon->ny[i] = -ex;
+
+      /* Convex if it always turns the same way. */
+      if (cross != 0.) {
+         int s = (cross > 0.) ? 1 : -1;
+         if (sign == 0)
+            sign = s;
+         else if (s != sign)
+            polygon->convex = 0;
+      }
+   }
+   polygon->rad = sqrt( polygon->rad );
+
+   /* Clockwise polygons have their normals pointing inwards. */
+   if (area < 0.) {
+      for (int i=0; i<n; i++) {
+         polygon->nx[i] = -polygon->nx[i];
+         polygon->ny[i] = -polygon->ny[i];
+      }
+   }
+}
+
+/**
+ * @brief Checks to see if the edge normals of a convex polygon separate it from another.
+ *
+ * Since the polygon is convex, its furthest point along an edge's outward
+ *  normal is on the edge itself, so only the other polygon needs projecting.
+ *
+ *    @param at Convex polygon whose edges to use as axes.
+ *    @param bt Convex polygon to test against.
+ *    @param dx X position of bt relative to at.
+ *    @param dy Y position of bt relative to at.
+ *    @return 1 if an axis separates the polygons, 0 otherwise.
+ */
+static int PolygonSeparatedAxes( const CollPoly* at, const CollPoly* bt,
+      float dx, float dy )
+{
+   for (int i=0; i<at->npt; i++) {
+      float nx = at->nx[i];
+      float ny = at->ny[i];
+      float amax = nx*at->x[i] + ny*at->y[i] - nx*dx - ny*dy;
+      int separated = 1;
+      for (int j=0; j<bt->npt; j++) {
+         if (nx*bt->x[j] + ny*bt->y[j] <= amax) {
+            separated = 0;
+            break;
+         }
+      }
+      if (separated)
+         return 1;
+   }
+   return 0;
 }
 
 /**
@@ -98,12 +253,10 @@ int CollideSprite( const glTexture* at, const int asx, const int asy, const vec2
       const glTexture* bt, const int bsx, const int bsy, const vec2* bp,
       vec2* crash )
 {
-   int x,y;
    int ax1,ax2, ay1,ay2;
    int bx1,bx2, by1,by2;
    int inter_x0, inter_x1, inter_y0, inter_y1;
-   int rasy, rbsy;
-   int abx,aby, bbx, bby;
+   const int *abox, *bbox;
 
 #if DEBUGGING
    /* Make sure the surfaces have transparency maps. */
@@ -133,33 +286,40 @@ int CollideSprite( const glTexture* at, const int asx, const int asy, const vec2
    if ((bx2 < ax1) || (ax2 < bx1)) return 0;
    if ((by2 < ay1) || (ay2 < by1)) return 0;
 
-   /* define the remaining binding box */
-   inter_x0 = MAX( ax1, bx1 );
-   inter_x1 = MIN( ax2, bx2 );
-   inter_y0 = MAX( ay1, by1 );
-   inter_y1 = MIN( ay2, by2 );
+   /* Tight bounding boxes of the opaque pixels. */
+   abox = &at->mask_box[ 4*(asy*(int)at->sx + asx) ];
+   bbox = &bt->mask_box[ 4*(bsy*(int)bt->sx + bsx) ];
 
-   /* real vertical sprite value (flipped) */
-   rasy = at->sy - asy - 1;
-   rbsy = bt->sy - bsy - 1;
-
-   /* set up the base points */
-   abx =  asx*(int)(at->sw) - ax1;
-   aby = rasy*(int)(at->sh) - ay1;
-   bbx =  bsx*(int)(bt->sw) - bx1;
-   bby = rbsy*(int)(bt->sh) - by1;
-
-   for (y=inter_y0; y<=inter_y1; y++)
-      for (x=inter_x0; x<=inter_x1; x++)
-         /* compute offsets for surface before pass to TransparentPixel test */
-         if ((!gl_isTrans(at, abx + x, aby + y)) &&
-               (!gl_isTrans(bt, bbx + x, bby + y))) {
+   /* define the remaining binding box */
+   inter_x0 = MAX( ax1+abox[0], bx1+bbox[0] );
+   inter_x1 = MIN( ax1+abox[2], bx1+bbox[2] );
+   inter_y0 = MAX( ay1+abox[1], by1+bbox[1] );
+   inter_y1 = MIN( ay1+abox[3], by1+bbox[3] );
+   if ((inter_x0 > inter_x1) || (inter_y0 > inter_y1))
+      return 0;
 
-            /* Set the crash position. */
-            crash->x = x;
-            crash->y = y;
-            return 1;
+   /* Test 64 pixels at a time. */
+   for (int y=inter_y0; y<=inter_y1; y++) {
+      const uint64_t *arow = CollideMaskRow( at, asx, asy, y-ay1 );
+      const uint64_t *brow = CollideMaskRow( bt, bsx, bsy, y-by1 );
+      for (int x=inter_x0; x<=inter_x1; x+=64) {
+         uint64_t m = CollideMaskBits( arow, at->mask_words, x-ax1 ) &
+               CollideMaskBits( brow, bt->mask_words, x-bx1 );
+         if (inter_x1-x < 63)
+            m &= ((uint64_t)1 << (inter_x1-x+1)) - 1;
+         if (m == 0)
+            continue;
+
+         /* Set the crash position at the first overlapping pixel. */
+         crash->x = x;
+         while (!(m & 1)) {
+            m >>= 1;
+            crash->x++;
          }
+         crash->y = y;
+         return 1;
+      }
+   }
 
    return 0;
 }
@@ -211,6 +371,11 @@ int CollideSpritePolygon( const CollPoly* at, const vec2* ap,
    if ((bx2 < ax1) || (ax2 < bx1)) return 0;
    if ((by2 < ay1) || (ay2 < by1)) return 0;
 
+   /* Bounding circle of the polygon against the sprite box. */
+   if (pow2( VX(*ap) - CLAMP( bx1, bx2+1, VX(*ap) ) ) +
+         pow2( VY(*ap) - CLAMP( by1, by2+1, VY(*ap) ) ) > pow2(at->rad))
+      return 0;
+
    /* define the remaining binding box */
    inter_x0 = MAX( ax1, bx1 );
    inter_x1 = MIN( ax2, bx2 );
@@ -275,6 +440,19 @@ int CollidePolygon( const CollPoly* at, const vec2* ap,
    if ((bx2 < ax1) || (ax2 < bx1)) return 0;
    if ((by2 < ay1) || (ay2 < by1)) return 0;
 
+   /* check if bounding circles intersect */
+   if (vec2_dist2( ap, bp ) > pow2(at->rad + bt->rad))
+      return 0;
+
+   /* Convex polygons can be separated exactly with the separating axis test. */
+   if (at->convex && bt->convex) {
+      float dx = VX(*bp) - VX(*ap);
+      float dy = VY(*bp) - VY(*ap);
+      if (PolygonSeparatedAxes( at, bt, dx, dy ) ||
+            PolygonSeparatedAxes( bt, at, -dx, -dy ))
+         return 0;
+   }
+
    /* define the remaining binding box */
    inter_x0 = MAX( ax1, bx1 );
    inter_x1 = MIN( ax2, bx2 );
@@ -329,6 +507,10 @@ void RotatePolygon( CollPoly* rpolygon, CollPoly* ipolygon, float theta )
    rpolygon->npt = ipolygon->npt;
    rpolygon->x = malloc( ipolygon->npt*sizeof(float) );
    rpolygon->y = malloc( ipolygon->npt*sizeof(float) );
+   rpolygon->nx = malloc( ipolygon->npt*sizeof(float) );
+   rpolygon->ny = malloc( ipolygon->npt*sizeof(float) );
+   rpolygon->rad = ipolygon->rad;
+   rpolygon->convex = ipolygon->convex;
    rpolygon->xmin = 0;
    rpolygon->xmax = 0;
    rpolygon->ymin = 0;
@@ -347,6 +529,10 @@ void RotatePolygon( CollPoly* rpolygon, CollPoly* ipolygon, float theta )
       rpolygon->y[i] = d;
       rpolygon->ymin = MIN( rpolygon->ymin, d );
       rpolygon->ymax = MAX( rpolygon->ymax, d );
+
+      /* Rotation keeps the normals outwards. */
+      rpolygon->nx[i] = ipolygon->nx[i] * ct - ipolygon->ny[i] * st;
+      rpolygon->ny[i] = ipolygon->nx[i] * st + ipolygon->ny[i] * ct;
    }
 }
 
@@ -364,6 +550,21 @@ int pointInPolygon( const CollPoly* at, const vec2* ap,
 {
    float vprod, sprod, angle;
    float dxi, dxip, dyi, dyip;
+   float px, py;
+
+   /* Outside of the bounding circle. */
+   px = x - VX(*ap);
+   py = y - VY(*ap);
+   if (pow2(px) + pow2(py) > pow2(at->rad))
+      return 0;
+
+   /* Convex polygons only need to be behind all the edges. */
+   if (at->convex) {
+      for (int i=0; i<at->npt; i++)
+         if ((px-at->x[i])*at->nx[i] + (py-at->y[i])*at->ny[i] > 0.)
+            return 0;
+      return 1;
+   }
 
    /* See if the pixel is inside the polygon:
       We increment the angle when doing a loop along all the points
@@ -502,10 +703,11 @@ int CollideLineSprite( const vec2* ap, double ad, double al,
       const glTexture* bt, const int bsx, const int bsy, const vec2* bp,
       vec2 crash[2] )
 {
-   int x,y, rbsy, bbx,bby;
-   double ep[2], bl[2], tr[2], v[2], mod;
+   double x,y;
+   double ep[2], bl[2], tr[2], sp[2], v[2], mod;
    int hits, real_hits;
    vec2 tmp_crash, border[2];
+   const int *box;
 
    /* Make sure texture has transparency map. */
    if (bt->trans == NULL) {
@@ -513,16 +715,24 @@ int CollideLineSprite( const vec2* ap, double ad, double al,
       return 0;
    }
 
+   /* Tight bounding box of the opaque pixels, empty sprites can't be hit. */
+   box = &bt->mask_box[ 4*(bsy*(int)bt->sx + bsx) ];
+   if (box[2] < 0)
+      return 0;
+
    /* Set up end point of line. */
    ep[0] = ap->x + al*cos(ad);
    ep[1] = ap->y + al*sin(ad);
 
+   /* Bottom left corner of the sprite, pixel coordinates are relative to it. */
+   sp[0] = bp->x - bt->sw/2.;
+   sp[1] = bp->y - bt->sh/2.;
    /* Set up top right corner of the rectangle. */
-   tr[0] = bp->x + bt->sw/2.;
-   tr[1] = bp->y + bt->sh/2.;
+   tr[0] = sp[0] + box[2] + 1.;
+   tr[1] = sp[1] + box[3] + 1.;
    /* Set up bottom left corner of the rectangle. */
-   bl[0] = bp->x - bt->sw/2.;
-   bl[1] = bp->y - bt->sh/2.;
+   bl[0] = sp[0] + box[0];
+   bl[1] = sp[1] + box[1];
 
    /*
     * Start check for rectangular collisions.
@@ -580,20 +790,14 @@ int CollideLineSprite( const vec2* ap, double ad, double al,
    v[0] /= mod;
    v[1] /= mod;
 
-   /* real vertical sprite value (flipped) */
-   rbsy = bt->sy - bsy - 1;
-   /* set up the base points */
-   bbx =  bsx*(int)(bt->sw);
-   bby = rbsy*(int)(bt->sh);
-
    /* We start checking first border until we find collision. */
-   x = border[0].x - bl[0] + v[0];
-   y = border[0].y - bl[1] + v[1];
-   while ((x > 0.) && (x < bt->sw) && (y > 0.) && (y < bt->sh)) {
+   x = border[0].x - sp[0] + v[0];
+   y = border[0].y - sp[1] + v[1];
+   while ((x >= box[0]) && (x < box[2]+1) && (y >= box[1]) && (y < box[3]+1)) {
       /* Is non-transparent. */
-      if (!gl_isTrans(bt, bbx+(int)x, bby+(int)y)) {
-         crash[real_hits].x = x + bl[0];
-         crash[real_hits].y = y + bl[1];
+      if (CollideMaskTest( bt, bsx, bsy, (int)x, (int)y )) {
+         crash[real_hits].x = x + sp[0];
+         crash[real_hits].y = y + sp[1];
          real_hits++;
          break;
       }
@@ -602,13 +806,13 @@ int CollideLineSprite( const vec2* ap, double ad, double al,
    }
 
    /* Now we check the second border. */
-   x = border[1].x - bl[0] - v[0];
-   y = border[1].y - bl[1] - v[1];
-   while ((x > 0.) && (x < bt->sw) && (y > 0.) && (y < bt->sh)) {
+   x = border[1].x - sp[0] - v[0];
+   y = border[1].y - sp[1] - v[1];
+   while ((x >= box[0]) && (x < box[2]+1) && (y >= box[1]) && (y < box[3]+1)) {
       /* Is non-transparent. */
-      if (!gl_isTrans(bt, bbx+(int)x, bby+(int)y)) {
-         crash[real_hits].x = x + bl[0];
-         crash[real_hits].y = y + bl[1];
+      if (CollideMaskTest( bt, bsx, bsy, (int)x, (int)y )) {
+         crash[real_hits].x = x + sp[0];
+         crash[real_hits].y = y + sp[1];
          real_hits++;
          break;
       }
@@ -652,6 +856,7 @@ int CollideLinePolygon( const vec2* ap, double ad, double al,
 {
    double ep[2], bl[2], tr[2];
    double xi, yi, xip, yip;
+   double dx, dy, t;
    int hits, real_hits;
    vec2 tmp_crash;
 
@@ -659,6 +864,15 @@ int CollideLinePolygon( const vec2* ap, double ad, double al,
    ep[0] = ap->x + al*cos(ad);
    ep[1] = ap->y + al*sin(ad);
 
+   /* Reject if the closest point of the line is outside the bounding circle. */
+   dx = ep[0] - ap->x;
+   dy = ep[1] - ap->y;
+   t  = pow2(dx) + pow2(dy);
+   if (t > 0.)
+      t = CLAMP( 0., 1., ((bp->x-ap->x)*dx + (bp->y-ap->y)*dy) / t );
+   if (pow2(ap->x + t*dx - bp->x) + pow2(ap->y + t*dy - bp->y) > pow2(bt->rad))
+      return 0;
+
    real_hits = 0;
    vectnull( &tmp_crash );
 
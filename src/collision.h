@@ -18,10 +18,15 @@ typedef struct CollPoly_ {
    float ymin; /**< Min of y. */
    float ymax; /**< Max of y. */
    int npt; /**< Nb of points in the polygon. */
+   float* nx; /**< X component of the outward normal of each edge (not normalized). */
+   float* ny; /**< Y component of the outward normal of each edge (not normalized). */
+   float rad; /**< Radius of the bounding circle around the origin. */
+   int convex; /**< Whether or not the polygon is convex. */
 } CollPoly;
 
 /* Loads a polygon data from xml. */
 void LoadPolygon( CollPoly* polygon, xmlNodePtr node );
+void FreePolygon( CollPoly* polygon );
 
 /* Rotates a polygon. */
 void RotatePolygon( CollPoly* rpolygon, CollPoly* ipolygon, float theta );
@@ -25,6 +25,7 @@
 #include "economy.h"
 #include "gatherable.h"
 #include "hook.h"
+#include "intern.h"
 #include "log.h"
 #include "ndata.h"
 #include "nstring.h"
@@ -42,6 +43,7 @@
 /* commodity stack */
 Commodity* commodity_stack = NULL; /**< Contains all the commodities. */
 static Commodity** commodity_temp = NULL; /**< Contains all the temporary commodities. */
+static int *commodity_idmap = NULL; /**< Array (array.h): Maps interned commodity names to commodity_stack indices. */
 
 /* @TODO remove externs. */
 extern int *econ_comm;
@@ -145,9 +147,9 @@ Commodity* commodity_get( const char* name )
  */
 Commodity* commodity_getW( const char* name )
 {
-   for (int i=0; i<array_size(commodity_stack); i++)
-      if (strcmp(commodity_stack[i].name, name) == 0)
-         return &commodity_stack[i];
+   int id = intern_mapGet( commodity_idmap, name );
+   if (id >= 0)
+      return &commodity_stack[id];
    for (int i=0; i<array_size(commodity_temp); i++)
       if (strcmp(commodity_temp[i]->name, name) == 0)
          return commodity_temp[i];
@@ -481,6 +483,7 @@ int commodity_load (void)
       int ret = commodity_parse( &c, commodities[i] );
       if (ret == 0) {
          array_push_back( &commodity_stack, c );
+         intern_mapSet( &commodity_idmap, c.name, array_size(commodity_stack)-1 );
 
          /* See if should get added to commodity list. */
          if (c.price > 0.) {
@@ -514,6 +517,8 @@ void commodity_free (void)
       commodity_freeOne( &commodity_stack[i] );
    array_free( commodity_stack );
    commodity_stack = NULL;
+   array_free( commodity_idmap );
+   commodity_idmap = NULL;
 
    for (int i=0; i<array_size(commodity_temp); i++) {
       commodity_freeOne( commodity_temp[i] );
@@ -103,6 +103,8 @@ static void print_usage( void )
    LOG(_("   -s f, --svol f        sets the sound volume to f"));
    LOG(_("   -d, --datapath        adds a new datapath to be mounted (i.e., appends it to the search path for game assets)"));
    LOG(_("   -X, --scale           defines the scale factor"));
+   LOG(_("   -R s, --record s      records the next loaded game as replay s"));
+   LOG(_("   -P s, --replay s      plays back replay s"));
 #ifdef DEBUGGING
    LOG(_("   --devmode             enables dev mode perks like the editors"));
 #endif /* DEBUGGING */
@@ -184,6 +186,7 @@ void conf_setGameplayDefaults (void)
    conf.compression_velocity  = TIME_COMPRESSION_DEFAULT_MAX;
    conf.compression_mult      = TIME_COMPRESSION_DEFAULT_MULT;
    conf.save_compress         = SAVE_COMPRESSION_DEFAULT;
+   conf.save_xml              = SAVE_XML_DEFAULT;
    conf.mouse_thrust          = MOUSE_THRUST_DEFAULT;
    conf.mouse_doubleclick     = MOUSE_DOUBLECLICK_TIME;
    conf.mouse_fly             = MOUSE_FLY_DEFAULT;
@@ -405,6 +408,7 @@ int conf_loadConfig ( const char* file )
       conf_loadFloat( lEnv, "compression_mult", conf.compression_mult );
       conf_loadBool( lEnv, "redirect_file", conf.redirect_file );
       conf_loadBool( lEnv, "save_compress", conf.save_compress );
+      conf_loadBool( lEnv, "save_xml", conf.save_xml );
       conf_loadInt( lEnv, "doubletap_sensitivity", conf.doubletap_sens );
       conf_loadBool( lEnv, "mouse_fly", conf.mouse_fly );
       conf_loadInt( lEnv, "mouse_thrust", conf.mouse_thrust );
@@ -563,6 +567,8 @@ void conf_parseCLI( int argc, char** argv )
       { "mvol", required_argument, 0, 'm' },
       { "svol", required_argument, 0, 's' },
       { "scale", required_argument, 0, 'X' },
+      { "record", required_argument, 0, 'R' },
+      { "replay", required_argument, 0, 'P' },
 #ifdef DEBUGGING
       { "devmode", no_argument, 0, 'D' },
 #endif /* DEBUGGING */
@@ -578,7 +584,7 @@ void conf_parseCLI( int argc, char** argv )
     */
    optind = 0;
    while ((c = getopt_long(argc, argv,
-         "fF:Vd:j:J:W:H:MSm:s:X:Nhv",
+         "fF:Vd:j:J:W:H:MSm:s:X:R:P:Nhv",
          long_options, &option_index)) != -1) {
       switch (c) {
          case 'd':
@@ -626,6 +632,14 @@ void conf_parseCLI( int argc, char** argv )
          case 'X':
             conf.scalefactor = atof(optarg);
             break;
+         case 'R':
+            free(conf.replay_record);
+            conf.replay_record = strdup(optarg);
+            break;
+         case 'P':
+            free(conf.replay_play);
+            conf.replay_play = strdup(optarg);
+            break;
 #ifdef DEBUGGING
          case 'D':
             conf.devmode = 1;
@@ -1028,6 +1042,10 @@ int conf_saveConfig ( const char* file )
    conf_saveBool("save_compress",conf.save_compress);
    conf_saveEmptyLine();
 
+   conf_saveComment(_("Writes saved games as XML, useful to export or edit them. Both kinds can be loaded"));
+   conf_saveBool("save_xml",conf.save_xml);
+   conf_saveEmptyLine();
+
    conf_saveComment(_("Doubletap sensitivity (used for double tap accel for afterburner or double tap reverse for cooldown)"));
    conf_saveInt("doubletap_sensitivity",conf.doubletap_sens);
    conf_saveEmptyLine();
@@ -1190,6 +1208,8 @@ void conf_copy( PlayerConf_t *dest, const PlayerConf_t *src )
    STRDUP(dev_save_sys);
    STRDUP(dev_save_map);
    STRDUP(dev_save_spob);
+   STRDUP(replay_record);
+   STRDUP(replay_play);
    if (src->difficulty != NULL)
       STRDUP(difficulty);
 #undef STRDUP
@@ -1208,6 +1228,8 @@ void conf_free( PlayerConf_t *config )
    free(config->dev_save_sys);
    free(config->dev_save_map);
    free(config->dev_save_spob);
+   free(config->replay_record);
+   free(config->replay_play);
    free(config->difficulty);
 
    /* Clear memory. */
@@ -14,6 +14,7 @@
 #define TIME_COMPRESSION_DEFAULT_MULT  200   /**< Default level of time compression multiplier. */
 #define REDIRECT_FILE_DEFAULT          1     /**< Whether output should be redirected to a file. */
 #define SAVE_COMPRESSION_DEFAULT       1     /**< Whether or not saved games should be compressed. */
+#define SAVE_XML_DEFAULT               0     /**< Whether or not saved games should be written as XML. */
 #define MOUSE_FLY_DEFAULT              1     /**< Whether or not middle clicking enables mouse flying. */
 #define MOUSE_THRUST_DEFAULT           1     /**< Whether or not to use mouse thrust controls. */
 #define MOUSE_DOUBLECLICK_TIME         0.5   /**< How long to consider double-clicks for. */
@@ -148,6 +149,7 @@ typedef struct PlayerConf_s {
    double compression_mult; /**< Maximum time multiplier. */
    int redirect_file; /**< Redirect output to files. */
    int save_compress; /**< Compress saved game. */
+   int save_xml; /**< Write saved games as XML instead of the chunked format. */
    unsigned int doubletap_sens; /**< Double tap key sensibility (used for afterburn and cooldown). */
    int mouse_fly; /**< Whether middle clicking enables mouse flying or not. */
    int mouse_thrust; /**< Whether mouse flying controls thrust. */
@@ -165,6 +167,8 @@ typedef struct PlayerConf_s {
 
    /* Debugging. */
    int fpu_except; /**< Enable FPU exceptions? */
+   char *replay_record; /**< Name of the replay to record, if any. */
+   char *replay_play; /**< Name of the replay to play back, if any. */
 
    /* Editor. */
    char *dev_save_sys; /**< Path to save systems to. */
@@ -97,6 +97,7 @@ static double uniedit_rotate  = 0.; /**< Rotated angle (in radians). */
 static double uniedit_rotate_cx = 0.; /**< Center position of rotation. */
 static double uniedit_rotate_cy = 0.; /**< Center position of rotation. */
 static StarSystem **uniedit_sys = NULL; /**< Selected systems. */
+static int *uniedit_selIds    = NULL; /**< Array (array.h): Buffer for systems inside the selection box. */
 static StarSystem *uniedit_tsys = NULL; /**< Temporarily clicked system. */
 static int uniedit_tadd       = 0;  /**< Temporarily clicked system should be added. */
 static double uniedit_mx      = 0.; /**< X mouse position. */
@@ -334,6 +335,8 @@ static void uniedit_close( unsigned int wid, const char *wgt )
 {
    /* Frees some memory. */
    uniedit_deselect();
+   array_free( uniedit_selIds );
+   uniedit_selIds = NULL;
 
    /* Reconstruct jumps. */
    systems_reconstructJumps();
@@ -856,7 +859,7 @@ static int getPresenceVal( int f, SpobPresence *ap, double *base, double *bonus
  */
 static void uniedit_renderOverlay( double bx, double by, double bw, double bh, void* data )
 {
-   double x,y, mx,my, sx,sy;
+   double x,y, mx,my;
    double value, base, bonus;
    char buf[STRMAX] = {'\0'};
    StarSystem *sys, *cur, *mousesys;
@@ -908,21 +911,10 @@ static void uniedit_renderOverlay( double bx, double by, double bw, double bh, v
       return;
 
    /* Find mouse over system. */
-   mousesys = NULL;
-   for (int i=0; i<array_size(systems_stack); i++) {
-      sys = system_getIndex(i);
-      sx = sys->pos.x;
-      sy = sys->pos.y;
-      if ((pow2(sx-mx)+pow2(sy-my)) > pow2(UNIEDIT_CLICK_THRESHOLD))
-         continue;
-      mousesys = sys;
-      break;
-   }
+   mousesys = space_sysClosest( mx, my, UNIEDIT_CLICK_THRESHOLD, NULL );
    if (mousesys == NULL)
       return;
    sys   = mousesys;
-   sx    = sys->pos.x;
-   sy    = sys->pos.y;
 
    /* Handle virtual spob viewer. */
    if (uniedit_viewmode == UNIEDIT_VIEW_VIRTUALSPOBS) {
@@ -1165,14 +1157,7 @@ static int uniedit_mouse( unsigned int wid, SDL_Event* event, double mx, double
          }
 
          /* Find clicked system. */
-         clickedsys = NULL;
-         for (int i=0; i<array_size(systems_stack); i++) {
-            StarSystem *sys = system_getIndex(i);
-            if ((pow2(mx-sys->pos.x)+pow2(my-sys->pos.y)) > pow2(UNIEDIT_CLICK_THRESHOLD))
-               continue;
-            clickedsys = sys;
-            break;
-         }
+         clickedsys = space_sysClosest( mx, my, UNIEDIT_CLICK_THRESHOLD, NULL );
 
          /* Set jump if applicable. */
          if (clickedsys!=NULL && uniedit_mode==UNIEDIT_JUMP) {
@@ -1284,13 +1269,9 @@ static int uniedit_mouse( unsigned int wid, SDL_Event* event, double mx, double
             b = MIN( uniedit_dragSelY, my );
             t = MAX( uniedit_dragSelY, my );
 
-            for (int i=0; i<array_size(systems_stack); i++) {
-               StarSystem *sys = &systems_stack[i];
-               double x = sys->pos.x;
-               double y = sys->pos.y;
-               if ((x >= l) && (x <= r) && (y >= b) && (y <= t))
-                  uniedit_selectAdd( sys );
-            }
+            uniedit_selIds = space_sysInRect( uniedit_selIds, l, b, r, t );
+            for (int i=0; i<array_size(uniedit_selIds); i++)
+               uniedit_selectAdd( system_getIndex( uniedit_selIds[i] ) );
 
             uniedit_dragSel = 0;
          }
@@ -1325,6 +1306,7 @@ static int uniedit_mouse( unsigned int wid, SDL_Event* event, double mx, double
                s->pos.x = uniedit_rotate_cx + m*cos(a+amod);
                s->pos.y = uniedit_rotate_cy + m*sin(a+amod);
             }
+            space_sysGridDirty();
          }
 
          /* Handle dragging. */
@@ -1342,6 +1324,7 @@ static int uniedit_mouse( unsigned int wid, SDL_Event* event, double mx, double
                   uniedit_sys[i]->pos.x += rx / uniedit_zoom;
                   uniedit_sys[i]->pos.y -= ry / uniedit_zoom;
                }
+               space_sysGridDirty();
             }
 
             /* Update mouse movement. */
@@ -911,6 +911,110 @@ void economy_initialiseCommodityPrices(void)
    }
 }
 
+/**
+ * @brief Initialises commodity prices only for the systems affected by changes in some systems.
+ *
+ * The final prices of a system depend on its own spobs and the average prices
+ * of its neighbours, so the changed systems and their neighbours are
+ * recomputed. The neighbours of those are only needed for their averages,
+ * and get their spob prices restored afterwards.
+ *
+ *    @param sysids IDs of the systems that changed.
+ *    @param nsys Number of systems in sysids.
+ */
+void economy_initialiseCommodityPricesAround( const int *sysids, int nsys )
+{
+   int n = array_size(systems_stack);
+   uint8_t *mark;
+   CommodityPrice **saved;
+   const uint8_t CHANGED = 1, RECOMPUTE = 2, AVERAGE = 4;
+
+   if (nsys <= 0)
+      return;
+
+   mark = calloc( n, sizeof(uint8_t) );
+   for (int i=0; i<nsys; i++)
+      mark[ sysids[i] ] = CHANGED | RECOMPUTE;
+
+   /* Systems smoothed with a changed system, in either direction. */
+   for (int i=0; i<n; i++) {
+      const StarSystem *sys = &systems_stack[i];
+      for (int j=0; j<array_size(sys->jumps); j++) {
+         int t = sys->jumps[j].targetid;
+         if (mark[t] & CHANGED)
+            mark[i] |= RECOMPUTE;
+         if (mark[i] & CHANGED)
+            mark[t] |= RECOMPUTE;
+      }
+   }
+   /* Their neighbours are needed for the averages. */
+   for (int i=0; i<n; i++) {
+      const StarSystem *sys = &systems_stack[i];
+      if (!(mark[i] & RECOMPUTE))
+         continue;
+      mark[i] |= AVERAGE;
+      for (int j=0; j<array_size(sys->jumps); j++)
+         mark[ sys->jumps[j].targetid ] |= AVERAGE;
+   }
+
+   /* Save the prices of spobs that are only used for averages. */
+   saved = calloc( n, sizeof(CommodityPrice*) );
+   for (int i=0; i<n; i++) {
+      StarSystem *sys = &systems_stack[i];
+      int nprices = 0;
+      if (!(mark[i] & AVERAGE) || (mark[i] & RECOMPUTE))
+         continue;
+      for (int j=0; j<array_size(sys->spobs); j++)
+         nprices += array_size(sys->spobs[j]->commodities);
+      saved[i] = malloc( MAX(1,nprices) * sizeof(CommodityPrice) );
+      nprices = 0;
+      for (int j=0; j<array_size(sys->spobs); j++) {
+         Spob *spob = sys->spobs[j];
+         memcpy( &saved[i][nprices], spob->commodityPrice, array_size(spob->commodities) * sizeof(CommodityPrice) );
+         nprices += array_size(spob->commodities);
+      }
+   }
+
+   /* Same as economy_initialiseCommodityPrices() but only where needed. */
+   for (int k=0; k<n; k++) {
+      StarSystem *sys = &systems_stack[k];
+      if (!(mark[k] & AVERAGE))
+         continue;
+      for (int j=0; j<array_size(sys->spobs); j++) {
+         Spob *spob = sys->spobs[j];
+         for (int i=0; i<array_size(spob->commodities); i++)
+            economy_calcPrice(spob, spob->commodities[i], &spob->commodityPrice[i]);
+      }
+   }
+   for (int i=0; i<n; i++)
+      if (mark[i] & AVERAGE)
+         economy_modifySystemCommodityPrice( &systems_stack[i] );
+   for (int i=0; i<n; i++)
+      if (mark[i] & RECOMPUTE)
+         economy_smoothCommodityPrice( &systems_stack[i] );
+   for (int i=0; i<n; i++)
+      if (mark[i] & RECOMPUTE)
+         economy_calcUpdatedCommodityPrice( &systems_stack[i] );
+
+   /* Restore the systems only used for averages. */
+   for (int i=0; i<n; i++) {
+      StarSystem *sys = &systems_stack[i];
+      int nprices = 0;
+      if (saved[i] == NULL)
+         continue;
+      for (int j=0; j<array_size(sys->spobs); j++) {
+         Spob *spob = sys->spobs[j];
+         memcpy( spob->commodityPrice, &saved[i][nprices], array_size(spob->commodities) * sizeof(CommodityPrice) );
+         nprices += array_size(spob->commodities);
+      }
+      array_free( sys->averagePrice );
+      sys->averagePrice = NULL;
+      free( saved[i] );
+   }
+   free( saved );
+   free( mark );
+}
+
 /*
  * Calculates commodity prices for a single spob (e.g. as added by the unidiff), and does some smoothing over the system, but not neighbours.
  */
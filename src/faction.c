@@ -19,6 +19,7 @@
 #include "array.h"
 #include "colour.h"
 #include "hook.h"
+#include "intern.h"
 #include "log.h"
 #include "ndata.h"
 #include "nlua.h"
@@ -104,6 +105,7 @@ typedef struct Faction_ {
 } Faction;
 
 static Faction* faction_stack = NULL; /**< Faction stack. */
+static int *faction_idmap = NULL; /**< Array (array.h): Maps interned faction names to faction_stack indices. */
 static int* faction_grid = NULL; /**< Grid of faction status. */
 static size_t faction_mgrid = 0; /**< Allocated memory. */
 
@@ -119,6 +121,7 @@ static int faction_parse( Faction* temp, const char *file );
 static int faction_parseSocial( const char *file );
 static void faction_addStandingScript( Faction* temp, const char* scriptname );
 static void faction_computeGrid (void);
+static void faction_computeIdMap (void);
 /* externed */
 int pfaction_save( xmlTextWriterPtr writer );
 int pfaction_load( xmlNodePtr parent );
@@ -143,25 +146,27 @@ static int faction_getRaw( const char* name )
    if (strcmp(name, "Escort") == 0)
       return FACTION_PLAYER;
 
-   if (name != NULL) {
-      int i;
-      for (i=0; i<array_size(faction_stack); i++)
-         if (strcmp(faction_stack[i].name, name)==0)
-            break;
-
-      if (i != array_size(faction_stack))
-         return i;
-
-      /* Dynamic factions are why we can't have nice things.
-      const Faction f = { .name = (char*)name };
-      Faction *found = bsearch( &f, faction_stack, array_size(faction_stack), sizeof(Faction), faction_cmp );
-      if (found != NULL)
-         return found - faction_stack;
-      */
-   }
+   /* Dynamic factions are appended unsorted, so no bsearch, but they are in
+    * the map. */
+   if (name != NULL)
+      return intern_mapGet( faction_idmap, name );
    return -1;
 }
 
+/**
+ * @brief Rebuilds the map from faction names to indices.
+ *
+ * The first faction with a name wins, same as a linear search would.
+ */
+static void faction_computeIdMap (void)
+{
+   for (int i=0; i<array_size(faction_idmap); i++)
+      faction_idmap[i] = -1;
+   for (int i=0; i<array_size(faction_stack); i++)
+      if (intern_mapGet( faction_idmap, faction_stack[i].name ) < 0)
+         intern_mapSet( &faction_idmap, faction_stack[i].name, i );
+}
+
 /**
  * @brief Checks to see if a faction exists by name.
  *
@@ -1615,6 +1620,7 @@ int factions_load (void)
 
    /* Sort by name. */
    qsort( faction_stack, array_size(faction_stack), sizeof(Faction), faction_cmp );
+   faction_computeIdMap();
    faction_player = faction_get("Player");
 
    /* Second pass - sets allies and enemies */
@@ -1709,6 +1715,8 @@ void factions_free (void)
       faction_freeOne( &faction_stack[i] );
    array_free(faction_stack);
    faction_stack = NULL;
+   array_free(faction_idmap);
+   faction_idmap = NULL;
 
    /* Clean up faction grid. */
    free( faction_grid );
@@ -1865,6 +1873,7 @@ void factions_clearDynamic (void)
          i--;
       }
    }
+   faction_computeIdMap();
    faction_computeGrid();
 }
 
@@ -1920,6 +1929,9 @@ int faction_dynAdd( int base, const char* name, const char* display, const char*
    if (colour != NULL)
       f->colour = *colour;
 
+   if (intern_mapGet( faction_idmap, f->name ) < 0)
+      intern_mapSet( &faction_idmap, f->name, f-faction_stack );
+
    /* TODO make this incremental. */
    faction_computeGrid();
 
@@ -38,12 +38,19 @@
 #define HASH_LUT_SIZE 512 /**< Size of glyph look up table. */
 #define DEFAULT_TEXTURE_SIZE 1024 /**< Default size of texture caches for glyphs. */
 #define MAX_ROWS 64 /**< Max number of rows per texture cache. */
+#define FONT_LAYOUT_CACHE_SIZE 512 /**< Maximum number of cached text layouts. */
+#define FONT_LAYOUT_LUT_SIZE 1024 /**< Size of text layout look up table (power of 2). */
+#define FONT_LAYOUT_VERTEX_SIZE 9 /**< Floats per layout vertex: x, y, s, t, m, r, g, b, colour source. */
+
+/* Where the colour of a layout vertex comes from, resolved when drawing. */
+#define FONT_LAYOUT_COL_START 0. /**< Starting colour of the text. */
+#define FONT_LAYOUT_COL_BASE  1. /**< Base colour, restored by "#0". */
+#define FONT_LAYOUT_COL_CODE  2. /**< Colour of a colour code, stored in the vertex. */
 
 /**
  * OpenGL rendering stuff. Since we can't actually render with multiple threads
  * we can be lazy and use global variables.
  */
-static mat4 font_projection_mat; /**< Projection matrix. */
 static FT_Library font_library = NULL; /**< Global FreeType library. */
 static FT_UInt    prev_glyph_index; /**< Index of last character drawn (for kerning). */
 static int        prev_glyph_ft_index; /**< HACK: Index into which stsh->ft[_].face? */
@@ -158,6 +165,46 @@ glFont gl_defFontMono; /**< Default mono font. */
 static const glColour *font_lastCol    = NULL; /**< Stores last colour used (activated by FONT_COLOUR_CODE). */
 static int font_restoreLast      = 0; /**< Restore last colour. */
 
+/**
+ * @brief Range of a cached layout that uses the same glyph texture.
+ */
+typedef struct glFontLayoutRun_s {
+   int tex_index; /**< Texture to use. */
+   int start; /**< First vertex. */
+   int n; /**< Number of vertices. */
+} glFontLayoutRun;
+
+/**
+ * @brief Cached layout of a piece of text, so it can be drawn without redoing the glyph work.
+ */
+typedef struct glFontLayout_s {
+   /* Key. */
+   char *text; /**< Copy of the text (NULL if the slot is free). */
+   size_t len; /**< Length of the text. */
+   uint32_t hash; /**< Hash of the key. */
+   int font_id; /**< Font stash the layout belongs to. */
+   int max; /**< Maximum width or -1 if not limited. */
+   int state; /**< Escape sequence state at the start. */
+
+   /* Generated values. */
+   size_t ret; /**< Number of bytes that fit in max. */
+   int width; /**< Width of the text when limited by max. */
+   int state_end; /**< Escape sequence state at the end. */
+   const glColour *lastcol; /**< Last colour set by an escape. */
+   int lastcol_set; /**< Whether or not an escape set lastcol. */
+   gl_vbo *vbo; /**< Vertex data. */
+   int nvert; /**< Number of vertices. */
+   glFontLayoutRun *runs; /**< Draws to do (array.h). */
+
+   /* Cache management. */
+   unsigned int lastuse; /**< Last time it was used for LRU eviction. */
+   int next; /**< Next layout in the hash chain. */
+} glFontLayout;
+
+static glFontLayout *font_layouts = NULL; /**< Text layout cache (array.h). */
+static int font_layoutLUT[ FONT_LAYOUT_LUT_SIZE ]; /**< Look up table for font_layouts. */
+static unsigned int font_layoutTick = 0; /**< Counter used for LRU eviction. */
+
 /*
  * prototypes
  */
@@ -168,14 +215,14 @@ static uint32_t font_nextChar( const char *s, size_t *i );
 /* Get unicode glyphs from cache. */
 static glFontGlyph* gl_fontGetGlyph( glFontStash *stsh, uint32_t ch );
 /* Render.
- * TODO this should be changed to be more like font-stash (https://github.com/akrinke/Font-Stash)
- * In particular, instead of writing char by char, they should be batched up by textures and rendered
- * when gl_fontRenderEnd() is called, saving lots of opengl calls.
- */
-static void gl_fontRenderStart( const glFontStash *stsh, double x, double y, const glColour *c, double outlineR );
-static void gl_fontRenderStartH( const glFontStash* stsh, const mat4 *H, const glColour *c, double outlineR );
-static int gl_fontRenderGlyph( glFontStash *stsh, uint32_t ch, const glColour *c, int state );
-static void gl_fontRenderEnd (void);
+ * Text is laid out once into a vertex buffer batched by glyph texture and cached,
+ * so that redrawing the same text is one draw call per texture.
+ */
+static glFontLayout* gl_fontLayoutGet( int font_id, const char *text, size_t len, int max, int state );
+static void gl_fontRenderLayout( const glFontLayout *l, const mat4 *H, double outlineR, const glColour *c );
+static mat4 gl_fontPositionMatrix( double x, double y );
+static void gl_fontLayoutInvalidate( int font_id );
+static void gl_fontLayoutExit (void);
 /* Fussy layout concerns. */
 static void gl_fontKernStart (void);
 static int gl_fontKernGlyph( glFontStash* stsh, uint32_t ch, glFontGlyph* glyph );
@@ -616,21 +663,16 @@ static uint32_t font_nextChar( const char *s, size_t *i )
 void gl_printRaw( const glFont *ft_font, double x, double y, const glColour* c,
       double outlineR, const char *text )
 {
-   int s;
-   size_t i;
-   uint32_t ch;
+   const glFontLayout *l;
+   mat4 H;
 
    if (ft_font == NULL)
       ft_font = &gl_defFont;
-   glFontStash *stsh = gl_fontGetStash( ft_font );
 
    /* Render it. */
-   s = 0;
-   i = 0;
-   gl_fontRenderStart( stsh, x, y, c, outlineR );
-   while ((ch = u8_nextchar( text, &i )))
-      s = gl_fontRenderGlyph( stsh, ch, c, s );
-   gl_fontRenderEnd();
+   l = gl_fontLayoutGet( ft_font->id, text, strlen(text), -1, 0 );
+   H = gl_fontPositionMatrix( x, y );
+   gl_fontRenderLayout( l, &H, outlineR, c );
 }
 
 /**
@@ -647,21 +689,14 @@ void gl_printRaw( const glFont *ft_font, double x, double y, const glColour* c,
 void gl_printRawH( const glFont *ft_font, const mat4 *H,
       const glColour* c, const double outlineR , const char *text )
 {
-   int s;
-   size_t i;
-   uint32_t ch;
+   const glFontLayout *l;
 
    if (ft_font == NULL)
       ft_font = &gl_defFont;
-   glFontStash *stsh = gl_fontGetStash( ft_font );
 
    /* Render it. */
-   s = 0;
-   i = 0;
-   gl_fontRenderStartH( stsh, H, c, outlineR );
-   while ((ch = u8_nextchar( text, &i )))
-      s = gl_fontRenderGlyph( stsh, ch, c, s );
-   gl_fontRenderEnd();
+   l = gl_fontLayoutGet( ft_font->id, text, strlen(text), -1, 0 );
+   gl_fontRenderLayout( l, H, outlineR, c );
 }
 
 /**
@@ -720,26 +755,18 @@ void gl_print( const glFont *ft_font,
 int gl_printMaxRaw( const glFont *ft_font, const int max, double x, double y,
       const glColour* c, double outlineR, const char *text)
 {
-   int s;
-   size_t ret, i;
-   uint32_t ch;
+   const glFontLayout *l;
+   mat4 H;
 
    if (ft_font == NULL)
       ft_font = &gl_defFont;
-   glFontStash *stsh = gl_fontGetStash( ft_font );
 
-   /* Limit size. */
-   ret = font_limitSize( stsh, NULL, text, max );
+   /* Limit size and render it, the layout caches the limit too. */
+   l = gl_fontLayoutGet( ft_font->id, text, strlen(text), max, 0 );
+   H = gl_fontPositionMatrix( x, y );
+   gl_fontRenderLayout( l, &H, outlineR, c );
 
-   /* Render it. */
-   s = 0;
-   gl_fontRenderStart( stsh, x, y, c, outlineR );
-   i = 0;
-   while ((ch = u8_nextchar( text, &i )) && (i <= ret))
-      s = gl_fontRenderGlyph( stsh, ch, c, s );
-   gl_fontRenderEnd();
-
-   return ret;
+   return l->ret;
 }
 
 /**
@@ -794,28 +821,21 @@ int gl_printMidRaw(
       const char *text
       )
 {
-   int n, s;
-   size_t ret, i;
-   uint32_t ch;
+   const glFontLayout *l;
+   mat4 H;
 
    if (ft_font == NULL)
       ft_font = &gl_defFont;
-   glFontStash *stsh = gl_fontGetStash( ft_font );
 
    /* limit size */
-   n = 0;
-   ret = font_limitSize( stsh, &n, text, width );
-   x += (double)(width - n)/2.;
+   l = gl_fontLayoutGet( ft_font->id, text, strlen(text), width, 0 );
+   x += (double)(width - l->width)/2.;
 
    /* Render it. */
-   s = 0;
-   gl_fontRenderStart( stsh, x, y, c, outlineR );
-   i = 0;
-   while ((ch = u8_nextchar( text, &i )) && (i <= ret))
-      s = gl_fontRenderGlyph( stsh, ch, c, s );
-   gl_fontRenderEnd();
+   H = gl_fontPositionMatrix( x, y );
+   gl_fontRenderLayout( l, &H, outlineR, c );
 
-   return ret;
+   return l->ret;
 }
 
 /**
@@ -877,11 +897,9 @@ int gl_printTextRaw( const glFont *ft_font,
    glPrintLineIterator iter;
    int s;
    double x,y;
-   uint32_t ch;
 
    if (ft_font == NULL)
       ft_font = &gl_defFont;
-   glFontStash *stsh = gl_fontGetStash( ft_font );
 
    x = bx;
    y = by + height - (double)ft_font->h; /* y is top left corner */
@@ -900,12 +918,11 @@ int gl_printTextRaw( const glFont *ft_font,
       gl_printRestoreLast();
 
       /* Render it. */
-      gl_fontRenderStart( stsh, x, y, c, outlineR );
-      for (size_t i = iter.l_begin; i < iter.l_end; ) {
-         ch = u8_nextchar( text, &i );
-         s = gl_fontRenderGlyph( stsh, ch, c, s );
-      }
-      gl_fontRenderEnd();
+      const glFontLayout *l = gl_fontLayoutGet( ft_font->id, &text[iter.l_begin],
+            iter.l_end - iter.l_begin, -1, s );
+      mat4 H = gl_fontPositionMatrix( x, y );
+      gl_fontRenderLayout( l, &H, outlineR, c );
+      s = l->state_end;
 
       y -= line_height; /* move position down */
    }
@@ -1213,57 +1230,6 @@ static int font_makeChar( glFontStash *stsh, font_char_t *c, uint32_t ch )
    return -1;
 }
 
-/**
- * @brief Starts the rendering engine.
- */
-static void gl_fontRenderStart( const glFontStash* stsh, double x, double y, const glColour *c, double outlineR )
-{
-   /* OpenGL has pixel centers at 0.5 offset. */
-   mat4 H = gl_view_matrix;
-   mat4_translate( &H, x+0.5*gl_screen.wscale, y+0.5*gl_screen.hscale, 0 );
-   gl_fontRenderStartH( stsh, &H, c, outlineR );
-}
-static void gl_fontRenderStartH( const glFontStash* stsh, const mat4 *H, const glColour *c, double outlineR )
-{
-   double a, scale;
-   const glColour *col;
-
-   outlineR = (outlineR==-1) ? 1 : MAX( outlineR, 0 );
-
-   /* Handle colour. */
-   a = (c==NULL) ? 1. : c->a;
-   if (font_restoreLast)
-      col = font_lastCol;
-   else if (c==NULL)
-      col = &cWhite;
-   else
-      col = c;
-
-   glUseProgram(shaders.font.program);
-   gl_uniformAColor(shaders.font.color, col, a);
-   if (outlineR == 0.)
-      gl_uniformAColor(shaders.font.outline_color, col, 0.);
-   else
-      gl_uniformAColor(shaders.font.outline_color, &cGrey10, a);
-
-   scale = (double)stsh->h / FONT_DISTANCE_FIELD_SIZE;
-   font_projection_mat = *H;
-   mat4_scale( &font_projection_mat, scale, scale, 1 );
-
-   font_restoreLast = 0;
-   gl_fontKernStart();
-
-   /* Activate the appropriate VBOs. */
-   glEnableVertexAttribArray( shaders.font.vertex );
-   gl_vboActivateAttribOffset( stsh->vbo_vert, shaders.font.vertex, 0, 2, GL_SHORT, 0 );
-   glEnableVertexAttribArray( shaders.font.tex_coord );
-   gl_vboActivateAttribOffset( stsh->vbo_tex, shaders.font.tex_coord, 0, 2, GL_FLOAT, 0 );
-
-   /* Depth testing is used to draw the outline under the glyph. */
-   if (outlineR > 0.)
-      glEnable( GL_DEPTH_TEST );
-}
-
 /**
  * @brief Gets the colour from a character.
  */
@@ -1409,70 +1375,369 @@ static int gl_fontKernGlyph( glFontStash* stsh, uint32_t ch, glFontGlyph* glyph
 }
 
 /**
- * @brief Renders a character.
+ * @brief Hashes a piece of text for the layout cache (FNV-1a).
  */
-static int gl_fontRenderGlyph( glFontStash* stsh, uint32_t ch, const glColour *c, int state )
+static uint32_t font_layoutHash( int font_id, const char *text, size_t len, int max, int state )
 {
-   double scale;
-   int kern_adv_x;
-   glFontGlyph *glyph;
+   uint32_t h = 2166136261u;
+   for (size_t i=0; i<len; i++) {
+      h ^= (unsigned char) text[i];
+      h *= 16777619u;
+   }
+   h ^= (uint32_t) font_id;
+   h *= 16777619u;
+   h ^= (uint32_t) max;
+   h *= 16777619u;
+   h ^= (uint32_t) state;
+   h *= 16777619u;
+   return h;
+}
+
+/**
+ * @brief Removes a layout from the cache.
+ */
+static void gl_fontLayoutRemove( glFontLayout *l )
+{
+   int idx = l - font_layouts;
+   int *prev = &font_layoutLUT[ l->hash & (FONT_LAYOUT_LUT_SIZE-1) ];
 
-   /* Handle escape sequences. */
-   if ((ch == FONT_COLOUR_CODE) && (state==0)) { /* Start sequence. */
-      return 1;
+   /* Unlink from hash chain. */
+   while (*prev != -1) {
+      if (*prev == idx) {
+         *prev = l->next;
+         break;
+      }
+      prev = &font_layouts[ *prev ].next;
    }
-   if ((state == 1) && (ch != FONT_COLOUR_CODE)) {
-      const glColour *col = gl_fontGetColour( ch );
-      double a = (c==NULL) ? 1. : c->a;
-      if (col != NULL)
-         gl_uniformAColor(shaders.font.color, col, a );
-      else if (c==NULL)
-         gl_uniformColor(shaders.font.color, &cWhite);
-      else
-         gl_uniformColor(shaders.font.color, c);
-      font_lastCol = col;
-      return 0;
+
+   free( l->text );
+   l->text = NULL;
+   l->font_id = -1;
+   l->next = -1;
+   array_resize( &l->runs, 0 );
+}
+
+/**
+ * @brief Invalidates all the cached layouts of a font stash.
+ *
+ *    @param font_id ID of the font stash to invalidate or -1 for all.
+ */
+static void gl_fontLayoutInvalidate( int font_id )
+{
+   for (int i=0; i<array_size(font_layouts); i++) {
+      glFontLayout *l = &font_layouts[i];
+      if ((l->text != NULL) && ((font_id < 0) || (l->font_id == font_id)))
+         gl_fontLayoutRemove( l );
    }
+}
 
-   /* Unicode goes here.
-    * First try to find the glyph. */
-   glyph = gl_fontGetGlyph( stsh, ch );
-   if (glyph == NULL) {
-      WARN(_("Unable to find glyph '%d'!"), ch );
-      return -1;
+/**
+ * @brief Gets a free layout from the cache, evicting the least recently used one if necessary.
+ */
+static glFontLayout* gl_fontLayoutNew (void)
+{
+   glFontLayout *l;
+
+   if (font_layouts == NULL) {
+      font_layouts = array_create_size( glFontLayout, FONT_LAYOUT_CACHE_SIZE );
+      for (int i=0; i<FONT_LAYOUT_LUT_SIZE; i++)
+         font_layoutLUT[i] = -1;
    }
 
-   /* Kern if possible. */
-   scale = (double)stsh->h / FONT_DISTANCE_FIELD_SIZE;
-   kern_adv_x = gl_fontKernGlyph( stsh, ch, glyph );
-   if (kern_adv_x) {
-      mat4_translate( &font_projection_mat,
-            kern_adv_x/scale, 0, 0 );
+   /* Still have space. */
+   if (array_size(font_layouts) < FONT_LAYOUT_CACHE_SIZE) {
+      l = &array_grow( &font_layouts );
+      memset( l, 0, sizeof(glFontLayout) );
+      l->runs = array_create( glFontLayoutRun );
+      l->next = -1;
+      return l;
    }
 
-   /* Activate texture. */
-   glBindTexture(GL_TEXTURE_2D, stsh->tex[glyph->tex_index].id);
+   /* Evict least recently used. */
+   l = NULL;
+   for (int i=0; i<array_size(font_layouts); i++) {
+      glFontLayout *li = &font_layouts[i];
+      if (li->text == NULL) {
+         l = li;
+         break;
+      }
+      if ((l == NULL) || (li->lastuse < l->lastuse))
+         l = li;
+   }
+   if (l->text != NULL)
+      gl_fontLayoutRemove( l );
+   return l;
+}
 
-   glUniform1f(shaders.font.m, glyph->m);
-   gl_uniformMat4(shaders.font.projection, &font_projection_mat);
+/**
+ * @brief Builds the vertex data of a layout.
+ *
+ * Colours are not baked in, vertices only say whether they use the starting
+ * colour, the base colour or a colour code, so the same layout can be drawn
+ * in any colour.
+ */
+static void gl_fontLayoutBuild( glFontStash *stsh, glFontLayout *l, const char *text, size_t end )
+{
+   /* Triangle list corners for each glyph quad. */
+   const int corners[6] = { 0, 1, 2, 1, 3, 2 };
+   double scale, pen;
+   int state, n, nmax;
+   size_t i;
+   uint32_t ch;
+   GLfloat cur[4];
+   GLfloat *data;
 
-   /* Draw the element. */
-   glDrawArrays( GL_TRIANGLE_STRIP, glyph->vbo_id, 4 );
+   /* There can't be more glyphs than characters. */
+   nmax = 0;
+   i = 0;
+   while ((i < end) && (u8_nextchar( text, &i ) != 0))
+      nmax++;
+   data = malloc( sizeof(GLfloat) * FONT_LAYOUT_VERTEX_SIZE * 6 * MAX(nmax,1) );
 
-   /* Translate matrix. */
-   mat4_translate( &font_projection_mat,
-         glyph->adv_x/scale, 0, 0 );
+   scale = (double)stsh->h / FONT_DISTANCE_FIELD_SIZE;
+   cur[0] = cur[1] = cur[2] = 0.;
+   cur[3] = FONT_LAYOUT_COL_START;
+   state = l->state;
+   pen = 0.;
+   n = 0;
+   i = 0;
+   gl_fontKernStart();
+   while (i < end) {
+      glFontGlyph *glyph;
+      int kern_adv_x;
+      const GLshort *vbo_vert;
+      const GLfloat *vbo_tex;
+      size_t prev = i;
+
+      ch = u8_nextchar( text, &i );
+      if ((ch == 0) || (i > end)) {
+         i = prev;
+         break;
+      }
 
-   return 0;
+      /* Handle escape sequences. */
+      if ((ch == FONT_COLOUR_CODE) && (state==0)) {
+         state = 1;
+         continue;
+      }
+      if ((state == 1) && (ch != FONT_COLOUR_CODE)) {
+         const glColour *ecol = gl_fontGetColour( ch );
+         if (ecol != NULL) {
+            cur[0] = ecol->r;
+            cur[1] = ecol->g;
+            cur[2] = ecol->b;
+            cur[3] = FONT_LAYOUT_COL_CODE;
+         }
+         else {
+            cur[0] = cur[1] = cur[2] = 0.;
+            cur[3] = FONT_LAYOUT_COL_BASE;
+         }
+         l->lastcol = ecol;
+         l->lastcol_set = 1;
+         state = 0;
+         continue;
+      }
+
+      glyph = gl_fontGetGlyph( stsh, ch );
+      if (glyph == NULL) {
+         WARN(_("Unable to find glyph '%d'!"), ch );
+         state = -1;
+         continue;
+      }
+      state = 0;
+
+      /* Kern if possible. */
+      kern_adv_x = gl_fontKernGlyph( stsh, ch, glyph );
+      pen += kern_adv_x / scale;
+
+      /* Start a new run if the texture changes. */
+      if ((array_size(l->runs) == 0) || (array_back(l->runs).tex_index != glyph->tex_index)) {
+         glFontLayoutRun *run = &array_grow( &l->runs );
+         run->tex_index = glyph->tex_index;
+         run->start = 6*n;
+         run->n = 0;
+      }
+      array_back(l->runs).n += 6;
+
+      /* Add the vertices. */
+      vbo_vert = &stsh->vbo_vert_data[ 2*glyph->vbo_id ];
+      vbo_tex  = &stsh->vbo_tex_data[ 2*glyph->vbo_id ];
+      for (int j=0; j<6; j++) {
+         GLfloat *d = &data[ (6*n+j) * FONT_LAYOUT_VERTEX_SIZE ];
+         int k = corners[j];
+         d[0] = vbo_vert[2*k+0] + pen;
+         d[1] = vbo_vert[2*k+1];
+         d[2] = vbo_tex[2*k+0];
+         d[3] = vbo_tex[2*k+1];
+         d[4] = glyph->m;
+         d[5] = cur[0];
+         d[6] = cur[1];
+         d[7] = cur[2];
+         d[8] = cur[3];
+      }
+      n++;
+
+      pen += glyph->adv_x / scale;
+   }
+   l->state_end = state;
+
+   /* Upload. */
+   l->nvert = 6*n;
+   if (n > 0) {
+      GLsizei size = sizeof(GLfloat) * FONT_LAYOUT_VERTEX_SIZE * l->nvert;
+      if (l->vbo == NULL)
+         l->vbo = gl_vboCreateStatic( size, data );
+      else
+         gl_vboData( l->vbo, size, data );
+   }
+   free( data );
+}
+
+/**
+ * @brief Gets the layout of a piece of text, creating it if not cached.
+ *
+ * Layouts do not depend on the colour, so text that fades or blinks keeps
+ * using the same one.
+ *
+ *    @param font_id ID of the font stash to use.
+ *    @param text Text to lay out.
+ *    @param len Length of the text to lay out (in bytes).
+ *    @param max Maximum width of the text or -1 for no limit.
+ *    @param state Escape sequence state at the start of the text.
+ *    @return The layout of the text.
+ */
+static glFontLayout* gl_fontLayoutGet( int font_id, const char *text, size_t len, int max, int state )
+{
+   glFontStash *stsh = &avail_fonts[ font_id ];
+   glFontLayout *l;
+   uint32_t h;
+   int i, idx;
+
+   /* Look it up. */
+   h = font_layoutHash( font_id, text, len, max, state );
+   if (font_layouts != NULL) {
+      i = font_layoutLUT[ h & (FONT_LAYOUT_LUT_SIZE-1) ];
+      while (i != -1) {
+         l = &font_layouts[i];
+         if ((l->hash == h) && (l->font_id == font_id) && (l->len == len) &&
+               (l->max == max) && (l->state == state) &&
+               (memcmp( l->text, text, len ) == 0)) {
+            l->lastuse = ++font_layoutTick;
+            return l;
+         }
+         i = l->next;
+      }
+   }
+
+   /* Not found, so create it. */
+   l = gl_fontLayoutNew();
+   l->text     = malloc( len+1 );
+   memcpy( l->text, text, len );
+   l->text[len] = '\0';
+   l->len      = len;
+   l->hash     = h;
+   l->font_id  = font_id;
+   l->max      = max;
+   l->state    = state;
+   l->lastcol  = NULL;
+   l->lastcol_set = 0;
+   l->lastuse  = ++font_layoutTick;
+   l->width    = 0;
+   if (max >= 0)
+      l->ret = font_limitSize( stsh, &l->width, l->text, max );
+   else
+      l->ret = len;
+   gl_fontLayoutBuild( stsh, l, l->text, l->ret );
+
+   /* Add to hash table. */
+   idx = l - font_layouts;
+   l->next = font_layoutLUT[ h & (FONT_LAYOUT_LUT_SIZE-1) ];
+   font_layoutLUT[ h & (FONT_LAYOUT_LUT_SIZE-1) ] = idx;
+
+   return l;
 }
 
 /**
- * @brief Ends the rendering engine.
+ * @brief Renders a cached layout.
+ *
+ *    @param l Layout to render.
+ *    @param H Transformation matrix to render with.
+ *    @param outlineR Radius in px of outline (-1 for default, 0 for none)
+ *    @param c Colour to use (NULL defaults to white).
  */
-static void gl_fontRenderEnd (void)
+static void gl_fontRenderLayout( const glFontLayout *l, const mat4 *H, double outlineR, const glColour *c )
 {
-   glDisableVertexAttribArray( shaders.font.vertex );
-   glDisableVertexAttribArray( shaders.font.tex_coord );
+   const GLsizei stride = sizeof(GLfloat) * FONT_LAYOUT_VERTEX_SIZE;
+   const glFontStash *stsh = &avail_fonts[ l->font_id ];
+   const glColour *col;
+   glColour ccol;
+   double scale;
+   mat4 projection;
+
+   /* Starting colour, colour codes use its alpha. */
+   if (font_restoreLast && (font_lastCol != NULL))
+      col = font_lastCol;
+   else if (c==NULL)
+      col = &cWhite;
+   else
+      col = c;
+   ccol = *col;
+   ccol.a = (c==NULL) ? 1. : c->a;
+
+   /* Colour side effects. */
+   font_restoreLast = 0;
+   if (l->lastcol_set)
+      font_lastCol = l->lastcol;
+
+   if (l->nvert <= 0)
+      return;
+
+   outlineR = (outlineR==-1) ? 1 : MAX( outlineR, 0 );
+
+   glUseProgram(shaders.font_layout.program);
+   gl_uniformColor(shaders.font_layout.color, &ccol);
+   gl_uniformColor(shaders.font_layout.base, (c==NULL) ? &cWhite : c);
+   if (outlineR == 0.)
+      gl_uniformAColor(shaders.font_layout.outline_color, &ccol, 0.);
+   else
+      gl_uniformAColor(shaders.font_layout.outline_color, &cGrey10, ccol.a);
+
+   scale = (double)stsh->h / FONT_DISTANCE_FIELD_SIZE;
+   projection = *H;
+   mat4_scale( &projection, scale, scale, 1 );
+   gl_uniformMat4(shaders.font_layout.projection, &projection);
+
+   /* Set up the vertex data. */
+   glEnableVertexAttribArray( shaders.font_layout.vertex );
+   glEnableVertexAttribArray( shaders.font_layout.tex_coord );
+   glEnableVertexAttribArray( shaders.font_layout.vertex_m );
+   glEnableVertexAttribArray( shaders.font_layout.vertex_color );
+   gl_vboActivateAttribOffset( l->vbo, shaders.font_layout.vertex,
+         0, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( l->vbo, shaders.font_layout.tex_coord,
+         sizeof(GLfloat)*2, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( l->vbo, shaders.font_layout.vertex_m,
+         sizeof(GLfloat)*4, 1, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( l->vbo, shaders.font_layout.vertex_color,
+         sizeof(GLfloat)*5, 4, GL_FLOAT, stride );
+
+   /* Depth testing is used to draw the outline under the glyph. */
+   if (outlineR > 0.)
+      glEnable( GL_DEPTH_TEST );
+
+   /* One draw per texture run. */
+   for (int i=0; i<array_size(l->runs); i++) {
+      const glFontLayoutRun *run = &l->runs[i];
+      glBindTexture( GL_TEXTURE_2D, stsh->tex[ run->tex_index ].id );
+      glDrawArrays( GL_TRIANGLES, run->start, run->n );
+      gl_drawCalls++;
+   }
+
+   /* Clear state. */
+   glDisableVertexAttribArray( shaders.font_layout.vertex );
+   glDisableVertexAttribArray( shaders.font_layout.tex_coord );
+   glDisableVertexAttribArray( shaders.font_layout.vertex_m );
+   glDisableVertexAttribArray( shaders.font_layout.vertex_color );
    glUseProgram(0);
 
    glDisable( GL_DEPTH_TEST );
@@ -1481,6 +1746,32 @@ static void gl_fontRenderEnd (void)
    gl_checkErr();
 }
 
+/**
+ * @brief Gets the transformation to render text at a screen position.
+ */
+static mat4 gl_fontPositionMatrix( double x, double y )
+{
+   /* OpenGL has pixel centers at 0.5 offset. */
+   mat4 H = gl_view_matrix;
+   mat4_translate( &H, x+0.5*gl_screen.wscale, y+0.5*gl_screen.hscale, 0 );
+   return H;
+}
+
+/**
+ * @brief Frees the text layout cache.
+ */
+static void gl_fontLayoutExit (void)
+{
+   for (int i=0; i<array_size(font_layouts); i++) {
+      glFontLayout *l = &font_layouts[i];
+      free( l->text );
+      array_free( l->runs );
+      gl_vboDestroy( l->vbo );
+   }
+   array_free( font_layouts );
+   font_layouts = NULL;
+}
+
 /**
  * @brief Sets the minification and magnification filters for a font.
  *
@@ -1731,6 +2022,8 @@ void gl_freeFont( glFont* font )
       return;
    /* Not references and must eliminate. */
 
+   gl_fontLayoutInvalidate( font->id );
+
    for (int i=0; i<array_size(stsh->ft); i++)
       gl_fontstashftDestroy( &stsh->ft[i] );
    array_free( stsh->ft );
@@ -1769,6 +2062,7 @@ static void gl_fontstashftDestroy( glFontStashFreetype *ft )
  */
 void gl_fontExit (void)
 {
+   gl_fontLayoutExit();
    FT_Done_FreeType( font_library );
    font_library = NULL;
    array_free( avail_fonts );
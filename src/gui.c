@@ -65,6 +65,15 @@
 
 #define RADAR_BLINK_PILOT     0.5 /**< Blink rate of the pilot target on radar. */
 #define RADAR_BLINK_SPOB      1. /**< Blink rate of the spob target on radar. */
+#define RADAR_BATCH_VERTEX_SIZE  12 /**< Floats per radar marker vertex: corner(2), centre(2), size(2), angle(1), shape(1), colour(4). */
+
+/**
+ * @brief Shapes of the batched radar markers, must match radarmarker.frag.
+ */
+typedef enum RadarMarkerShape_ {
+   RADAR_MARKER_PILOT,     /**< Pilot triangle. */
+   RADAR_MARKER_ASTEROID,  /**< Asteroid square. */
+} RadarMarkerShape;
 
 /* some blinking stuff. */
 static double blink_pilot     = 0.; /**< Timer on target blinking on radar. */
@@ -74,6 +83,12 @@ static double animation_dt    = 0.; /**< Used for animations. */
 /* for VBO. */
 static gl_vbo *gui_radar_select_vbo = NULL;
 
+/* Radar marker batching. */
+static int gui_radarBatchActive     = 0;    /**< Whether or not radar markers are being batched. */
+static GLfloat *gui_radarBatchData  = NULL; /**< Array (array.h): Vertex data of the batched markers. */
+static gl_vbo *gui_radarBatchVBO    = NULL; /**< Radar marker batch VBO. */
+static GLsizei gui_radarBatchVBOSize = 0;   /**< Current size of the radar marker batch VBO. */
+
 static int gui_getMessage     = 1; /**< Whether or not the player should receive messages. */
 static char *gui_name         = NULL; /**< Name of the GUI (for errors and such). */
 
@@ -186,6 +201,9 @@ static void gui_renderMessages( double dt );
 static const glColour *gui_getSpobColour( int i );
 static void gui_renderRadarOutOfRange( RadarShape sh, int w, int h, int cx, int cy, const glColour *col );
 static void gui_blink( double cx, double cy, double vr, const glColour *col, double blinkInterval, double blinkVar );
+static void gui_radarBatchAdd( double x, double y, double w, double h, double angle,
+      const glColour *c, RadarMarkerShape shape );
+static int gui_radarAnchorVisible( int fie, RadarShape shape, double w, double h, double res );
 static const glColour* gui_getPilotColour( const Pilot* p );
 static void gui_calcBorders (void);
 /* Lua GUI. */
@@ -928,7 +946,8 @@ void gui_radarRender( double x, double y )
    weapon_minimap( radar->res, radar->w, radar->h,
          radar->shape, 1. );
 
-   /* render the pilot */
+   /* render the pilot and asteroid markers in a single batch. */
+   gui_radarBatchBegin();
    pilot_stack = pilot_getAll();
    f = 0;
    for (int i=1; i<array_size(pilot_stack); i++) { /* skip the player */
@@ -937,16 +956,20 @@ void gui_radarRender( double x, double y )
       else
          gui_renderPilot( pilot_stack[i], radar->shape, radar->w, radar->h, radar->res, 0 );
    }
-   /* render the targeted pilot */
-   if (f != 0)
-      gui_renderPilot( pilot_stack[f], radar->shape, radar->w, radar->h, radar->res, 0 );
 
    /* render the asteroids */
    for (int i=0; i<array_size(cur_system->asteroids); i++) {
       AsteroidAnchor *ast = &cur_system->asteroids[i];
+      if (!gui_radarAnchorVisible( i, radar->shape, radar->w, radar->h, radar->res ))
+         continue;
       for (int j=0; j<ast->nb; j++)
          gui_renderAsteroid( &ast->asteroids[j], radar->w, radar->h, radar->res, 0 );
    }
+   gui_radarBatchEnd();
+
+   /* render the targeted pilot */
+   if (f != 0)
+      gui_renderPilot( pilot_stack[f], radar->shape, radar->w, radar->h, radar->res, 0 );
 
    /* Render the player. */
    gui_renderPlayer( radar->res, 0 );
@@ -1081,6 +1104,145 @@ static const glColour* gui_getPilotColour( const Pilot* p )
    return col;
 }
 
+/**
+ * @brief Starts batching radar markers.
+ *
+ * Pilot and asteroid markers rendered with gui_renderPilot() and
+ * gui_renderAsteroid() are queued until gui_radarBatchEnd() draws them all
+ * with a single call. Anything else (highlights, blinking, names) is still
+ * drawn immediately.
+ */
+void gui_radarBatchBegin (void)
+{
+   if (gui_radarBatchData == NULL)
+      gui_radarBatchData = array_create( GLfloat );
+   array_resize( &gui_radarBatchData, 0 );
+   gui_radarBatchActive = 1;
+}
+
+/**
+ * @brief Adds a marker to the radar batch.
+ *
+ *    @param x X position of the center.
+ *    @param y Y position of the center.
+ *    @param w Half width of the marker.
+ *    @param h Half height of the marker.
+ *    @param angle Rotation of the marker.
+ *    @param c Colour of the marker.
+ *    @param shape Shape of the marker.
+ */
+static void gui_radarBatchAdd( double x, double y, double w, double h, double angle,
+      const glColour *c, RadarMarkerShape shape )
+{
+   const GLfloat corners[6][2] = {
+      {-1., -1.}, { 1., -1.}, {-1.,  1.},
+      { 1., -1.}, { 1.,  1.}, {-1.,  1.} };
+   for (int i=0; i<6; i++) {
+      GLfloat *v;
+      int n = array_size(gui_radarBatchData);
+      array_resize( &gui_radarBatchData, n + RADAR_BATCH_VERTEX_SIZE );
+      v = &gui_radarBatchData[n];
+      v[0]  = corners[i][0];
+      v[1]  = corners[i][1];
+      v[2]  = x;
+      v[3]  = y;
+      v[4]  = w;
+      v[5]  = h;
+      v[6]  = angle;
+      v[7]  = shape;
+      v[8]  = c->r;
+      v[9]  = c->g;
+      v[10] = c->b;
+      v[11] = c->a;
+   }
+}
+
+/**
+ * @brief Draws all the batched radar markers and stops batching.
+ */
+void gui_radarBatchEnd (void)
+{
+   GLsizei size, n;
+   const GLsizei stride = sizeof(GLfloat) * RADAR_BATCH_VERTEX_SIZE;
+
+   gui_radarBatchActive = 0;
+   n = array_size(gui_radarBatchData) / RADAR_BATCH_VERTEX_SIZE;
+   if (n <= 0)
+      return;
+
+   /* Upload the data. */
+   size = sizeof(GLfloat) * array_size(gui_radarBatchData);
+   if (gui_radarBatchVBO == NULL) {
+      gui_radarBatchVBOSize = MAX( size, (GLsizei)(256 * 6 * stride) );
+      gui_radarBatchVBO = gl_vboCreateDynamic( gui_radarBatchVBOSize, NULL );
+   }
+   else if (size > gui_radarBatchVBOSize) {
+      gui_radarBatchVBOSize = 2 * size;
+      gl_vboData( gui_radarBatchVBO, gui_radarBatchVBOSize, NULL );
+   }
+   gl_vboSubData( gui_radarBatchVBO, 0, size, gui_radarBatchData );
+
+   glUseProgram( shaders.radarmarker.program );
+   glEnableVertexAttribArray( shaders.radarmarker.vertex );
+   glEnableVertexAttribArray( shaders.radarmarker.vertex_center );
+   glEnableVertexAttribArray( shaders.radarmarker.vertex_size );
+   glEnableVertexAttribArray( shaders.radarmarker.vertex_angle );
+   glEnableVertexAttribArray( shaders.radarmarker.vertex_shape );
+   glEnableVertexAttribArray( shaders.radarmarker.vertex_color );
+   gl_vboActivateAttribOffset( gui_radarBatchVBO, shaders.radarmarker.vertex,
+         0, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gui_radarBatchVBO, shaders.radarmarker.vertex_center,
+         sizeof(GLfloat)*2, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gui_radarBatchVBO, shaders.radarmarker.vertex_size,
+         sizeof(GLfloat)*4, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gui_radarBatchVBO, shaders.radarmarker.vertex_angle,
+         sizeof(GLfloat)*6, 1, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gui_radarBatchVBO, shaders.radarmarker.vertex_shape,
+         sizeof(GLfloat)*7, 1, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gui_radarBatchVBO, shaders.radarmarker.vertex_color,
+         sizeof(GLfloat)*8, 4, GL_FLOAT, stride );
+   gl_uniformMat4( shaders.radarmarker.projection, &gl_view_matrix );
+
+   glDrawArrays( GL_TRIANGLES, 0, n );
+   gl_drawCalls++;
+
+   glDisableVertexAttribArray( shaders.radarmarker.vertex );
+   glDisableVertexAttribArray( shaders.radarmarker.vertex_center );
+   glDisableVertexAttribArray( shaders.radarmarker.vertex_size );
+   glDisableVertexAttribArray( shaders.radarmarker.vertex_angle );
+   glDisableVertexAttribArray( shaders.radarmarker.vertex_shape );
+   glDisableVertexAttribArray( shaders.radarmarker.vertex_color );
+   glUseProgram(0);
+   gl_checkErr();
+}
+
+/**
+ * @brief Checks to see if any asteroid of a field can show up on the radar.
+ *
+ *    @param fie Asteroid field to check.
+ *    @param shape Shape of the radar (RADAR_RECT or RADAR_CIRCLE).
+ *    @param w Width.
+ *    @param h Height.
+ *    @param res Radar resolution.
+ *    @return 1 if the field can have visible asteroids.
+ */
+static int gui_radarAnchorVisible( int fie, RadarShape shape, double w, double h, double res )
+{
+   double view;
+   const AsteroidAnchor *ast = &cur_system->asteroids[fie];
+
+   /* Asteroids must be in sensor range. */
+   if (!pilot_inRangeAsteroidField( player.p, fie ))
+      return 0;
+
+   /* And on the radar. */
+   if (shape==RADAR_CIRCLE)
+      view = w * res;
+   else
+      view = hypot( w, h ) / 2. * res;
+   return (vec2_dist2( &player.p->solid->pos, &ast->pos ) <= pow2( view + ast->radius + ast->margin ));
+}
+
 /**
  * @brief Renders a pilot in the GUI radar.
  *
@@ -1148,8 +1310,12 @@ void gui_renderPilot( const Pilot* p, RadarShape shape, double w, double h, doub
       gl_renderShader( x, y, scale*2.0, scale*2.0, 0., &shaders.hilight, &highlighted, 1 );
    }
 
-   glUseProgram(shaders.pilotmarker.program);
-   gl_renderShader( x, y, scale, scale, p->solid->dir, &shaders.pilotmarker, col, 1 );
+   if (gui_radarBatchActive)
+      gui_radarBatchAdd( x, y, scale, scale, p->solid->dir, col, RADAR_MARKER_PILOT );
+   else {
+      glUseProgram(shaders.pilotmarker.program);
+      gl_renderShader( x, y, scale, scale, p->solid->dir, &shaders.pilotmarker, col, 1 );
+   }
 
    /* Draw selection if targeted. */
    if (p->id == player.p->target)
@@ -1226,8 +1392,12 @@ void gui_renderAsteroid( const Asteroid* a, double w, double h, double res, int
 
    //gl_renderRect( px, py, MIN( 2*sx, w-px ), MIN( 2*sy, h-py ), col );
    r = (sx+sy)/2.0+1.5;
-   glUseProgram(shaders.asteroidmarker.program);
-   gl_renderShader( px, py, r, r, 0., &shaders.asteroidmarker, col, 1 );
+   if (gui_radarBatchActive)
+      gui_radarBatchAdd( px, py, r, r, 0., col, RADAR_MARKER_ASTEROID );
+   else {
+      glUseProgram(shaders.asteroidmarker.program);
+      gl_renderShader( px, py, r, r, 0., &shaders.asteroidmarker, col, 1 );
+   }
 
    if (targeted)
       gui_blink( px, py, MAX(7., 2.0*r), col, RADAR_BLINK_PILOT, blink_pilot );
@@ -1977,6 +2147,11 @@ void gui_free (void)
 
    gl_vboDestroy( gui_radar_select_vbo );
    gui_radar_select_vbo = NULL;
+   gl_vboDestroy( gui_radarBatchVBO );
+   gui_radarBatchVBO = NULL;
+   gui_radarBatchVBOSize = 0;
+   array_free( gui_radarBatchData );
+   gui_radarBatchData = NULL;
 
    osd_exit();
 
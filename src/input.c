@@ -30,6 +30,7 @@
 #include "pause.h"
 #include "pilot.h"
 #include "player.h"
+#include "replay.h"
 #include "toolkit.h"
 #include "weapon.h"
 #include "utf8.h"
@@ -145,6 +146,7 @@ static int input_accelButton        = 0; /**< Used to show whether accel is pres
 static int repeat_key                  = -1; /**< Key to repeat. */
 static unsigned int repeat_keyTimer    = 0;  /**< Repeat timer. */
 static unsigned int repeat_keyCounter  = 0;  /**< Counter for key repeats. */
+static int input_replaying             = 0;  /**< Whether the key being run comes from a replay. */
 
 /*
  * Mouse.
@@ -647,6 +649,25 @@ void input_update( double dt )
    }
 }
 
+/**
+ * @brief Runs a key binding from a replay.
+ *
+ *    @param keynum The index of the keybind.
+ *    @param value The value of the keypress (defined above).
+ *    @param kabs The absolute value.
+ *    @param repeat Whether the key is still held down, rather than newly pressed.
+ */
+void input_keyReplay( int keynum, double value, double kabs, int repeat )
+{
+   if ((keynum < 0) || (keynum >= input_numbinds)) {
+      WARN(_("Replay uses unknown key binding %d!"), keynum);
+      return;
+   }
+   input_replaying = 1;
+   input_key( keynum, value, kabs, repeat );
+   input_replaying = 0;
+}
+
 #define KEY(s)    (strcmp(input_keybinds[keynum].name,s)==0) /**< Shortcut for ease. */
 #define INGAME()  (!toolkit_isOpen() && ((value==KEY_RELEASE) || !player_isFlag(PLAYER_CINEMATICS))) /**< Makes sure player is in game. */
 #define NOHYP()   \
@@ -667,6 +688,14 @@ static void input_key( int keynum, double value, double kabs, int repeat )
 {
    HookParam hparam[3];
 
+   /* Replays feed the keys themselves, while recordings log them. */
+   if (replay_isPlaying()) {
+      if (!input_replaying)
+         return;
+   }
+   else
+      replay_key( keynum, value, kabs, repeat );
+
    /* Repetition stuff. */
    if (conf.repeat_delay != 0) {
       if ((value == KEY_PRESS) && !repeat) {
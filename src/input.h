@@ -64,6 +64,7 @@ int input_isDoubleClick( void *clicked );
  * handle input
  */
 void input_handle( SDL_Event* event );
+void input_keyReplay( int keynum, double value, double kabs, int repeat );
 
 /*
  * init/exit
@@ -0,0 +1,212 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+/**
+ * @file intern.c
+ *
+ * @brief Interned strings for universe object names.
+ *
+ * Every distinct name is given a small stable integer ID for the rest of the
+ * session. The object stacks (systems, spobs, outfits, ships, commodities and
+ * factions) keep maps from these IDs to their own indices so that looking up
+ * by name is a single hash lookup instead of a bsearch or linear scan over
+ * strcmp.
+ */
+/** @cond */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "naev.h"
+/** @endcond */
+
+#include "intern.h"
+
+#include "array.h"
+
+#define INTERN_TABLE_MIN   1024 /**< Minimum size of the hash table, must be a power of two. */
+
+static char **intern_strs     = NULL; /**< Array (array.h): Interned strings, indexed by ID. */
+static uint32_t *intern_hashes = NULL; /**< Array (array.h): Hash of each interned string, indexed by ID. */
+static int *intern_table      = NULL; /**< Open addressing hash table of IDs, -1 for empty slots. */
+static int intern_tablesize   = 0; /**< Number of slots in intern_table. */
+
+/*
+ * Prototypes.
+ */
+static uint32_t intern_hash( const char *str );
+static void intern_insert( int id );
+static void intern_rehash( int size );
+
+/**
+ * @brief FNV-1a hash of a string.
+ */
+static uint32_t intern_hash( const char *str )
+{
+   uint32_t h = 2166136261u;
+   for (const unsigned char *c=(const unsigned char*)str; *c!='\0'; c++) {
+      h ^= *c;
+      h *= 16777619u;
+   }
+   return h;
+}
+
+/**
+ * @brief Inserts an already interned ID into the hash table.
+ */
+static void intern_insert( int id )
+{
+   int mask = intern_tablesize-1;
+   int i = intern_hashes[id] & mask;
+   while (intern_table[i] >= 0)
+      i = (i+1) & mask;
+   intern_table[i] = id;
+}
+
+/**
+ * @brief Resizes the hash table and reinserts all the IDs.
+ */
+static void intern_rehash( int size )
+{
+   free( intern_table );
+   intern_tablesize = size;
+   intern_table = malloc( size * sizeof(int) );
+   for (int i=0; i<size; i++)
+      intern_table[i] = -1;
+   for (int i=0; i<array_size(intern_strs); i++)
+      intern_insert( i );
+}
+
+/**
+ * @brief Gets the ID of an interned string.
+ *
+ *    @param str String to look up.
+ *    @return ID of the string or -1 if it was never interned.
+ */
+int intern_find( const char *str )
+{
+   uint32_t h;
+   int mask, i;
+
+   if ((str==NULL) || (intern_table==NULL))
+      return -1;
+
+   h = intern_hash( str );
+   mask = intern_tablesize-1;
+   i = h & mask;
+   while (intern_table[i] >= 0) {
+      int id = intern_table[i];
+      if ((intern_hashes[id]==h) && (strcmp(intern_strs[id],str)==0))
+         return id;
+      i = (i+1) & mask;
+   }
+   return -1;
+}
+
+/**
+ * @brief Interns a string, giving it an ID if it does not have one yet.
+ *
+ *    @param str String to intern.
+ *    @return ID of the string, stable until intern_free().
+ */
+int intern_id( const char *str )
+{
+   int id = intern_find( str );
+   if (id >= 0)
+      return id;
+
+   if (intern_strs == NULL) {
+      intern_strs    = array_create( char* );
+      intern_hashes  = array_create( uint32_t );
+   }
+   id = array_size(intern_strs);
+   array_push_back( &intern_strs, strdup(str) );
+   array_push_back( &intern_hashes, intern_hash(str) );
+
+   /* Keep the load factor under 3/4. */
+   if (4*array_size(intern_strs) > 3*intern_tablesize)
+      intern_rehash( MAX( INTERN_TABLE_MIN, 2*intern_tablesize ) );
+   else
+      intern_insert( id );
+   return id;
+}
+
+/**
+ * @brief Gets the string corresponding to an ID.
+ *
+ *    @param id ID to get string of.
+ *    @return The interned string or NULL if invalid.
+ */
+const char *intern_str( int id )
+{
+   if ((id < 0) || (id >= array_size(intern_strs)))
+      return NULL;
+   return intern_strs[id];
+}
+
+/**
+ * @brief Frees all the interned strings.
+ *
+ * Any maps built with intern_mapSet() are invalid afterwards.
+ */
+void intern_free (void)
+{
+   for (int i=0; i<array_size(intern_strs); i++)
+      free( intern_strs[i] );
+   array_free( intern_strs );
+   intern_strs = NULL;
+   array_free( intern_hashes );
+   intern_hashes = NULL;
+   free( intern_table );
+   intern_table = NULL;
+   intern_tablesize = 0;
+}
+
+/**
+ * @brief Sets the index a name maps to.
+ *
+ *    @param[in, out] map Map (array.h) to modify, created if NULL.
+ *    @param str Name to map.
+ *    @param idx Index to map the name to.
+ */
+void intern_mapSet( int **map, const char *str, int idx )
+{
+   int id = intern_id( str );
+   int n = array_size(*map);
+   if (*map == NULL)
+      *map = array_create_size( int, id+1 );
+   if (id >= n) {
+      array_resize( map, id+1 );
+      for (int i=n; i<=id; i++)
+         (*map)[i] = -1;
+   }
+   (*map)[id] = idx;
+}
+
+/**
+ * @brief Removes a name from a map.
+ *
+ *    @param map Map (array.h) to modify.
+ *    @param str Name to remove.
+ */
+void intern_mapUnset( int *map, const char *str )
+{
+   int id = intern_find( str );
+   if ((id >= 0) && (id < array_size(map)))
+      map[id] = -1;
+}
+
+/**
+ * @brief Gets the index a name maps to.
+ *
+ *    @param map Map (array.h) to look up in.
+ *    @param str Name to look up.
+ *    @return The index or -1 if the name is not in the map.
+ */
+int intern_mapGet( const int *map, const char *str )
+{
+   int id = intern_find( str );
+   if ((id < 0) || (id >= array_size(map)))
+      return -1;
+   return map[id];
+}
@@ -0,0 +1,19 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+#pragma once
+
+/*
+ * String interning.
+ */
+int intern_id( const char *str );
+int intern_find( const char *str );
+const char *intern_str( int id );
+void intern_free (void);
+
+/*
+ * Maps from interned IDs to stack indices.
+ */
+void intern_mapSet( int **map, const char *str, int idx );
+void intern_mapUnset( int *map, const char *str );
+int intern_mapGet( const int *map, const char *str );
@@ -1710,6 +1710,10 @@ void land_cleanup (void)
 
    /* Deselect stuff. */
    equipment_slotDeselect( NULL );
+
+   /* Free store graphics that haven't been seen in a while. */
+   outfit_gfxStoreEvict();
+   ship_gfxStoreEvict();
 }
 
 /**
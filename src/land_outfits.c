@@ -453,7 +453,7 @@ void outfits_update( unsigned int wid, const char *str )
    outfit = iar_outfits[active][i];
 
    /* new image */
-   window_modifyImage( wid, "imgOutfit", outfit->gfx_store, 256, 256 );
+   window_modifyImage( wid, "imgOutfit", outfit_gfxStore( outfit ), 256, 256 );
 
    /* new text */
    window_modifyText( wid, "txtDescription", pilot_outfitDescription( player.p, outfit ) );
@@ -701,7 +701,7 @@ ImageArrayCell *outfits_imageArrayCells( const Outfit **outfits, int *noutfits,
          glTexture *t;
          const Outfit *o = outfits[i];
 
-         coutfits[i].image = gl_dupTexture( o->gfx_store );
+         coutfits[i].image = gl_dupTexture( outfit_gfxStore( o ) );
          coutfits[i].caption = strdup( _(o->name) );
          coutfits[i].quantity = player_outfitOwned(o);
 
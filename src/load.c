@@ -8,6 +8,7 @@
  */
 
 /** @cond */
+#include "libxml/xmlreader.h"
 #include "physfs.h"
 
 #include "naev.h"
@@ -35,7 +36,9 @@
 #include "outfit.h"
 #include "player.h"
 #include "plugin.h"
+#include "replay.h"
 #include "save.h"
+#include "savefile.h"
 #include "shiplog.h"
 #include "start.h"
 #include "space.h"
@@ -56,6 +59,14 @@ typedef struct filedata {
    PHYSFS_Stat stat;
 } filedata_t;
 
+/**
+ * @brief Sections of a saved game being loaded, in either format.
+ */
+typedef struct LoadSections_ {
+   SaveFile *sf; /**< Chunked saved game, NULL for XML saved games. */
+   xmlDocPtr doc; /**< Whole XML saved game, or the last chunk parsed. */
+} LoadSections;
+
 typedef struct player_saves_s {
    char *name;
    nsave_t *saves;
@@ -103,6 +114,8 @@ static void load_snapshot_menu_save( unsigned int wdw, const char *str );
 static void display_save_info( unsigned int wid, const nsave_t *ns );
 static void move_old_save( const char *path, const char *fname, const char *ext, const char *new_name );
 static int load_load( nsave_t *save, const char *path );
+static int load_loadHead( nsave_t *save, const char *path );
+static void load_freeSave( nsave_t *ns );
 static int load_game( nsave_t *ns );
 static int load_gameInternal( const char* file, const char* version );
 static int load_gameInternalHook( void *data );
@@ -114,106 +127,273 @@ static SaveCompatibility load_compatibility( const nsave_t *ns );
 static int load_sortComparePlayers( const void *p1, const void *p2 );
 static int load_sortCompare( const void *p1, const void *p2 );
 static xmlDocPtr load_xml_parsePhysFS( const char* filename );
+static int load_sectionsOpen( LoadSections *ls, const char *file );
+static xmlNodePtr load_section( LoadSections *ls, const char *chunk );
+static void load_sectionsClose( LoadSections *ls );
+static char *load_readerText( xmlTextReaderPtr reader );
+static char *load_readerAttr( xmlTextReaderPtr reader, const char *name );
 
 /**
- * @brief Loads an individual save.
+ * @brief Gets the text of the element the reader is on.
+ *
+ *    @return Newly allocated text or NULL if there is none.
+ */
+static char *load_readerText( xmlTextReaderPtr reader )
+{
+   char *str;
+   xmlChar *xstr = xmlTextReaderReadString( reader );
+   if (xstr == NULL)
+      return NULL;
+   str = strdup( (const char*)xstr );
+   xmlFree( xstr );
+   return str;
+}
+
+/**
+ * @brief Gets an attribute of the element the reader is on.
+ *
+ *    @return Newly allocated attribute value or NULL if it does not exist.
+ */
+static char *load_readerAttr( xmlTextReaderPtr reader, const char *name )
+{
+   char *str;
+   xmlChar *xstr = xmlTextReaderGetAttribute( reader, (const xmlChar*)name );
+   if (xstr == NULL)
+      return NULL;
+   str = strdup( (const char*)xstr );
+   xmlFree( xstr );
+   return str;
+}
+
+/**
+ * @brief Loads the header of a chunked save.
+ *
+ * Fields are only ever appended to the header, so headers written by newer
+ * versions can be read too.
+ *
  * @param[out] save Structure to populate.
  * @param path PhysicsFS path (i.e., relative path starting with "saves/").
  * @return 0 on success.
  */
-static int load_load( nsave_t *save, const char *path )
+static int load_loadHead( nsave_t *save, const char *path )
 {
-   xmlDocPtr doc;
-   xmlNodePtr root, parent, node, cur;
-   int cycles, periods, seconds;
+   SaveFile *sf;
+   SaveCursor sc;
+   char *data;
+   size_t len;
+   uint32_t nplugins;
 
    memset( save, 0, sizeof(nsave_t) );
 
-   /* Load the XML. */
-   doc = load_xml_parsePhysFS( path );
-   if (doc == NULL) {
+   sf = savefile_open( path );
+   if (sf == NULL)
+      return -1;
+   data = savefile_read( sf, SAVE_CHUNK_HEAD, NULL, &len );
+   savefile_free( sf );
+   if (data == NULL) {
       WARN( _("Unable to parse save path '%s'."), path);
       return -1;
    }
-   root = doc->xmlChildrenNode; /* base node */
-   if (root == NULL) {
-      WARN( _("Unable to get child node of save '%s'."), path);
-      xmlFreeDoc(doc);
+
+   memset( &sc, 0, sizeof(sc) );
+   sc.data = data;
+   sc.len  = len;
+
+   /* Save path. */
+   save->path = strdup(path);
+
+   /* Naev info. */
+   save->version = savefile_unpackStr( &sc );
+   save->data = savefile_unpackStr( &sc );
+   savefile_unpackU64( &sc ); /* Last played. */
+
+   /* Plugins. */
+   save->plugins = array_create( char* );
+   nplugins = savefile_unpackU32( &sc );
+   for (uint32_t i=0; (i<nplugins) && !sc.err; i++) {
+      char *plugin = savefile_unpackStr( &sc );
+      if (plugin != NULL)
+         array_push_back( &save->plugins, plugin );
+      else
+         WARN(_("Save '%s' has unnamed plugin node!"), path);
+   }
+
+   /* Player info. */
+   save->player_name = savefile_unpackStr( &sc );
+   save->spob = savefile_unpackStr( &sc );
+   save->chapter = savefile_unpackStr( &sc );
+   save->difficulty = savefile_unpackStr( &sc );
+   save->credits = savefile_unpackU64( &sc );
+   save->date = (ntime_t) savefile_unpackU64( &sc );
+
+   /* Ship info. */
+   save->shipname = savefile_unpackStr( &sc );
+   save->shipmodel = savefile_unpackStr( &sc );
+   free( data );
+
+   if (sc.err || (save->player_name == NULL)) {
+      WARN( _("Unable to parse save path '%s'."), path);
+      load_freeSave( save );
+      return -1;
+   }
+
+   /* Defaults. */
+   if (save->chapter==NULL)
+      save->chapter = strdup( start_chapter() );
+
+   save->compatible = load_compatibility( save );
+
+   return 0;
+}
+
+/**
+ * @brief Loads an individual save.
+ *
+ * Only the header information is needed for the load menus. Chunked saves
+ * keep it in its own chunk. XML saves are streamed and everything else is
+ * skipped without building a document, the reader stops as soon as the
+ * player information has been read.
+ *
+ * @param[out] save Structure to populate.
+ * @param path PhysicsFS path (i.e., relative path starting with "saves/").
+ * @return 0 on success.
+ */
+static int load_load( nsave_t *save, const char *path )
+{
+   char buf[PATH_MAX];
+   xmlTextReaderPtr reader;
+   const char *section;
+   int ret, hastime, cycles, periods, seconds;
+
+   if (savefile_isChunked( path ))
+      return load_loadHead( save, path );
+
+   memset( save, 0, sizeof(nsave_t) );
+
+   /* Open the save, gzipped saves are handled transparently. */
+   snprintf( buf, sizeof(buf), "%s/%s", PHYSFS_getWriteDir(), path );
+   reader = xmlReaderForFile( buf, NULL, XML_PARSE_HUGE );
+   if (reader == NULL) {
+      WARN( _("Unable to parse save path '%s'."), path);
       return -1;
    }
 
    /* Save path. */
    save->path = strdup(path);
 
-   /* Iterate inside the naev_save. */
-   parent = root->xmlChildrenNode;
-   do {
-      xml_onlyNodes(parent);
+   section = NULL;
+   hastime = cycles = periods = seconds = 0;
+   ret = xmlTextReaderRead( reader );
+   while (ret == 1) {
+      const char *name;
+      int depth;
 
-      /* Info. */
-      if (xml_isNode(parent, "version")) {
-         node = parent->xmlChildrenNode;
-         do {
-            xmlr_strd(node, "naev", save->version);
-            xmlr_strd(node, "data", save->data);
-         } while (xml_nextNode(node));
+      if (xmlTextReaderNodeType( reader ) != XML_READER_TYPE_ELEMENT) {
+         ret = xmlTextReaderRead( reader );
          continue;
       }
+      name  = (const char*) xmlTextReaderConstName( reader );
+      depth = xmlTextReaderDepth( reader );
+
+      /* Children of naev_save. */
+      if (depth == 1) {
+         /* The player comes after the header, nothing else is needed. */
+         if ((section != NULL) && (strcmp(section, "player")==0))
+            break;
 
-      else if (xml_isNode(parent, "player")) {
-         /* Get name. */
-         xmlr_attr_strd(parent, "name", save->player_name);
-         /* Parse rest. */
-         node = parent->xmlChildrenNode;
-         do {
-            xml_onlyNodes(node);
+         if (strcmp(name, "version")==0)
+            section = "version";
+         else if (strcmp(name, "plugins")==0) {
+            section = "plugins";
+            if (save->plugins == NULL)
+               save->plugins = array_create( char* );
+         }
+         else if (strcmp(name, "player")==0) {
+            section = "player";
+            save->player_name = load_readerAttr( reader, "name" );
+         }
+         else {
+            section = NULL;
+            ret = xmlTextReaderNext( reader );
+            continue;
+         }
+      }
 
+      /* Info. */
+      else if ((depth == 2) && (section != NULL)) {
+         if (strcmp(section, "version")==0) {
+            if (strcmp(name, "naev")==0)
+               save->version = load_readerText( reader );
+            else if (strcmp(name, "data")==0)
+               save->data = load_readerText( reader );
+         }
+         else if (strcmp(section, "plugins")==0) {
+            if (strcmp(name, "plugin")==0) {
+               char *plugin = load_readerText( reader );
+               if (plugin != NULL)
+                  array_push_back( &save->plugins, plugin );
+               else
+                  WARN(_("Save '%s' has unnamed plugin node!"), path);
+            }
+         }
+         else if (strcmp(section, "player")==0) {
             /* Player info. */
-            xmlr_strd(node, "location", save->spob);
-            xmlr_ulong(node, "credits", save->credits);
-            xmlr_strd(node, "chapter", save->chapter);
-            xmlr_strd(node, "difficulty", save->difficulty);
-
-            /* Time. */
-            if (xml_isNode(node, "time")) {
-               cur = node->xmlChildrenNode;
+            if (strcmp(name, "location")==0)
+               save->spob = load_readerText( reader );
+            else if (strcmp(name, "chapter")==0)
+               save->chapter = load_readerText( reader );
+            else if (strcmp(name, "difficulty")==0)
+               save->difficulty = load_readerText( reader );
+            else if (strcmp(name, "credits")==0) {
+               char *str = load_readerText( reader );
+               if (str != NULL)
+                  save->credits = strtoull( str, NULL, 10 );
+               free( str );
+            }
+            /* Time, the units are one level down. */
+            else if (strcmp(name, "time")==0) {
+               hastime = 1;
                cycles = periods = seconds = 0;
-               do {
-                  xmlr_int(cur, "SCU", cycles);
-                  xmlr_int(cur, "STP", periods);
-                  xmlr_int(cur, "STU", seconds);
-               } while (xml_nextNode(cur));
-               save->date = ntime_create( cycles, periods, seconds );
+               ret = xmlTextReaderRead( reader );
                continue;
             }
-
             /* Ship info. */
-            if (xml_isNode(node, "ship")) {
-               xmlr_attr_strd(node, "name", save->shipname);
-               xmlr_attr_strd(node, "model", save->shipmodel);
-               continue;
+            else if (strcmp(name, "ship")==0) {
+               save->shipname  = load_readerAttr( reader, "name" );
+               save->shipmodel = load_readerAttr( reader, "model" );
             }
-         } while (xml_nextNode(node));
+         }
+         ret = xmlTextReaderNext( reader );
          continue;
       }
-      else if (xml_isNode(parent, "plugins")) {
-         save->plugins = array_create( char* );
-         /* Parse rest. */
-         node = parent->xmlChildrenNode;
-         do {
-            xml_onlyNodes(node);
-
-            if (xml_isNode(node, "plugin")) {
-               const char *name = xml_get(node);
-               if (name != NULL)
-                  array_push_back( &save->plugins, strdup(name) );
-               else
-                  WARN(_("Save '%s' has unnamed plugin node!"), path);
-            }
-         } while (xml_nextNode(node));
+
+      /* Time. */
+      else if ((depth == 3) && hastime && (section != NULL) && (strcmp(section, "player")==0)) {
+         char *str = load_readerText( reader );
+         int val = (str != NULL) ? atoi( str ) : 0;
+         if (strcmp(name, "SCU")==0)
+            cycles = val;
+         else if (strcmp(name, "STP")==0)
+            periods = val;
+         else if (strcmp(name, "STU")==0)
+            seconds = val;
+         free( str );
+         ret = xmlTextReaderNext( reader );
          continue;
       }
-   } while (xml_nextNode(parent));
+
+      ret = xmlTextReaderRead( reader );
+   }
+   if (ret < 0) {
+      WARN( _("Unable to parse save path '%s'."), path);
+      xmlFreeTextReader( reader );
+      load_freeSave( save );
+      return -1;
+   }
+   xmlFreeTextReader( reader );
+
+   if (hastime)
+      save->date = ntime_create( cycles, periods, seconds );
 
    /* Defaults. */
    if (save->chapter==NULL)
@@ -221,9 +401,6 @@ static int load_load( nsave_t *save, const char *path )
 
    save->compatible = load_compatibility( save );
 
-   /* Clean up. */
-   xmlFreeDoc(doc);
-
    return 0;
 }
 
@@ -261,7 +438,13 @@ static int load_enumerateCallbackPlayer( void* data, const char* origdir, const
    else if (stat.filetype == PHYSFS_FILETYPE_REGULAR) {
       player_saves_t *ps = (player_saves_t*) data;
       nsave_t ns;
-      int ret = load_load( &ns, path );
+      int ret;
+      /* Skip anything that is not a save, like partially written ones. */
+      if (!ndata_matchExt( fname, "ns" )) {
+         free( path );
+         return PHYSFS_ENUM_OK;
+      }
+      ret = load_load( &ns, path );
       if (ret == 0) {
          ns.save_name = strdup( fname );
          ns.save_name[ strlen(ns.save_name)-3 ] = '\0';
@@ -447,6 +630,27 @@ static int load_sortCompare( const void *p1, const void *p2 )
    return strcmp( ns1->save_name, ns2->save_name );
 }
 
+/**
+ * @brief Frees the contents of a single save.
+ */
+static void load_freeSave( nsave_t *ns )
+{
+   for (int k=0; k<array_size(ns->plugins); k++)
+      free( ns->plugins[k] );
+   array_free( ns->plugins );
+   free(ns->save_name);
+   free(ns->player_name);
+   free(ns->path);
+   free(ns->version);
+   free(ns->data);
+   free(ns->spob);
+   free(ns->chapter);
+   free(ns->difficulty);
+   free(ns->shipname);
+   free(ns->shipmodel);
+   memset( ns, 0, sizeof(nsave_t) );
+}
+
 /**
  * @brief Frees loaded save stuff.
  */
@@ -455,22 +659,8 @@ void load_free (void)
    for (int i=0; i<array_size(load_saves); i++) {
       player_saves_t *ps = &load_saves[i];
       free( ps->name );
-      for (int j=0; j<array_size(ps->saves); j++) {
-         nsave_t *ns = &ps->saves[j];
-         for (int k=0; k<array_size(ns->plugins); k++)
-            free( ns->plugins[k] );
-         array_free( ns->plugins );
-         free(ns->save_name);
-         free(ns->player_name);
-         free(ns->path);
-         free(ns->version);
-         free(ns->data);
-         free(ns->spob);
-         free(ns->chapter);
-         free(ns->difficulty);
-         free(ns->shipname);
-         free(ns->shipmodel);
-      }
+      for (int j=0; j<array_size(ps->saves); j++)
+         load_freeSave( &ps->saves[j] );
       array_free( ps->saves );
    }
    array_free( load_saves );
@@ -1053,8 +1243,7 @@ static void load_compatSlots (void)
  */
 int load_gameDiff( const char* file )
 {
-   xmlNodePtr node;
-   xmlDocPtr doc;
+   LoadSections ls;
 
    /* Make sure it exists. */
    if (!PHYSFS_exists( file )) {
@@ -1062,27 +1251,19 @@ int load_gameDiff( const char* file )
       return -1;
    }
 
-   /* Load the XML. */
-   doc = load_xml_parsePhysFS( file );
-   if (doc == NULL)
-      goto err;
-   node  = doc->xmlChildrenNode; /* base node */
-   if (node == NULL)
-      goto err_doc;
+   /* Open the saved game. */
+   if (load_sectionsOpen( &ls, file )) {
+      WARN( _("Saved game '%s' invalid!"), file);
+      return -1;
+   }
 
    /* Diffs should be cleared automatically first. */
-   diff_load(node);
+   diff_load( load_section( &ls, SAVE_CHUNK_DIFF ) );
 
    /* Free. */
-   xmlFreeDoc(doc);
+   load_sectionsClose( &ls );
 
    return 0;
-
-err_doc:
-   xmlFreeDoc(doc);
-err:
-   WARN( _("Saved game '%s' invalid!"), file);
-   return -1;
 }
 
 /**
@@ -1152,8 +1333,7 @@ static int load_gameInternal( const char* file, const char* version )
  */
 static int load_gameInternalHook( void *data )
 {
-   xmlNodePtr node;
-   xmlDocPtr doc;
+   LoadSections ls;
    Spob *pnt;
    const char **sdata = data;
    const char *file = sdata[0];
@@ -1161,13 +1341,9 @@ static int load_gameInternalHook( void *data )
    int version_diff = (version!=NULL) ? naev_versionCompare(version) : 0;
    free(data);
 
-   /* Load the XML. */
-   doc = load_xml_parsePhysFS( file );
-   if (doc == NULL)
+   /* Open the saved game, sections are parsed as they are loaded. */
+   if (load_sectionsOpen( &ls, file ))
       goto err;
-   node  = doc->xmlChildrenNode; /* base node */
-   if (node == NULL)
-      goto err_doc;
 
    /* Clean up possible stuff that should be cleaned. */
    unidiff_universeDefer( 1 );
@@ -1178,11 +1354,11 @@ static int load_gameInternalHook( void *data )
    player_message( "#g v%s", naev_version(0) );
 
    /* Now begin to load. */
-   diff_load(node); /* Must load first to work properly. */
+   diff_load( load_section( &ls, SAVE_CHUNK_DIFF ) ); /* Must load first to work properly. */
    unidiff_universeDefer( 0 );
-   missions_loadCommodity(node); /* Must be loaded before player. */
-   pfaction_load(node); /* Must be loaded before player so the messages show up properly. */
-   pnt = player_load(node);
+   missions_loadCommodity( load_section( &ls, SAVE_CHUNK_MISSIONS ) ); /* Must be loaded before player. */
+   pfaction_load( load_section( &ls, SAVE_CHUNK_FACTIONS ) ); /* Must be loaded before player so the messages show up properly. */
+   pnt = player_load( load_section( &ls, SAVE_CHUNK_PLAYER ) );
    player.loaded_version = strdup( (version!=NULL) ? version : naev_version(0) );
 
    /* Sanitize for new version. */
@@ -1192,20 +1368,23 @@ static int load_gameInternalHook( void *data )
    }
 
    /* Load more stuff. */
-   space_sysLoad(node);
-   var_load(node);
-   missions_loadActive(node);
-   events_loadActive(node);
-   news_loadArticles( node );
-   hook_load(node);
+   space_sysLoad( load_section( &ls, SAVE_CHUNK_SPACE ) );
+   var_load( load_section( &ls, SAVE_CHUNK_VARS ) );
+   missions_loadActive( load_section( &ls, SAVE_CHUNK_MISSIONS ) );
+   events_loadActive( load_section( &ls, SAVE_CHUNK_EVENTS ) );
+   news_loadArticles( load_section( &ls, SAVE_CHUNK_NEWS ) );
+   hook_load( load_section( &ls, SAVE_CHUNK_HOOKS ) );
 
    /* Initialize the economy. */
    economy_init();
-   economy_sysLoad(node);
+   economy_sysLoad( load_section( &ls, SAVE_CHUNK_ECONOMY ) );
 
    /* Initialise the ship log */
    shiplog_new();
-   shiplog_load(node);
+   shiplog_load( load_section( &ls, SAVE_CHUNK_SHIPLOG ) );
+
+   /* Done with the saved game. */
+   load_sectionsClose( &ls );
 
    /* Check validity. */
    event_checkValidity();
@@ -1229,15 +1408,14 @@ static int load_gameInternalHook( void *data )
    gui_setCargo();
    gui_setShip();
 
-   xmlFreeDoc(doc);
-
    /* Set loaded. */
    save_loaded = 1;
 
+   /* Replays start from a freshly loaded game. */
+   replay_start( file );
+
    return 0;
 
-err_doc:
-   xmlFreeDoc(doc);
 err:
    dialogue_alert( _("Saved game '%s' invalid!"), file);
    menu_main();
@@ -1251,5 +1429,104 @@ static xmlDocPtr load_xml_parsePhysFS( const char* filename )
 {
    char buf[PATH_MAX];
    snprintf( buf, sizeof(buf), "%s/%s", PHYSFS_getWriteDir(), filename );
-   return xmlParseFile( buf );
+   /* Saves of long games can be large, don't let libxml2 refuse them. */
+   return xmlReadFile( buf, NULL, XML_PARSE_HUGE | XML_PARSE_COMPACT );
+}
+
+/**
+ * @brief Opens a saved game to load its sections.
+ *
+ * Chunked saves are only checked to have all the sections, they are parsed one
+ * at a time with load_section(). XML saves are parsed whole.
+ *
+ *    @param[out] ls Sections to set up.
+ *    @param file PhysicsFS path (i.e., relative path starting with "saves/").
+ *    @return 0 on success.
+ */
+static int load_sectionsOpen( LoadSections *ls, const char *file )
+{
+   const char *chunks[] = { SAVE_CHUNK_HEAD, SAVE_CHUNK_DIFF, SAVE_CHUNK_PLAYER,
+      SAVE_CHUNK_MISSIONS, SAVE_CHUNK_EVENTS, SAVE_CHUNK_NEWS, SAVE_CHUNK_VARS,
+      SAVE_CHUNK_FACTIONS, SAVE_CHUNK_HOOKS, SAVE_CHUNK_SPACE,
+      SAVE_CHUNK_ECONOMY, SAVE_CHUNK_SHIPLOG };
+
+   memset( ls, 0, sizeof(LoadSections) );
+
+   /* XML saved game. */
+   if (!savefile_isChunked( file )) {
+      ls->doc = load_xml_parsePhysFS( file );
+      if (ls->doc == NULL)
+         return -1;
+      if (ls->doc->xmlChildrenNode == NULL) {
+         load_sectionsClose( ls );
+         return -1;
+      }
+      return 0;
+   }
+
+   /* Chunked saved game. */
+   ls->sf = savefile_open( file );
+   if (ls->sf == NULL)
+      return -1;
+   for (size_t i=0; i<sizeof(chunks)/sizeof(chunks[0]); i++) {
+      if (!savefile_has( ls->sf, chunks[i] )) {
+         WARN(_("Saved game '%s' is missing the '%s' chunk!"), file, chunks[i]);
+         load_sectionsClose( ls );
+         return -1;
+      }
+   }
+   return 0;
+}
+
+/**
+ * @brief Gets the node to pass to a subsystem loader.
+ *
+ * For chunked saves this parses the chunk on its own, freeing the previous
+ * one, so there is never more than one section in memory. Unreadable chunks
+ * are loaded as empty sections.
+ *
+ *    @param ls Sections of the saved game.
+ *    @param chunk Chunk of the section to get.
+ *    @return Node to pass to the loader of the section.
+ */
+static xmlNodePtr load_section( LoadSections *ls, const char *chunk )
+{
+   uint32_t version;
+   size_t len;
+   char *data;
+
+   if (ls->sf == NULL)
+      return ls->doc->xmlChildrenNode;
+
+   if (ls->doc != NULL)
+      xmlFreeDoc( ls->doc );
+   ls->doc = NULL;
+
+   data = savefile_read( ls->sf, chunk, &version, &len );
+   if (data != NULL) {
+      if (version > SAVE_CHUNK_VERSION)
+         WARN(_("The '%s' chunk of the saved game is from a newer version (%u > %u)!"),
+               chunk, version, SAVE_CHUNK_VERSION);
+      ls->doc = xmlReadMemory( data, len, NULL, NULL, XML_PARSE_HUGE | XML_PARSE_COMPACT );
+      free( data );
+   }
+   if ((ls->doc == NULL) || (ls->doc->xmlChildrenNode == NULL)) {
+      WARN(_("Unable to load the '%s' chunk of the saved game!"), chunk);
+      if (ls->doc != NULL)
+         xmlFreeDoc( ls->doc );
+      ls->doc = xmlNewDoc( (const xmlChar*)"1.0" );
+      xmlDocSetRootElement( ls->doc, xmlNewNode( NULL, (const xmlChar*)"naev_save" ) );
+   }
+   return ls->doc->xmlChildrenNode;
+}
+
+/**
+ * @brief Frees the sections of a saved game.
+ */
+static void load_sectionsClose( LoadSections *ls )
+{
+   if (ls->doc != NULL)
+      xmlFreeDoc( ls->doc );
+   savefile_free( ls->sf );
+   memset( ls, 0, sizeof(LoadSections) );
 }
@@ -4,6 +4,7 @@
 /** @cond */
 #include <float.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -29,6 +30,7 @@
 #include "nstring.h"
 #include "nxml.h"
 #include "opengl.h"
+#include "opengl_vbo.h"
 #include "player.h"
 #include "space.h"
 #include "toolkit.h"
@@ -41,6 +43,9 @@
 #define MAP_MARKER_CYCLE  750 /**< Time of a mission marker's animation cycle in milliseconds. */
 #define MAP_MOVE_THRESHOLD 20. /**< Mouse movement distance threshold */
 #define EASE_ALPHA   ease_QuadraticInOut /**< Ease function for alpha. */
+#define MAP_LANE_VERTEX_SIZE  15 /**< Floats per lane vertex: corner(2), lane(4), colour(4), end colour(4), width(1). */
+#define MAP_DISK_VERTEX_SIZE  10 /**< Floats per disk vertex: corner(2), centre(2), disk(2), colour(4). */
+#define MAP_NAME_MARGIN       300. /**< Screen space allowed for system names when culling them. */
 
 static const int RCOL_X = -10;         /**< Position of text in the right column. */
 static const int RCOL_TEXT_W = 135;    /**< Width of normal text in the right column. */
@@ -81,9 +86,29 @@ typedef struct CstMapWidget_ {
    MapMode mode;           /**< Default map mode. */
 } CstMapWidget;
 
+/**
+ * @brief Map geometry drawn with a single call and only rebuilt when the
+ *        state it depends on changes.
+ *
+ * Vertices are in map coordinates, the offset and zoom are uniforms, so
+ * panning and zooming do not touch the geometry.
+ */
+typedef struct MapGeometry_ {
+   int valid;        /**< Whether the geometry has been built. */
+   uint32_t hash;    /**< Hash of the state the geometry was built from. */
+   GLfloat *data;    /**< Array (array.h): Vertex data. */
+   int n;            /**< Number of vertices. */
+   gl_vbo *vbo;      /**< Vertex buffer. */
+   GLsizei vbo_size; /**< Size of the vertex buffer in bytes. */
+} MapGeometry;
+
 /* map decorator stack */
 static MapDecorator* decorator_stack = NULL; /**< Contains all the map decorators. */
 
+static MapGeometry map_lanes = { .valid = 0 }; /**< Jump lane geometry. */
+static MapGeometry map_disks = { .valid = 0 }; /**< System disk geometry. */
+static int *map_visible = NULL; /**< Array (array.h): Buffer of systems in the visible area. */
+
 static int map_selected       = -1;     /**< What system is selected on the map. */
 static MapMode map_mode       = MAPMODE_TRAVEL; /**< Default map mode. */
 static StarSystem **map_path  = NULL;   /**< Array (array.h): The path to current selected system. */
@@ -133,6 +158,11 @@ static int map_mouse( unsigned int wid, SDL_Event* event, double mx, double my,
       double w, double h, double rx, double ry, void *data );
 /* Misc. */
 static void map_setup (void);
+static uint32_t map_geometryHash( int mode );
+static void map_geometryQuad( MapGeometry *g, const GLfloat *attr, int nattr );
+static void map_geometryUpload( MapGeometry *g );
+static void map_geometryFree( MapGeometry *g );
+static int map_pickFilter( const StarSystem *sys );
 static void map_updateInternal( CstMapWidget *cst, double dt );
 static void map_reset( CstMapWidget* cst, MapMode mode );
 static CstMapWidget* map_globalCustomData( unsigned int wid );
@@ -163,6 +193,11 @@ int map_init (void)
  */
 void map_exit (void)
 {
+   map_geometryFree( &map_lanes );
+   map_geometryFree( &map_disks );
+   array_free( map_visible );
+   map_visible = NULL;
+
    if (decorator_stack != NULL) {
       for (int i=0; i<array_size(decorator_stack); i++)
          gl_freeTexture( decorator_stack[i].image );
@@ -189,6 +224,7 @@ static int map_keyHandler( unsigned int wid, SDL_Keycode key, SDL_Keymod mod )
 static void map_setup (void)
 {
    /* Mark systems as discovered as necessary. */
+   spob_luaHold();
    for (int i=0; i<array_size(systems_stack); i++) {
       StarSystem *sys = &systems_stack[i];
       sys_rmFlag( sys, SYSTEM_DISCOVERED | SYSTEM_INTEREST );
@@ -231,6 +267,7 @@ static void map_setup (void)
       if (known)
          sys_setFlag( sys, SYSTEM_DISCOVERED );
    }
+   spob_luaRelease();
 
    /* mark systems as needed */
    mission_sysMark();
@@ -701,6 +738,7 @@ static void map_update( unsigned int wid )
    hasSpobs = 0;
    p = 0;
    buf[0] = '\0';
+   spob_luaHold();
    for (int i=0; i<array_size(sys->spobs); i++) {
       const char *prefix, *suffix;
       Spob *s = sys->spobs[i];
@@ -723,6 +761,7 @@ static void map_update( unsigned int wid )
                t, prefix, spob_name( s ), suffix );
       hasSpobs = 1;
    }
+   spob_luaRelease();
    if (hasSpobs == 0) {
       strncpy( buf, _("None"), sizeof(buf)-1 );
       buf[sizeof(buf)-1] = '\0';
@@ -1243,12 +1282,122 @@ void map_renderSystemEnvironment( double x, double y, double zoom, int editor, d
 }
 
 /**
- * @brief Renders the jump routes between systems.
+ * @brief Mixes a value into a hash.
  */
-void map_renderJumps( double x, double y, double zoom, double radius, int editor )
+static inline uint32_t map_hashMix( uint32_t h, uint32_t v )
+{
+   return (h ^ v) * 16777619u;
+}
+
+/**
+ * @brief Mixes a position into a hash.
+ */
+static inline uint32_t map_hashPos( uint32_t h, const vec2 *v )
+{
+   float f[2] = { v->x, v->y };
+   uint32_t u[2];
+   memcpy( u, f, sizeof(u) );
+   return map_hashMix( map_hashMix( h, u[0] ), u[1] );
+}
+
+/**
+ * @brief Hashes all the state the cached map geometry depends on.
+ *
+ * Walking the flags is far cheaper than rebuilding and drawing the geometry,
+ * so this lets the geometry follow anything that changes system or jump
+ * state (diffs, discoveries, markers, standings, the editor) without every
+ * one of them having to invalidate the map.
+ *
+ *    @param mode Map mode to hash, different modes build different geometry.
+ */
+static uint32_t map_geometryHash( int mode )
+{
+   uint32_t h = 2166136261u;
+   h = map_hashMix( h, mode );
+   h = map_hashMix( h, array_size(systems_stack) );
+   for (int i=0; i<array_size(systems_stack); i++) {
+      const StarSystem *sys = &systems_stack[i];
+      h = map_hashMix( h, sys->flags );
+      h = map_hashMix( h, sys->faction );
+      if (sys->faction >= 0)
+         h = map_hashMix( h, areEnemies( FACTION_PLAYER, sys->faction ) |
+               (areAllies( FACTION_PLAYER, sys->faction ) << 1) );
+      h = map_hashMix( h, system_hasSpob( sys ) );
+      h = map_hashPos( h, &sys->pos );
+      for (int j=0; j<array_size(sys->jumps); j++) {
+         const JumpPoint *jp = &sys->jumps[j];
+         h = map_hashMix( h, jp->targetid );
+         h = map_hashMix( h, jp->flags );
+         h = map_hashMix( h, jp->hide<=0. );
+      }
+   }
+   return h;
+}
+
+/**
+ * @brief Adds a quad (as two triangles) to map geometry.
+ *
+ *    @param g Geometry to add to.
+ *    @param attr Per-vertex attributes following the corner.
+ *    @param nattr Number of attributes.
+ */
+static void map_geometryQuad( MapGeometry *g, const GLfloat *attr, int nattr )
+{
+   const GLfloat corners[6][2] = {
+      {-1., -1.}, { 1., -1.}, {-1.,  1.},
+      { 1., -1.}, { 1.,  1.}, {-1.,  1.} };
+   for (int i=0; i<6; i++) {
+      array_push_back( &g->data, corners[i][0] );
+      array_push_back( &g->data, corners[i][1] );
+      for (int j=0; j<nattr; j++)
+         array_push_back( &g->data, attr[j] );
+   }
+   g->n += 6;
+}
+
+/**
+ * @brief Uploads map geometry to its vertex buffer.
+ */
+static void map_geometryUpload( MapGeometry *g )
+{
+   GLsizei size = array_size(g->data) * sizeof(GLfloat);
+   if (size <= 0)
+      return;
+   if (g->vbo == NULL) {
+      g->vbo = gl_vboCreateStatic( size, g->data );
+      g->vbo_size = size;
+   }
+   else if (size > g->vbo_size) {
+      gl_vboData( g->vbo, size, g->data );
+      g->vbo_size = size;
+   }
+   else
+      gl_vboSubData( g->vbo, 0, size, g->data );
+}
+
+/**
+ * @brief Frees map geometry.
+ */
+static void map_geometryFree( MapGeometry *g )
 {
+   gl_vboDestroy( g->vbo );
+   array_free( g->data );
+   memset( g, 0, sizeof(MapGeometry) );
+}
+
+/**
+ * @brief Builds the jump lane geometry.
+ */
+static void map_buildJumps( int editor )
+{
+   MapGeometry *g = &map_lanes;
+
+   if (g->data == NULL)
+      g->data = array_create( GLfloat );
+   array_resize( &g->data, 0 );
+   g->n = 0;
+
    for (int i=0; i<array_size(systems_stack); i++) {
-      double x1,y1;
       StarSystem *sys = system_getIndex( i );
 
       if (sys_isFlag(sys,SYSTEM_HIDDEN))
@@ -1257,12 +1406,9 @@ void map_renderJumps( double x, double y, double zoom, double radius, int editor
       if (!sys_isKnown(sys) && !editor)
          continue; /* we don't draw hyperspace lines */
 
-      x1 = x + sys->pos.x * zoom;
-      y1 = y + sys->pos.y * zoom;
-
       for (int j=0; j < array_size(sys->jumps); j++) {
-         double x2,y2, rx,ry, r, rw,rh;
          const glColour *col, *cole;
+         GLfloat attr[MAP_LANE_VERTEX_SIZE-2];
          StarSystem *jsys = sys->jumps[j].target;
          if (sys_isFlag(jsys,SYSTEM_HIDDEN))
             continue;
@@ -1287,38 +1433,103 @@ void map_renderJumps( double x, double y, double zoom, double radius, int editor
          else
             col = &cAquaBlue;
 
-         x2 = x + jsys->pos.x * zoom;
-         y2 = y + jsys->pos.y * zoom;
-         rx = x2-x1;
-         ry = y2-y1;
-         r  = atan2( ry, rx );
-         rw = MOD(rx,ry)/2.;
-
+         attr[0] = sys->pos.x;
+         attr[1] = sys->pos.y;
+         attr[2] = jsys->pos.x;
+         attr[3] = jsys->pos.y;
          if (sys->jumps[j].hide<=0.) {
             col = &cGreen;
-            rh = 2.5;
+            attr[12] = 2.5;
          }
-         else {
-            rh = 1.5;
-         }
-
-         glUseProgram( shaders.jumplane.program );
-         gl_uniformColor( shaders.jumplane.paramv, cole );
-         glUniform1f( shaders.jumplane.paramf, radius );
-         gl_renderShader( (x1+x2)/2., (y1+y2)/2., rw, rh, r, &shaders.jumplane, col, 1 );
+         else
+            attr[12] = 1.5;
+         attr[4]  = col->r;
+         attr[5]  = col->g;
+         attr[6]  = col->b;
+         attr[7]  = col->a;
+         attr[8]  = cole->r;
+         attr[9]  = cole->g;
+         attr[10] = cole->b;
+         attr[11] = cole->a;
+         map_geometryQuad( g, attr, MAP_LANE_VERTEX_SIZE-2 );
       }
    }
+   map_geometryUpload( g );
 }
 
 /**
- * @brief Renders the systems.
+ * @brief Renders the jump routes between systems.
  */
-void map_renderSystems( double bx, double by, double x, double y,
-      double zoom, double w, double h, double r, MapMode mode )
+void map_renderJumps( double x, double y, double zoom, double radius, int editor )
+{
+   const GLsizei stride = sizeof(GLfloat) * MAP_LANE_VERTEX_SIZE;
+   MapGeometry *g = &map_lanes;
+   uint32_t hash = map_geometryHash( editor ? -1 : -2 );
+
+   if (!g->valid || (g->hash != hash)) {
+      map_buildJumps( editor );
+      g->hash  = hash;
+      g->valid = 1;
+   }
+   if (g->n <= 0)
+      return;
+
+   glUseProgram( shaders.map_jumplanes.program );
+   glEnableVertexAttribArray( shaders.map_jumplanes.vertex );
+   glEnableVertexAttribArray( shaders.map_jumplanes.vertex_lane );
+   glEnableVertexAttribArray( shaders.map_jumplanes.vertex_color );
+   glEnableVertexAttribArray( shaders.map_jumplanes.vertex_color2 );
+   glEnableVertexAttribArray( shaders.map_jumplanes.vertex_width );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_jumplanes.vertex,
+         0, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_jumplanes.vertex_lane,
+         sizeof(GLfloat)*2, 4, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_jumplanes.vertex_color,
+         sizeof(GLfloat)*6, 4, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_jumplanes.vertex_color2,
+         sizeof(GLfloat)*10, 4, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_jumplanes.vertex_width,
+         sizeof(GLfloat)*14, 1, GL_FLOAT, stride );
+   gl_uniformMat4( shaders.map_jumplanes.projection, &gl_view_matrix );
+   glUniform3f( shaders.map_jumplanes.view, x, y, zoom );
+   glUniform1f( shaders.map_jumplanes.radius, radius );
+
+   glDrawArrays( GL_TRIANGLES, 0, g->n );
+   gl_drawCalls++;
+
+   glDisableVertexAttribArray( shaders.map_jumplanes.vertex );
+   glDisableVertexAttribArray( shaders.map_jumplanes.vertex_lane );
+   glDisableVertexAttribArray( shaders.map_jumplanes.vertex_color );
+   glDisableVertexAttribArray( shaders.map_jumplanes.vertex_color2 );
+   glDisableVertexAttribArray( shaders.map_jumplanes.vertex_width );
+   glUseProgram(0);
+   gl_checkErr();
+}
+
+/**
+ * @brief Adds a system disk to the disk geometry.
+ */
+static void map_addDisk( const StarSystem *sys, double rmod, int filled, const glColour *c )
+{
+   const GLfloat attr[MAP_DISK_VERTEX_SIZE-2] = {
+      sys->pos.x, sys->pos.y, rmod, filled, c->r, c->g, c->b, c->a };
+   map_geometryQuad( &map_disks, attr, MAP_DISK_VERTEX_SIZE-2 );
+}
+
+/**
+ * @brief Builds the system disk geometry.
+ */
+static void map_buildSystems( MapMode mode )
 {
+   MapGeometry *g = &map_disks;
+
+   if (g->data == NULL)
+      g->data = array_create( GLfloat );
+   array_resize( &g->data, 0 );
+   g->n = 0;
+
    for (int i=0; i<array_size(systems_stack); i++) {
       const glColour *col;
-      double tx, ty;
       StarSystem *sys = system_getIndex( i );
 
       if (sys_isFlag(sys,SYSTEM_HIDDEN))
@@ -1329,16 +1540,9 @@ void map_renderSystems( double bx, double by, double x, double y,
            && !space_sysReachable(sys)) && mode != MAPMODE_EDITOR)
          continue;
 
-      tx = x + sys->pos.x*zoom;
-      ty = y + sys->pos.y*zoom;
-
-      /* Skip if out of bounds. */
-      if (!rectOverlap(tx-r, ty-r, 2.*r, 2.*r, bx, by, w, h))
-         continue;
-
       /* Draw an outer ring. */
       if (mode == MAPMODE_EDITOR || mode == MAPMODE_TRAVEL || mode == MAPMODE_TRADE)
-         gl_renderCircle( tx, ty, r, &cInert, 0 );
+         map_addDisk( sys, 1., 0, &cInert );
 
       /* Ignore not known systems when not in the editor. */
       if (mode != MAPMODE_EDITOR && !sys_isKnown(sys))
@@ -1365,19 +1569,69 @@ void map_renderSystems( double bx, double by, double x, double y,
          else
             col = &cNeutral;
 
-         if (mode == MAPMODE_EDITOR) {
-            /* Radius slightly shorter. */
-            gl_renderCircle( tx, ty, 0.5 * r, col, 1 );
-         }
-         else
-            gl_renderCircle( tx, ty, 0.65 * r, col, 1 );
+         /* Radius slightly shorter in the editor. */
+         map_addDisk( sys, (mode == MAPMODE_EDITOR) ? 0.5 : 0.65, 1, col );
       }
       else if (mode == MAPMODE_DISCOVER) {
-         gl_renderCircle( tx, ty, r, &cInert, 0 );
+         map_addDisk( sys, 1., 0, &cInert );
          if (sys_isFlag( sys, SYSTEM_DISCOVERED ))
-            gl_renderCircle( tx, ty,  0.65 * r, &cGreen, 1 );
+            map_addDisk( sys, 0.65, 1, &cGreen );
       }
    }
+   map_geometryUpload( g );
+}
+
+/**
+ * @brief Renders the systems.
+ *
+ * Systems outside the widget are clipped by the widget, so everything is
+ * drawn in a single call.
+ */
+void map_renderSystems( double bx, double by, double x, double y,
+      double zoom, double w, double h, double r, MapMode mode )
+{
+   (void) bx;
+   (void) by;
+   (void) w;
+   (void) h;
+   const GLsizei stride = sizeof(GLfloat) * MAP_DISK_VERTEX_SIZE;
+   MapGeometry *g = &map_disks;
+   uint32_t hash = map_geometryHash( mode );
+
+   if (!g->valid || (g->hash != hash)) {
+      map_buildSystems( mode );
+      g->hash  = hash;
+      g->valid = 1;
+   }
+   if (g->n <= 0)
+      return;
+
+   glUseProgram( shaders.map_systems.program );
+   glEnableVertexAttribArray( shaders.map_systems.vertex );
+   glEnableVertexAttribArray( shaders.map_systems.vertex_center );
+   glEnableVertexAttribArray( shaders.map_systems.vertex_disk );
+   glEnableVertexAttribArray( shaders.map_systems.vertex_color );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_systems.vertex,
+         0, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_systems.vertex_center,
+         sizeof(GLfloat)*2, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_systems.vertex_disk,
+         sizeof(GLfloat)*4, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( g->vbo, shaders.map_systems.vertex_color,
+         sizeof(GLfloat)*6, 4, GL_FLOAT, stride );
+   gl_uniformMat4( shaders.map_systems.projection, &gl_view_matrix );
+   glUniform3f( shaders.map_systems.view, x, y, zoom );
+   glUniform1f( shaders.map_systems.radius, r );
+
+   glDrawArrays( GL_TRIANGLES, 0, g->n );
+   gl_drawCalls++;
+
+   glDisableVertexAttribArray( shaders.map_systems.vertex );
+   glDisableVertexAttribArray( shaders.map_systems.vertex_center );
+   glDisableVertexAttribArray( shaders.map_systems.vertex_disk );
+   glDisableVertexAttribArray( shaders.map_systems.vertex_color );
+   glUseProgram(0);
+   gl_checkErr();
 }
 
 /**
@@ -1505,8 +1759,13 @@ void map_renderNames( double bx, double by, double x, double y,
    if (zoom <= 0.5)
       return;
 
-   for (int i=0; i<array_size(systems_stack); i++) {
-      StarSystem *sys = system_getIndex( i );
+   /* Only look at the systems that can be in view, names go to the right. */
+   font = (zoom >= 1.5) ? &gl_defFont : &gl_smallFont;
+   map_visible = space_sysInRect( map_visible,
+         (bx - x - MAP_NAME_MARGIN) / zoom, (by - y - font->h) / zoom,
+         (bx + w - x) / zoom, (by + h - y + font->h) / zoom );
+   for (int i=0; i<array_size(map_visible); i++) {
+      StarSystem *sys = system_getIndex( map_visible[i] );
 
       if (sys_isFlag(sys,SYSTEM_HIDDEN))
          continue;
@@ -1515,8 +1774,6 @@ void map_renderNames( double bx, double by, double x, double y,
       if (!editor && !sys_isKnown(sys))
          continue;
 
-      font = (zoom >= 1.5) ? &gl_defFont : &gl_smallFont;
-
       textw = gl_printWidthRaw( font, _(sys->name) );
       tx = x + (sys->pos.x+12.) * zoom;
       ty = y + (sys->pos.y) * zoom - font->h*0.5;
@@ -1974,6 +2231,17 @@ static void map_focusLose( unsigned int wid, const char* wgtname )
    cst->drag = 0;
 }
 
+/**
+ * @brief Whether a system can be picked with the mouse.
+ */
+static int map_pickFilter( const StarSystem *sys )
+{
+   if (sys_isFlag(sys, SYSTEM_HIDDEN))
+      return 0;
+   /* must be reachable */
+   return (sys_isFlag(sys, SYSTEM_MARKED | SYSTEM_CMARKED) || space_sysReachable(sys));
+}
+
 /**
  * @brief Map custom widget mouse handling.
  *
@@ -1990,8 +2258,9 @@ static int map_mouse( unsigned int wid, SDL_Event* event, double mx, double my,
    (void) rx;
    (void) ry;
    CstMapWidget *cst = data;
+   StarSystem *sys;
 
-   const double t = 15.*15.; /* threshold */
+   const double t = 15.; /* threshold */
 
    switch (event->type) {
    case SDL_MOUSEWHEEL:
@@ -2015,32 +2284,15 @@ static int map_mouse( unsigned int wid, SDL_Event* event, double mx, double my,
       my -= h/2 - cst->ypos;
       cst->drag = 1;
 
-      for (int i=0; i<array_size(systems_stack); i++) {
-         double x, y;
-         StarSystem *sys = system_getIndex( i );
-
-         if (sys_isFlag(sys, SYSTEM_HIDDEN))
-            continue;
-
-         /* must be reachable */
-         if (!sys_isFlag(sys, SYSTEM_MARKED | SYSTEM_CMARKED)
-             && !space_sysReachable(sys))
-            continue;
-
-         /* get position */
-         x = sys->pos.x * cst->zoom;
-         y = sys->pos.y * cst->zoom;
-
-         if ((pow2(mx-x)+pow2(my-y)) < t) {
-            if (map_selected != -1) {
-               if (sys == system_getIndex( map_selected ) && sys_isKnown(sys)) {
-                  map_system_open( map_selected );
-                  cst->drag = 0;
-               }
+      sys = space_sysClosest( mx / cst->zoom, my / cst->zoom, t / cst->zoom, map_pickFilter );
+      if (sys != NULL) {
+         if (map_selected != -1) {
+            if (sys == system_getIndex( map_selected ) && sys_isKnown(sys)) {
+               map_system_open( map_selected );
+               cst->drag = 0;
             }
-            map_select( sys, (SDL_GetModState() & KMOD_SHIFT) );
-            break;
          }
+         map_select( sys, (SDL_GetModState() & KMOD_SHIFT) );
       }
       return 1;
 
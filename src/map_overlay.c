@@ -77,18 +77,57 @@ typedef struct OverlayBounds_s {
 } OverlayBounds_t;
 static OverlayBounds_t ovr_bounds;
 
+#define OVR_LAYOUT_SLACK   20. /**< Extra reach (px) given to labels for drifting while looking for neighbours. */
+
+/**
+ * @brief An object being laid out on the overlay.
+ */
+typedef struct OverlayItem_s {
+   const vec2 *pos;     /**< Position of the object. */
+   MapOverlayPos *mo;   /**< Layout data of the object. */
+   float radius;        /**< Radius before shrinking to fit. */
+   float x1;            /**< Left of the area the indicator and label can reach. */
+   float y1;            /**< Bottom of the area the indicator and label can reach. */
+   float x2;            /**< Right of the area the indicator and label can reach. */
+   float y2;            /**< Top of the area the indicator and label can reach. */
+   float off0x;         /**< Initial x offset of the label. */
+   float off0y;         /**< Initial y offset of the label. */
+   float offdx;         /**< X offset found by the optimization. */
+   float offdy;         /**< Y offset found by the optimization. */
+   float offbx;         /**< Buffer for the next x offset. */
+   float offby;         /**< Buffer for the next y offset. */
+   int adj;             /**< Start of the neighbours in ovr_contacts. */
+   int nadj;            /**< Number of neighbours (including itself). */
+} OverlayItem;
+
+/**
+ * @brief Dual variables (forces) between a label and a neighbouring object.
+ */
+typedef struct OverlayContact_s {
+   int j;         /**< Neighbouring item. */
+   float fx_obj;  /**< X force from the neighbour's indicator. */
+   float fy_obj;  /**< Y force from the neighbour's indicator. */
+   float fx_txt;  /**< X force from the neighbour's label. */
+   float fy_txt;  /**< Y force from the neighbour's label. */
+} OverlayContact;
+
+/* Layout buffers, kept between refreshes. */
+static OverlayItem *ovr_items = NULL; /**< Array (array.h): Objects being laid out. */
+static OverlayContact *ovr_contacts = NULL; /**< Array (array.h): Contacts between neighbouring objects. */
+static int *ovr_pairs = NULL; /**< Array (array.h): Pairs of neighbouring objects (flattened). */
+static int *ovr_order = NULL; /**< Array (array.h): Objects sorted by the left of their reach. */
+
 /*
  * Prototypes
  */
 static void force_collision( float *ox, float *oy,
       float x, float y, float w, float h,
       float mx, float my, float mw, float mh );
-static void ovr_optimizeLayout( int items, const vec2** pos,
-      MapOverlayPos** mo );
-static void ovr_refresh_uzawa_overlap( float *forces_x, float *forces_y,
-      float x, float y, float w, float h, const vec2** pos,
-      MapOverlayPos** mo, int items, int self,
-      float *offx, float *offy, float *offdx, float *offdy );
+static Uint32 ovr_layoutHash( int items );
+static void ovr_findNeighbours( int items );
+static void ovr_optimizeLayout( int items );
+static void ovr_refresh_uzawa_overlap( float x, float y, float w, float h, int self );
+static void ovr_layoutFree (void);
 /* Render. */
 static int ovr_safelaneKnown( SafeLane *sf, vec2 *posns[2] );
 static void map_overlayToScreenPos( double *ox, double *oy, double x, double y );
@@ -200,8 +239,7 @@ void ovr_refresh (void)
 {
    double max_x, max_y;
    int items, jumpitems;
-   const vec2 **pos;
-   MapOverlayPos **mo;
+   Uint32 hash;
    char buf[STRMAX_SHORT];
 
    /* Must be open. */
@@ -212,12 +250,13 @@ void ovr_refresh (void)
    ovr_boundsUpdate();
 
    /* Calculate max size. */
-   items = 0;
-   pos = calloc(array_size(cur_system->jumps) + array_size(cur_system->spobs), sizeof(vec2*));
-   mo  = calloc(array_size(cur_system->jumps) + array_size(cur_system->spobs), sizeof(MapOverlayPos*));
+   if (ovr_items == NULL)
+      ovr_items = array_create( OverlayItem );
+   array_resize( &ovr_items, 0 );
    max_x = 0.;
    max_y = 0.;
    for (int i=0; i<array_size(cur_system->jumps); i++) {
+      OverlayItem *it;
       JumpPoint *jp = &cur_system->jumps[i];
       max_x = MAX( max_x, ABS(jp->pos.x) );
       max_y = MAX( max_y, ABS(jp->pos.y) );
@@ -225,14 +264,15 @@ void ovr_refresh (void)
          continue;
       /* Initialize the map overlay stuff. */
       snprintf( buf, sizeof(buf), "%s%s", jump_getSymbol(jp), sys_isKnown(jp->target) ? _(jp->target->name) : _("Unknown") );
-      pos[items] = &jp->pos;
-      mo[items]  = &jp->mo;
-      mo[items]->radius = jumppoint_gfx->sw / 2.;
-      mo[items]->text_width = gl_printWidthRaw(&gl_smallFont, buf);
-      items++;
+      it = &array_grow( &ovr_items );
+      it->pos     = &jp->pos;
+      it->mo      = &jp->mo;
+      it->radius  = jumppoint_gfx->sw / 2.;
+      it->mo->text_width = gl_printWidthRaw(&gl_smallFont, buf);
    }
-   jumpitems = items;
+   jumpitems = array_size( ovr_items );
    for (int i=0; i<array_size(cur_system->spobs); i++) {
+      OverlayItem *it;
       Spob *pnt = cur_system->spobs[i];
       max_x = MAX( max_x, ABS(pnt->pos.x) );
       max_y = MAX( max_y, ABS(pnt->pos.y) );
@@ -240,37 +280,160 @@ void ovr_refresh (void)
          continue;
       /* Initialize the map overlay stuff. */
       snprintf( buf, sizeof(buf), "%s%s", spob_getSymbol(pnt), spob_name(pnt) );
-      pos[items] = &pnt->pos;
-      mo[items]  = &pnt->mo;
-      mo[items]->radius = pnt->radius / 2.;  /* halved since it's awkwardly large if drawn to scale relative to the player. */
+      it = &array_grow( &ovr_items );
+      it->pos     = &pnt->pos;
+      it->mo      = &pnt->mo;
+      it->radius  = pnt->radius / 2.;  /* halved since it's awkwardly large if drawn to scale relative to the player. */
       /* +2.0 represents a margin used by the SDF shader. */
-      mo[items]->text_width = gl_printWidthRaw( &gl_smallFont, buf );
-      items++;
+      it->mo->text_width = gl_printWidthRaw( &gl_smallFont, buf );
    }
+   items = array_size( ovr_items );
 
    /* We need to calculate the radius of the rendering from the maximum radius of the system. */
    ovr_res = 2. * 1.2 * MAX( max_x / ovr_bounds.w, max_y / ovr_bounds.h );
    ovr_res = MAX( ovr_res, 25. );
    for (int i=0; i<items; i++)
-      mo[i]->radius = MAX( 2.+mo[i]->radius / ovr_res, i<jumpitems ? 5. : 7.5 );
+      ovr_items[i].radius = MAX( 2.+ovr_items[i].radius / ovr_res, i<jumpitems ? 5. : 7.5 );
+
+   /* The layout only depends on the objects, resolution and font, so it can
+    * be reused when coming back to the system or reopening the overlay. */
+   hash = ovr_layoutHash( items );
+   if (cur_system->ovr_hash == hash)
+      return;
 
    /* Compute text overlap and try to minimize it. */
-   ovr_optimizeLayout( items, pos, mo );
+   ovr_optimizeLayout( items );
+   cur_system->ovr_hash = hash;
+}
+
+/**
+ * @brief Mixes a value into a layout hash.
+ */
+static inline Uint32 ovr_hashMix( Uint32 h, const void *data, size_t len )
+{
+   const unsigned char *c = data;
+   for (size_t i=0; i<len; i++) {
+      h ^= c[i];
+      h *= 16777619u;
+   }
+   return h;
+}
+
+/**
+ * @brief Hashes everything the overlay layout of the current objects depends on.
+ *
+ *    @param items Number of objects in ovr_items.
+ *    @return Hash of the layout inputs, never 0.
+ */
+static Uint32 ovr_layoutHash( int items )
+{
+   Uint32 h = 2166136261u;
+   h = ovr_hashMix( h, &items, sizeof(items) );
+   h = ovr_hashMix( h, &ovr_res, sizeof(ovr_res) );
+   h = ovr_hashMix( h, &gl_smallFont.h, sizeof(gl_smallFont.h) );
+   for (int i=0; i<items; i++) {
+      const OverlayItem *it = &ovr_items[i];
+      h = ovr_hashMix( h, &it->mo, sizeof(it->mo) );
+      h = ovr_hashMix( h, it->pos, sizeof(vec2) );
+      h = ovr_hashMix( h, &it->radius, sizeof(it->radius) );
+      h = ovr_hashMix( h, &it->mo->text_width, sizeof(it->mo->text_width) );
+   }
+   return (h==0) ? 1 : h;
+}
+
+/**
+ * @brief Compares overlay objects by the left of their reach.
+ */
+static int ovr_cmpReach( const void *p1, const void *p2 )
+{
+   const OverlayItem *i1 = &ovr_items[ *(const int*)p1 ];
+   const OverlayItem *i2 = &ovr_items[ *(const int*)p2 ];
+   if (i1->x1 < i2->x1)
+      return -1;
+   else if (i1->x1 > i2->x1)
+      return +1;
+   return 0;
+}
+
+/**
+ * @brief Finds the objects whose indicators and labels can interact.
+ *
+ * Every object gets a box containing its indicator and any place its label
+ * can be put, and a sweep over the boxes sorted along x finds the overlapping
+ * ones. Objects that can't touch get no contacts, which keeps the layout
+ * linear in the number of objects for the usual sparse systems.
+ *
+ *    @param items Number of objects in ovr_items.
+ */
+static void ovr_findNeighbours( int items )
+{
+   if (ovr_order == NULL) {
+      ovr_order    = array_create( int );
+      ovr_pairs    = array_create( int );
+      ovr_contacts = array_create( OverlayContact );
+   }
+   array_resize( &ovr_order, items );
+   array_resize( &ovr_pairs, 0 );
 
-   /* Free the moos. */
-   free( mo );
-   free( pos );
+   for (int i=0; i<items; i++) {
+      OverlayItem *it = &ovr_items[i];
+      float cx = it->pos->x / ovr_res;
+      float cy = it->pos->y / ovr_res;
+      float rx = it->radius + it->mo->text_width + 3.*ovr_text_pixbuf + OVR_LAYOUT_SLACK;
+      float ry = it->radius + gl_smallFont.h + 3.*ovr_text_pixbuf + OVR_LAYOUT_SLACK;
+      it->x1   = cx - rx;
+      it->x2   = cx + rx;
+      it->y1   = cy - ry;
+      it->y2   = cy + ry;
+      it->nadj = 1; /* Always interacts with itself. */
+      ovr_order[i] = i;
+   }
+   qsort( ovr_order, items, sizeof(int), ovr_cmpReach );
+
+   /* Sweep and prune. */
+   for (int a=0; a<items; a++) {
+      OverlayItem *ia = &ovr_items[ ovr_order[a] ];
+      for (int b=a+1; b<items; b++) {
+         OverlayItem *ib = &ovr_items[ ovr_order[b] ];
+         if (ib->x1 > ia->x2)
+            break;
+         if ((ib->y1 > ia->y2) || (ia->y1 > ib->y2))
+            continue;
+         array_push_back( &ovr_pairs, ovr_order[a] );
+         array_push_back( &ovr_pairs, ovr_order[b] );
+         ia->nadj++;
+         ib->nadj++;
+      }
+   }
+
+   /* Lay out the contacts of each object contiguously. */
+   array_resize( &ovr_contacts, items + array_size(ovr_pairs) );
+   memset( ovr_contacts, 0, array_size(ovr_contacts) * sizeof(OverlayContact) );
+   for (int i=0, n=0; i<items; i++) {
+      ovr_items[i].adj = n;
+      n += ovr_items[i].nadj;
+      ovr_items[i].nadj = 1;
+      ovr_contacts[ ovr_items[i].adj ].j = i;
+   }
+   for (int k=0; k<array_size(ovr_pairs); k+=2) {
+      int i = ovr_pairs[k];
+      int j = ovr_pairs[k+1];
+      ovr_contacts[ ovr_items[i].adj + ovr_items[i].nadj++ ].j = j;
+      ovr_contacts[ ovr_items[j].adj + ovr_items[j].nadj++ ].j = i;
+   }
 }
 
 /**
  * @brief Makes a best effort to fit the given spobs' overlay indicators and labels fit without collisions.
+ *
+ *    @param items Number of objects in ovr_items.
  */
-static void ovr_optimizeLayout( int items, const vec2** pos, MapOverlayPos** mo )
+static void ovr_optimizeLayout( int items )
 {
    float cx, cy, r, sx, sy;
    float x, y, w, h, mx, my, mw, mh;
    float fx, fy, best, bx, by;
-   float *forces_xa, *forces_ya, *off_buffx, *off_buffy, *off_0x, *off_0y, old_bx, old_by, *off_dx, *off_dy;
+   float old_bx, old_by;
 
    /* Parameters for the map overlay optimization. */
    const int max_iters = 15;    /**< Maximum amount of iterations to do. */
@@ -281,20 +444,27 @@ static void ovr_optimizeLayout( int items, const vec2** pos, MapOverlayPos** mo
    if (items <= 0)
       return;
 
+   /* Only neighbours can interact, so only look at them from here on. */
+   ovr_findNeighbours( items );
+   for (int i=0; i<items; i++)
+      ovr_items[i].mo->radius = ovr_items[i].radius;
+
    /* Fix radii which fit together. */
    MapOverlayRadiusConstraint cur, *fits = array_create(MapOverlayRadiusConstraint);
    uint8_t *must_shrink = malloc( items );
-   for (cur.i=0; cur.i<items; cur.i++)
-      for (cur.j=cur.i+1; cur.j<items; cur.j++) {
-         cur.dist = hypot( pos[cur.i]->x - pos[cur.j]->x, pos[cur.i]->y - pos[cur.j]->y ) / ovr_res;
-         if (cur.dist < mo[cur.i]->radius + mo[cur.j]->radius)
-            array_push_back( &fits, cur );
-      }
+   for (int k=0; k<array_size(ovr_pairs); k+=2) {
+      cur.i = MIN( ovr_pairs[k], ovr_pairs[k+1] );
+      cur.j = MAX( ovr_pairs[k], ovr_pairs[k+1] );
+      cur.dist = hypot( ovr_items[cur.i].pos->x - ovr_items[cur.j].pos->x,
+            ovr_items[cur.i].pos->y - ovr_items[cur.j].pos->y ) / ovr_res;
+      if (cur.dist < ovr_items[cur.i].mo->radius + ovr_items[cur.j].mo->radius)
+         array_push_back( &fits, cur );
+   }
    while (array_size( fits ) > 0) {
       float shrink_factor = 0.;
       memset( must_shrink, 0, items );
       for (int i=0; i < array_size( fits ); i++) {
-         r = fits[i].dist / (mo[fits[i].i]->radius + mo[fits[i].j]->radius);
+         r = fits[i].dist / (ovr_items[fits[i].i].mo->radius + ovr_items[fits[i].j].mo->radius);
          if (r >= 1)
             array_erase( &fits, &fits[i], &fits[i+1] );
          else {
@@ -304,32 +474,30 @@ static void ovr_optimizeLayout( int items, const vec2** pos, MapOverlayPos** mo
       }
       for (int i=0; i<items; i++)
          if (must_shrink[i])
-            mo[i]->radius *= shrink_factor;
+            ovr_items[i].mo->radius *= shrink_factor;
    }
    free( must_shrink );
    array_free( fits );
 
    /* Limit shrinkage. */
    for (int i=0; i<items; i++)
-      mo[i]->radius = MAX( mo[i]->radius, 4. );
-
-   /* Initialization offset list. */
-   off_0x = calloc( items, sizeof(float) );
-   off_0y = calloc( items, sizeof(float) );
+      ovr_items[i].mo->radius = MAX( ovr_items[i].mo->radius, 4. );
 
    /* Initialize all items. */
    for (int i=0; i<items; i++) {
+      OverlayItem *it = &ovr_items[i];
+      const MapOverlayPos *mo = it->mo;
       /* Test to see what side is best to put the text on.
        * We actually compute the text overlap also so hopefully it will alternate
        * sides when stuff is clustered together. */
 
-      x = pos[i]->x/ovr_res - ovr_text_pixbuf;
-      y = pos[i]->y/ovr_res - ovr_text_pixbuf;
-      w = mo[i]->text_width + 2.*ovr_text_pixbuf;
+      x = it->pos->x/ovr_res - ovr_text_pixbuf;
+      y = it->pos->y/ovr_res - ovr_text_pixbuf;
+      w = mo->text_width + 2.*ovr_text_pixbuf;
       h = gl_smallFont.h + 2.*ovr_text_pixbuf;
 
-      const float tx[4] = { mo[i]->radius+ovr_text_pixbuf+0.1, -mo[i]->radius-0.1-w, -mo[i]->text_width/2. , -mo[i]->text_width/2. };
-      const float ty[4] = { -gl_smallFont.h/2.,  -gl_smallFont.h/2., mo[i]->radius+ovr_text_pixbuf+0.1, -mo[i]->radius-0.1-h };
+      const float tx[4] = { mo->radius+ovr_text_pixbuf+0.1, -mo->radius-0.1-w, -mo->text_width/2. , -mo->text_width/2. };
+      const float ty[4] = { -gl_smallFont.h/2.,  -gl_smallFont.h/2., mo->radius+ovr_text_pixbuf+0.1, -mo->radius-0.1-h };
 
       /* Check all combinations. */
       bx = 0.;
@@ -339,12 +507,13 @@ static void ovr_optimizeLayout( int items, const vec2** pos, MapOverlayPos** mo
          double val = 0.;
 
          /* Test intersection with the spob indicators. */
-         for (int j=0; j<items; j++) {
+         for (int c=it->adj; c<it->adj+it->nadj; c++) {
+            const OverlayItem *jt = &ovr_items[ ovr_contacts[c].j ];
             fx = fy = 0.;
-            mw = 2.*mo[j]->radius;
+            mw = 2.*jt->mo->radius;
             mh = mw;
-            mx = pos[j]->x/ovr_res - mw/2.;
-            my = pos[j]->y/ovr_res - mh/2.;
+            mx = jt->pos->x/ovr_res - mw/2.;
+            my = jt->pos->y/ovr_res - mh/2.;
 
             force_collision( &fx, &fy, x+tx[k], y+ty[k], w, h, mx, my, mw, mh );
 
@@ -361,8 +530,10 @@ static void ovr_optimizeLayout( int items, const vec2** pos, MapOverlayPos** mo
       }
 
       /* Store offsets. */
-      off_0x[i] = bx;
-      off_0y[i] = by;
+      it->off0x = bx;
+      it->off0y = by;
+      it->offdx = it->offdy = 0.;
+      it->offbx = it->offby = 0.;
    }
 
    /* Uzawa optimization algorithm.
@@ -371,57 +542,46 @@ static void ovr_optimizeLayout( int items, const vec2** pos, MapOverlayPos** mo
     * As the algorithm is Uzawa, this constraint won't necessary be attained.
     * This is similar to a contact problem is mechanics. */
 
-   /* Initialize the matrix that stores the dual variables (forces applied between objects).
-    * matrix is column-major, this means it is interesting to store in each column the forces
-    * received by a given object. Then these forces are summed to obtain the total force on the object.
-    * Odd lines are forces from objects and Even lines from other texts. */
-
-   forces_xa = calloc( 2*items*items, sizeof(float) );
-   forces_ya = calloc( 2*items*items, sizeof(float) );
-
-   /* And buffer lists. */
-   off_buffx = calloc( items, sizeof(float) );
-   off_buffy = calloc( items, sizeof(float) );
-   off_dx    = calloc( items, sizeof(float) );
-   off_dy    = calloc( items, sizeof(float) );
+   /* The dual variables (forces applied between objects) are stored in the
+    * contacts of each object, the forces from the other indicators and texts
+    * are summed to obtain the total force on the object. */
 
    /* Main Uzawa Loop. */
    for (int iter=0; iter<max_iters; iter++) {
       double val = 0.; /* This stores the stagnation indicator. */
       for (int i=0; i<items; i++) {
-         cx = pos[i]->x / ovr_res;
-         cy = pos[i]->y / ovr_res;
+         OverlayItem *it = &ovr_items[i];
+         cx = it->pos->x / ovr_res;
+         cy = it->pos->y / ovr_res;
          /* Compute the forces. */
          ovr_refresh_uzawa_overlap(
-               forces_xa, forces_ya,
-               cx + off_dx[i] + off_0x[i] - ovr_text_pixbuf,
-               cy + off_dy[i] + off_0y[i] - ovr_text_pixbuf,
-               mo[i]->text_width + 2*ovr_text_pixbuf,
-               gl_smallFont.h + 2*ovr_text_pixbuf,
-               pos, mo, items, i, off_0x, off_0y, off_dx, off_dy );
+               cx + it->offdx + it->off0x - ovr_text_pixbuf,
+               cy + it->offdy + it->off0y - ovr_text_pixbuf,
+               it->mo->text_width + 2*ovr_text_pixbuf,
+               gl_smallFont.h + 2*ovr_text_pixbuf, i );
 
          /* Do the sum. */
          sx = sy = 0.;
-         for (int j=0; j<2*items; j++) {
-            sx += forces_xa[2*items*i+j];
-            sy += forces_ya[2*items*i+j];
+         for (int c=it->adj; c<it->adj+it->nadj; c++) {
+            sx += ovr_contacts[c].fx_obj + ovr_contacts[c].fx_txt;
+            sy += ovr_contacts[c].fy_obj + ovr_contacts[c].fy_txt;
          }
 
          /* Store old version of buffers. */
-         old_bx = off_buffx[i];
-         old_by = off_buffy[i];
+         old_bx = it->offbx;
+         old_by = it->offby;
 
          /* Update positions (in buffer). Diagonal stiffness. */
-         off_buffx[i] = kx * sx;
-         off_buffy[i] = ky * sy;
+         it->offbx = kx * sx;
+         it->offby = ky * sy;
 
-         val = MAX( val, ABS(old_bx-off_buffx[i]) + ABS(old_by-off_buffy[i]) );
+         val = MAX( val, ABS(old_bx-it->offbx) + ABS(old_by-it->offby) );
       }
 
       /* Offsets are actually updated once the first loop is over. */
       for (int i=0; i<items; i++) {
-         off_dx[i] = off_buffx[i];
-         off_dy[i] = off_buffy[i];
+         ovr_items[i].offdx = ovr_items[i].offbx;
+         ovr_items[i].offdy = ovr_items[i].offby;
       }
 
       /* Test stagnation. */
@@ -431,19 +591,24 @@ static void ovr_optimizeLayout( int items, const vec2** pos, MapOverlayPos** mo
 
    /* Permanently add the initialization offset to total offset. */
    for (int i=0; i<items; i++) {
-      mo[i]->text_offx = off_dx[i] + off_0x[i];
-      mo[i]->text_offy = off_dy[i] + off_0y[i];
+      ovr_items[i].mo->text_offx = ovr_items[i].offdx + ovr_items[i].off0x;
+      ovr_items[i].mo->text_offy = ovr_items[i].offdy + ovr_items[i].off0y;
    }
+}
 
-   /* Free the forces matrix and the various buffers. */
-   free( forces_xa );
-   free( forces_ya );
-   free( off_buffx );
-   free( off_buffy );
-   free( off_0x );
-   free( off_0y );
-   free( off_dx );
-   free( off_dy );
+/**
+ * @brief Frees the layout buffers.
+ */
+static void ovr_layoutFree (void)
+{
+   array_free( ovr_items );
+   ovr_items = NULL;
+   array_free( ovr_contacts );
+   ovr_contacts = NULL;
+   array_free( ovr_pairs );
+   ovr_pairs = NULL;
+   array_free( ovr_order );
+   ovr_order = NULL;
 }
 
 /**
@@ -489,31 +654,31 @@ static void force_collision( float *ox, float *oy,
 /**
  * @brief Compute how an element overlaps with text and force to move away.
  */
-static void ovr_refresh_uzawa_overlap( float *forces_x, float *forces_y,
-      float x, float y, float w, float h, const vec2** pos,
-      MapOverlayPos** mo, int items, int self,
-      float *offx, float *offy, float *offdx, float *offdy )
+static void ovr_refresh_uzawa_overlap( float x, float y, float w, float h, int self )
 {
-   for (int i=0; i<items; i++) {
+   const OverlayItem *it = &ovr_items[self];
+   for (int c=it->adj; c<it->adj+it->nadj; c++) {
       float mx, my, mw, mh;
       const float pb2 = ovr_text_pixbuf*2.;
+      OverlayContact *con = &ovr_contacts[c];
+      const OverlayItem *jt = &ovr_items[ con->j ];
 
-      /* Collisions with spob circles and jp triangles (odd indices). */
-      mw = 2.*mo[i]->radius;
+      /* Collisions with spob circles and jp triangles. */
+      mw = 2.*jt->mo->radius;
       mh = mw;
-      mx = pos[i]->x/ovr_res - mw/2.;
-      my = pos[i]->y/ovr_res - mh/2.;
-      force_collision( &forces_x[2*items*self+2*i+1], &forces_y[2*items*self+2*i+1], x, y, w, h, mx, my, mw, mh );
+      mx = jt->pos->x/ovr_res - mw/2.;
+      my = jt->pos->y/ovr_res - mh/2.;
+      force_collision( &con->fx_obj, &con->fy_obj, x, y, w, h, mx, my, mw, mh );
 
-      if (i == self)
+      if (con->j == self)
          continue;
 
-      /* Collisions with other texts (even indices) */
-      mw = mo[i]->text_width + pb2;
+      /* Collisions with other texts. */
+      mw = jt->mo->text_width + pb2;
       mh = gl_smallFont.h + pb2;
-      mx = pos[i]->x/ovr_res + offdx[i] + offx[i] - ovr_text_pixbuf;
-      my = pos[i]->y/ovr_res + offdy[i] + offy[i] - ovr_text_pixbuf;
-      force_collision( &forces_x[2*items*self+2*i], &forces_y[2*items*self+2*i], x, y, w, h, mx, my, mw, mh );
+      mx = jt->pos->x/ovr_res + jt->offdx + jt->off0x - ovr_text_pixbuf;
+      my = jt->pos->y/ovr_res + jt->offdy + jt->off0y - ovr_text_pixbuf;
+      force_collision( &con->fx_txt, &con->fy_txt, x, y, w, h, mx, my, mw, mh );
    }
 }
 
@@ -730,9 +895,12 @@ void ovr_render( double dt )
    if (player.p->nav_hyperspace > -1)
       gui_renderJumpPoint( player.p->nav_hyperspace, RADAR_RECT, w, h, res, cur_system->jumps[player.p->nav_hyperspace].map_alpha, 1 );
 
-   /* Render the asteroids */
+   /* Render the asteroids and pilots in a single batch. */
+   gui_radarBatchBegin();
    for (int i=0; i<array_size(cur_system->asteroids); i++) {
       AsteroidAnchor *ast = &cur_system->asteroids[i];
+      if (!pilot_inRangeAsteroidField( player.p, i ))
+         continue;
       for (int j=0; j<ast->nb; j++)
          gui_renderAsteroid( &ast->asteroids[j], w, h, res, 1 );
    }
@@ -748,6 +916,7 @@ void ovr_render( double dt )
       else
          gui_renderPilot( pstk[i], RADAR_RECT, w, h, res, 1 );
    }
+   gui_radarBatchEnd();
 
    /* Stealth rendering. */
    if (pilot_isFlag( player.p, PILOT_STEALTH )) {
@@ -913,6 +1082,9 @@ void ovr_mrkFree (void)
    ovr_markers = NULL;
    array_free( ovr_render_safelanes );
    ovr_render_safelanes = NULL;
+
+   /* Free layout buffers. */
+   ovr_layoutFree();
 }
 
 /**
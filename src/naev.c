@@ -44,6 +44,7 @@
 #include "gui.h"
 #include "hook.h"
 #include "input.h"
+#include "intern.h"
 #include "joystick.h"
 #include "land.h"
 #include "load.h"
@@ -68,6 +69,7 @@
 #include "nlua_vec2.h"
 #include "nlua_file.h"
 #include "nlua_data.h"
+#include "nmemory.h"
 #include "npc.h"
 #include "nstring.h"
 #include "nxml.h"
@@ -80,6 +82,7 @@
 #include "player.h"
 #include "plugin.h"
 #include "render.h"
+#include "replay.h"
 #include "rng.h"
 #include "safelanes.h"
 #include "semver.h"
@@ -116,6 +119,11 @@ static double fps_cur   = 0.; /**< FPS accumulator to trigger change. */
 static double fps_x     =  15.; /**< FPS X position. */
 static double fps_y     = -15.; /**< FPS Y position. */
 const double fps_min    = 1./30.; /**< Minimum fps to run at. */
+static Uint64 frame_start = 0; /**< Performance counter at the start of the frame's work. */
+static double gc_cur    = 0.; /**< Lua GC time accumulator. */
+static double gc_cur_max= 0.; /**< Lua GC time maximum accumulator. */
+static double gc_avg    = 0.; /**< Average Lua GC time per frame to display. */
+static double gc_max    = 0.; /**< Maximum Lua GC time per frame to display. */
 double elapsed_time_mod = 0.; /**< Elapsed modified time. */
 
 static nlua_env load_env = LUA_NOREF; /**< Environment for displaying load messages and stuff. */
@@ -136,6 +144,7 @@ static void window_caption (void);
 static void fps_init (void);
 static double fps_elapsed (void);
 static void fps_control (void);
+static void gc_step (void);
 static void update_all (void);
 /* Misc. */
 static void loadscreen_update( double done, const char *msg );
@@ -227,6 +236,9 @@ int main( int argc, char** argv )
       return -1;
    }
 
+   /* Memory accounting has to hook libxml2 before it's used. */
+   nmem_init();
+
    /* We'll be parsing XML. */
    LIBXML_TEST_VERSION
    xmlInitParser();
@@ -429,6 +441,12 @@ int main( int argc, char** argv )
             " And again, thank you for playing!"), conf.lastversion );
    }
 
+   /* Start recording or playing back a session if requested. */
+   if (conf.replay_play != NULL)
+      replay_play( conf.replay_play );
+   else if (conf.replay_record != NULL)
+      replay_record( conf.replay_record );
+
    /* primary loop */
    while (!quit) {
       while (!quit && SDL_PollEvent(&event)) { /* event loop */
@@ -450,9 +468,21 @@ int main( int argc, char** argv )
       main_loop( 1 );
    }
 
+   /* Finish the replay before anything is unloaded. */
+   replay_exit();
+
    /* Save configuration. */
    conf_saveConfig(conf_file_path);
 
+#if DEBUG_ALLOC
+   /* Report memory use before everything is freed. */
+   {
+      char buf[STRMAX];
+      nmem_report( buf, sizeof(buf) );
+      LOG( _("Memory use:\n%s"), buf );
+   }
+#endif /* DEBUG_ALLOC */
+
    /* data unloading */
    unload_all();
 
@@ -712,6 +742,7 @@ void unload_all (void)
    events_exit(); /* Clean up events. */
    factions_free();
    commodity_free();
+   intern_free(); /* after all the name maps are gone */
    var_cleanup(); /* cleans up mission variables */
    sp_cleanup();
 }
@@ -725,6 +756,11 @@ void main_loop( int update )
     * Control FPS.
     */
    fps_control(); /* everyone loves fps control */
+   frame_start = SDL_GetPerformanceCounter();
+
+   /* Replays run the recorded input and frame times instead of the real ones. */
+   replay_frame( &real_dt );
+   game_dt = real_dt * dt_mod;
 
    /*
     * Handle update.
@@ -756,6 +792,8 @@ void main_loop( int update )
                    Avoid rendering when quitting just in case. */
       /* Clear buffer. */
       render_all( game_dt, real_dt );
+      /* Use the idle time before the frame is due for Lua garbage collection. */
+      gc_step();
       /* Draw buffer. */
       SDL_GL_SwapWindow( gl_screen.window );
    }
@@ -883,8 +921,8 @@ static void fps_control (void)
    real_dt  = fps_elapsed();
    game_dt  = real_dt * dt_mod; /* Apply the modifier. */
 
-   /* if fps is limited */
-   if (!conf.vsync && conf.fps_max != 0) {
+   /* if fps is limited, replays run as fast as possible */
+   if (!conf.vsync && conf.fps_max != 0 && !replay_isPlaying()) {
       const double fps_max = 1./(double)conf.fps_max;
       if (real_dt < fps_max) {
          double delay = fps_max - real_dt;
@@ -900,6 +938,22 @@ static void fps_control (void)
    }
 }
 
+/**
+ * @brief Runs the Lua garbage collector in the time left of the frame.
+ */
+static void gc_step (void)
+{
+   double target, elapsed, dt;
+
+   /* Keep a millisecond of margin so the swap is not late. */
+   target  = 1. / (double)((conf.fps_max > 0) ? conf.fps_max : 60);
+   elapsed = (double)(SDL_GetPerformanceCounter() - frame_start) / (double)SDL_GetPerformanceFrequency();
+   dt = nlua_gcStep( target - elapsed - 1e-3 );
+
+   gc_cur    += dt;
+   gc_cur_max = MAX( gc_cur_max, dt );
+}
+
 /**
  * @brief Sets the position to display the FPS.
  */
@@ -923,14 +977,24 @@ void display_fps( const double dt )
    fps_cur += 1.;
    if (fps_dt > 1.) { /* recalculate every second */
       fps = fps_cur / fps_dt;
+      gc_avg = gc_cur / fps_cur;
+      gc_max = gc_cur_max;
       fps_dt = fps_cur = 0.;
+      gc_cur = gc_cur_max = 0.;
    }
 
    x = fps_x;
    y = fps_y;
    if (conf.fps_show) {
+      unsigned int draws = gl_renderStatsDrawCalls();
       gl_print( &gl_defFontMono, x, y, &cFontWhite, "%3.2f", fps );
       y -= gl_defFontMono.h + 5.;
+      gl_print( &gl_defFontMono, x, y, &cFontWhite,
+            n_("%u draw call", "%u draw calls", draws), draws );
+      y -= gl_defFontMono.h + 5.;
+      gl_print( &gl_defFontMono, x, y, &cFontWhite,
+            _("GC %.2f ms (max %.2f ms)"), gc_avg*1000., gc_max*1000. );
+      y -= gl_defFontMono.h + 5.;
    }
 
    if ((player.p != NULL) && !player_isFlag(PLAYER_DESTROYED) &&
@@ -1029,6 +1093,9 @@ void update_routine( double dt, int enter_sys )
       h[2].type = HOOK_PARAM_SENTINEL;
       /* Run the update hook. */
       hooks_runParam( "update", h );
+
+      /* Let replays log or check the random numbers used by the tick. */
+      replay_tick();
    }
 }
 
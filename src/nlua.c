@@ -9,6 +9,7 @@
 
 /** @cond */
 #include "physfs.h"
+#include "SDL_timer.h"
 
 #include "naev.h"
 /** @endcond */
@@ -16,6 +17,7 @@
 #include "nlua.h"
 
 #include "log.h"
+#include "array.h"
 #include "conf.h"
 #include "lua_enet.h"
 #include "lutf8lib.h"
@@ -45,13 +47,39 @@
 #include "nlua_var.h"
 #include "nlua_vec2.h"
 #include "nluadef.h"
+#include "nmemory.h"
 #include "nstring.h"
 
+#define NLUA_GC_STEPSIZE   8 /**< Size (in KiB) of each scheduled incremental GC step. */
+#define NLUA_GC_PAUSE      300 /**< Automatic GC pause (percent), the scheduled steps normally finish cycles long before it. */
+#define NLUA_GC_GROWTH     110 /**< Memory use (percent of the last cycle) before scheduled steps start a new cycle. */
+#define NLUA_MEMBYTES(L)   ((size_t)lua_gc(L,LUA_GCCOUNT,0)*1024 + lua_gc(L,LUA_GCCOUNTB,0)) /**< Bytes used by a Lua state. */
+
+#if !HAVE_LUAJIT
+#define NLUA_POOL_GRAIN    16 /**< Granularity of the pool size classes. */
+#define NLUA_POOL_MAX      256 /**< Largest block served from the pools. */
+#define NLUA_POOL_CLASSES  (NLUA_POOL_MAX / NLUA_POOL_GRAIN) /**< Number of pool size classes. */
+#define NLUA_POOL_SLAB     (64*1024) /**< Size of the slabs pool blocks are carved from. */
+
+/**
+ * @brief Free block in a Lua allocator pool.
+ */
+typedef struct LuaPoolBlock_ {
+   struct LuaPoolBlock_ *next; /**< Next free block of the same size class. */
+} LuaPoolBlock;
+#endif /* !HAVE_LUAJIT */
+
 lua_State *naevL = NULL;
 nlua_env __NLUA_CURENV = LUA_NOREF;
 static char *common_script; /**< Common script to run when creating environments. */
 static size_t common_sz; /**< Common script size. */
 static int nlua_envs = LUA_NOREF;
+static int nlua_gc_base = 0; /**< Memory in use (KiB) after the last completed GC cycle. */
+static int nlua_gc_cycle = 0; /**< A GC cycle started by nlua_gcStep() is in progress. */
+#if !HAVE_LUAJIT
+static LuaPoolBlock *nlua_pool_free[NLUA_POOL_CLASSES]; /**< Free lists for each size class. */
+static void **nlua_pool_slabs = NULL; /**< Array (array.h): Slabs allocated for the pools. */
+#endif /* !HAVE_LUAJIT */
 
 /*
  * prototypes
@@ -61,6 +89,11 @@ static int nlua_package_loader_c( lua_State* L );
 static int nlua_package_loader_croot( lua_State* L );
 static int nlua_require( lua_State* L );
 static lua_State *nlua_newState (void); /* creates a new state */
+#if !HAVE_LUAJIT
+static void *nlua_alloc( void *ud, void *ptr, size_t osize, size_t nsize );
+static void *nlua_poolGet( int c );
+static void nlua_poolFree (void);
+#endif /* !HAVE_LUAJIT */
 static int nlua_loadBasic( lua_State* L );
 static int luaB_loadstring( lua_State *L );
 /* gettext */
@@ -214,6 +247,9 @@ void lua_exit (void)
    free( common_script );
    lua_close(naevL);
    naevL = NULL;
+#if !HAVE_LUAJIT
+   nlua_poolFree();
+#endif /* !HAVE_LUAJIT */
 }
 
 /*
@@ -351,6 +387,9 @@ nlua_env nlua_newEnv (void)
    }
 
    lua_pop(naevL, 1); /* t */
+
+   /* Environments are the bulk of the Lua memory, so account it here. */
+   nmem_set( MEM_LUA, NLUA_MEMBYTES(naevL) );
    return ref;
 }
 
@@ -446,22 +485,181 @@ void nlua_register( nlua_env env, const char *libname,
    nlua_setenv(naevL, env, libname);/* */
 }
 
+/**
+ * @brief Caches a registry reference to a metatable.
+ *
+ * Pushing the metatable with lua_rawgeti() avoids a string lookup in the
+ *  registry every time a userdata is created or checked.
+ *
+ *    @param libname Name of the metatable (must already be registered).
+ *    @param[in,out] ref Reference to set, left alone if already set.
+ */
+void nlua_refMetatable( const char *libname, int *ref )
+{
+   if (*ref != LUA_NOREF)
+      return;
+   luaL_getmetatable( naevL, libname );
+   *ref = luaL_ref( naevL, LUA_REGISTRYINDEX );
+}
+
+#if !HAVE_LUAJIT
+/**
+ * @brief Gets the pool size class of a block size.
+ */
+static inline int nlua_poolClass( size_t size )
+{
+   if ((size == 0) || (size > NLUA_POOL_MAX))
+      return -1;
+   return (size-1) / NLUA_POOL_GRAIN;
+}
+
+/**
+ * @brief Gets a block of a size class, carving a new slab if the pool is empty.
+ */
+static void *nlua_poolGet( int c )
+{
+   LuaPoolBlock *b = nlua_pool_free[c];
+   if (b == NULL) {
+      size_t size = (c+1) * NLUA_POOL_GRAIN;
+      char *slab = malloc( NLUA_POOL_SLAB );
+      if (slab == NULL)
+         return NULL;
+      if (nlua_pool_slabs == NULL)
+         nlua_pool_slabs = array_create( void* );
+      array_push_back( &nlua_pool_slabs, slab );
+      for (size_t i=0; i+size<=NLUA_POOL_SLAB; i+=size) {
+         LuaPoolBlock *f = (LuaPoolBlock*) &slab[i];
+         f->next = b;
+         b = f;
+      }
+   }
+   nlua_pool_free[c] = b->next;
+   return b;
+}
+
+/**
+ * @brief Frees all the pool slabs, only safe once the Lua state is closed.
+ */
+static void nlua_poolFree (void)
+{
+   for (int i=0; i<array_size(nlua_pool_slabs); i++)
+      free( nlua_pool_slabs[i] );
+   array_free( nlua_pool_slabs );
+   nlua_pool_slabs = NULL;
+   memset( nlua_pool_free, 0, sizeof(nlua_pool_free) );
+}
+
+/**
+ * @brief Lua allocator that serves the small blocks Lua churns through
+ *        (strings, tables, closures, userdata) from size-class pools.
+ */
+static void *nlua_alloc( void *ud, void *ptr, size_t osize, size_t nsize )
+{
+   (void) ud;
+   void *nptr;
+   int oc = (ptr != NULL) ? nlua_poolClass( osize ) : -1;
+   int nc = nlua_poolClass( nsize );
+
+   /* Free. */
+   if (nsize == 0) {
+      if (oc >= 0) {
+         LuaPoolBlock *b = ptr;
+         b->next = nlua_pool_free[oc];
+         nlua_pool_free[oc] = b;
+      }
+      else
+         free( ptr );
+      return NULL;
+   }
+
+   /* Large blocks go to the system allocator. */
+   if ((oc < 0) && (nc < 0))
+      return realloc( ptr, nsize );
+   /* Still fits the same block. */
+   if (oc == nc)
+      return ptr;
+
+   /* Move between pools or between a pool and the system allocator. */
+   nptr = (nc >= 0) ? nlua_poolGet( nc ) : malloc( nsize );
+   /* Lua assumes shrinking never fails, the old block is big enough anyway. */
+   if ((nptr == NULL) && (nsize <= osize))
+      return ptr;
+   if ((nptr == NULL) || (ptr == NULL))
+      return nptr;
+   memcpy( nptr, ptr, MIN( osize, nsize ) );
+   nlua_alloc( ud, ptr, osize, 0 );
+   return nptr;
+}
+#endif /* !HAVE_LUAJIT */
+
 /**
  * @brief Wrapper around luaL_newstate.
  *
+ * Plain Lua gets the pooled allocator, LuaJIT already uses its own
+ * segregated allocator (and refuses custom ones on some 64 bit builds).
+ *
  *    @return A newly created lua_State.
  */
 static lua_State *nlua_newState (void)
 {
    /* Try to create the new state */
+#if HAVE_LUAJIT
    lua_State *L = luaL_newstate();
+#else /* HAVE_LUAJIT */
+   lua_State *L = lua_newstate( nlua_alloc, NULL );
+#endif /* HAVE_LUAJIT */
    if (L == NULL) {
       WARN(_("Failed to create new Lua state."));
       return NULL;
    }
+
+   /* The collector is mainly driven by nlua_gcStep(), the automatic one is
+    * only a backstop for frames without idle time. */
+   lua_gc( L, LUA_GCSETPAUSE, NLUA_GC_PAUSE );
    return L;
 }
 
+/**
+ * @brief Does incremental garbage collection in a frame's idle time.
+ *
+ * Small bounded steps are done until the budget runs out or the cycle is
+ * finished. A cycle in progress is always continued in the following frames
+ * until it finishes, a new one is only started once memory use has grown
+ * enough since the last one.
+ *
+ *    @param budget Time (in seconds) the collector may use.
+ *    @return Time (in seconds) spent collecting.
+ */
+double nlua_gcStep( double budget )
+{
+   Uint64 start;
+   double elapsed, freq;
+
+   if (naevL == NULL)
+      return 0.;
+   nmem_set( MEM_LUA, NLUA_MEMBYTES(naevL) );
+   if (budget <= 0.)
+      return 0.;
+   if (!nlua_gc_cycle) {
+      if (lua_gc( naevL, LUA_GCCOUNT, 0 )*100 < nlua_gc_base*NLUA_GC_GROWTH)
+         return 0.;
+      nlua_gc_cycle = 1;
+   }
+
+   freq  = (double) SDL_GetPerformanceFrequency();
+   start = SDL_GetPerformanceCounter();
+   do {
+      int done = lua_gc( naevL, LUA_GCSTEP, NLUA_GC_STEPSIZE );
+      elapsed = (double)(SDL_GetPerformanceCounter() - start) / freq;
+      if (done) {
+         nlua_gc_base  = lua_gc( naevL, LUA_GCCOUNT, 0 );
+         nlua_gc_cycle = 0;
+         break;
+      }
+   } while (elapsed < budget);
+   return elapsed;
+}
+
 /**
  * @brief Loads specially modified basic stuff.
  *
@@ -31,6 +31,7 @@ void nlua_setenv(lua_State* L, nlua_env env, const char *name);
 void nlua_getenv(lua_State* L, nlua_env env, const char *name);
 void nlua_register(nlua_env env, const char *libname,
                    const luaL_Reg *l, int metatable);
+void nlua_refMetatable( const char *libname, int *ref );
 int nlua_dobufenv(nlua_env env,
                   const char *buff,
                   size_t sz,
@@ -50,6 +51,9 @@ void nlua_unref( lua_State *L, int idx );
 /* Hack to handle resizes. */
 void nlua_resize (void);
 
+/* Garbage collection. */
+double nlua_gcStep( double budget );
+
 #if DEBUGGING
 void nlua_pushEnvTable( lua_State *L );
 #endif /* DEBUGGING */
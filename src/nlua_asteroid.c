@@ -62,6 +62,8 @@ static const luaL_Reg asteroidL_methods[] = {
    {0,0}
 }; /**< AsteroidLua methods. */
 
+static int asteroid_metatable = LUA_NOREF; /**< Cached reference to the asteroid metatable. */
+
 /**
  * @brief Loads the asteroid library.
  *
@@ -71,6 +73,7 @@ static const luaL_Reg asteroidL_methods[] = {
 int nlua_loadAsteroid( nlua_env env )
 {
    nlua_register(env, ASTEROID_METATABLE, asteroidL_methods, 1);
+   nlua_refMetatable( ASTEROID_METATABLE, &asteroid_metatable );
    return 0;
 }
 
@@ -143,7 +146,7 @@ LuaAsteroid_t* lua_pushasteroid( lua_State *L, LuaAsteroid_t asteroid )
 {
    LuaAsteroid_t *la = (LuaAsteroid_t*) lua_newuserdata(L, sizeof(LuaAsteroid_t));
    *la = asteroid;
-   luaL_getmetatable(L, ASTEROID_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, asteroid_metatable);
    lua_setmetatable(L, -2);
    return la;
 }
@@ -160,7 +163,7 @@ int lua_isasteroid( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, ASTEROID_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, asteroid_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
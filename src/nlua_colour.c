@@ -43,6 +43,8 @@ static const luaL_Reg colL_methods[] = {
    {0,0}
 }; /**< Colour metatable methods. */
 
+static int col_metatable = LUA_NOREF; /**< Cached reference to the colour metatable. */
+
 /**
  * @brief Loads the colour library.
  *
@@ -52,6 +54,7 @@ static const luaL_Reg colL_methods[] = {
 int nlua_loadCol( nlua_env env )
 {
    nlua_register(env, COL_METATABLE, colL_methods, 1);
+   nlua_refMetatable( COL_METATABLE, &col_metatable );
    return 0;
 }
 
@@ -104,7 +107,7 @@ glColour* lua_pushcolour( lua_State *L, glColour colour )
 {
    glColour *c = (glColour*) lua_newuserdata(L, sizeof(glColour));
    *c = colour;
-   luaL_getmetatable(L, COL_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, col_metatable);
    lua_setmetatable(L, -2);
    return c;
 }
@@ -121,7 +124,7 @@ int lua_iscolour( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, COL_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, col_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -63,6 +63,8 @@ static const luaL_Reg commodityL_methods[] = {
    {0,0}
 }; /**< Commodity metatable methods. */
 
+static int commodity_metatable = LUA_NOREF; /**< Cached reference to the commodity metatable. */
+
 /**
  * @brief Loads the commodity library.
  *
@@ -72,6 +74,7 @@ static const luaL_Reg commodityL_methods[] = {
 int nlua_loadCommodity( nlua_env env )
 {
    nlua_register(env, COMMODITY_METATABLE, commodityL_methods, 1);
+   nlua_refMetatable( COMMODITY_METATABLE, &commodity_metatable );
    return 0;
 }
 
@@ -152,7 +155,7 @@ Commodity** lua_pushcommodity( lua_State *L, Commodity* commodity )
    Commodity **o;
    o = (Commodity**) lua_newuserdata(L, sizeof(Commodity*));
    *o = commodity;
-   luaL_getmetatable(L, COMMODITY_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, commodity_metatable);
    lua_setmetatable(L, -2);
    return o;
 }
@@ -169,7 +172,7 @@ int lua_iscommodity( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, COMMODITY_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, commodity_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
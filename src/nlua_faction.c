@@ -85,6 +85,8 @@ static const luaL_Reg faction_methods[] = {
    {0,0}
 }; /**< Faction metatable methods. */
 
+static int faction_metatable = LUA_NOREF; /**< Cached reference to the faction metatable. */
+
 /**
  * @brief Loads the faction library.
  *
@@ -94,6 +96,7 @@ static const luaL_Reg faction_methods[] = {
 int nlua_loadFaction( nlua_env env )
 {
    nlua_register(env, FACTION_METATABLE, faction_methods, 1);
+   nlua_refMetatable( FACTION_METATABLE, &faction_metatable );
    return 0; /* No error */
 }
 
@@ -194,7 +197,7 @@ LuaFaction* lua_pushfaction( lua_State *L, LuaFaction faction )
    LuaFaction *f;
    f = (LuaFaction*) lua_newuserdata(L, sizeof(LuaFaction));
    *f = faction;
-   luaL_getmetatable(L, FACTION_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, faction_metatable);
    lua_setmetatable(L, -2);
    return f;
 }
@@ -211,7 +214,7 @@ int lua_isfaction( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, FACTION_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, faction_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -52,6 +52,8 @@ static const luaL_Reg jump_methods[] = {
    {0,0}
 }; /**< Jump metatable methods. */
 
+static int jump_metatable = LUA_NOREF; /**< Cached reference to the jump metatable. */
+
 /**
  * @brief Loads the jump library.
  *
@@ -61,6 +63,7 @@ static const luaL_Reg jump_methods[] = {
 int nlua_loadJump( nlua_env env )
 {
    nlua_register(env, JUMP_METATABLE, jump_methods, 1);
+   nlua_refMetatable( JUMP_METATABLE, &jump_metatable );
    return 0; /* No error */
 }
 
@@ -183,7 +186,7 @@ LuaJump* lua_pushjump( lua_State *L, LuaJump jump )
 {
    LuaJump *j = (LuaJump*) lua_newuserdata(L, sizeof(LuaJump));
    *j = jump;
-   luaL_getmetatable(L, JUMP_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, jump_metatable);
    lua_setmetatable(L, -2);
    return j;
 }
@@ -201,7 +204,7 @@ int lua_isjump( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, JUMP_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, jump_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -23,6 +23,74 @@
 #include "nluadef.h"
 
 #define LINOPT_MAX_TM   1000  /**< Maximum time to optimize (in ms). Applied to linear relaxation and MIP independently. */
+#define LINOPT_CACHE_SIZE  64 /**< Number of solutions to keep cached. */
+#define LINOPT_KEY_PARAMS  20 /**< Number of solver parameters stored in a problem key. */
+
+/**
+ * @brief Solver parameters.
+ */
+typedef struct LinOptParams_s {
+   int ismip;        /**< Whether or not the problem has integer variables. */
+   glp_smcp smcp;    /**< Simplex parameters. */
+   glp_iocp iocp;    /**< Integer optimization parameters. */
+} LinOptParams_t;
+
+/**
+ * @brief Solution (or failure) of a linear program.
+ */
+typedef struct LinOptSolution_s {
+   const char *err;  /**< Error message if it failed, NULL otherwise. */
+   double z;         /**< Value of the objective function. */
+   double *cols;     /**< Values of the structural variables. */
+   double *rows;     /**< Values of the auxiliary variables. */
+   int ncols;        /**< Number of structural variables. */
+   int nrows;        /**< Number of auxiliary variables. */
+   int tmlim;        /**< Solver hit the time limit, so the result depends on machine load. */
+} LinOptSolution_t;
+
+/**
+ * @brief Header of the canonical description of a problem.
+ *
+ * Followed by ncols LinOptKeyCol_t, nrows LinOptKeyRow_t and nnz
+ *  LinOptKeyElem_t. Names are not included as they don't affect the solution.
+ */
+typedef struct LinOptKeyHeader_s {
+   double obj0;      /**< Constant term of the objective function. */
+   int dir;          /**< Optimization direction. */
+   int ncols;        /**< Number of structural variables. */
+   int nrows;        /**< Number of auxiliary variables. */
+   int nnz;          /**< Number of non-zero matrix elements. */
+   int params[LINOPT_KEY_PARAMS]; /**< Solver parameters that affect the solution. */
+} LinOptKeyHeader_t;
+typedef struct LinOptKeyCol_s {
+   double coef;      /**< Objective coefficient. */
+   double lb;        /**< Lower bound. */
+   double ub;        /**< Upper bound. */
+   int type;         /**< Bound type. */
+   int kind;         /**< Kind of variable. */
+} LinOptKeyCol_t;
+typedef struct LinOptKeyRow_s {
+   double lb;        /**< Lower bound. */
+   double ub;        /**< Upper bound. */
+   int type;         /**< Bound type. */
+   int pad;          /**< Unused, kept 0 so the key can be compared bytewise. */
+} LinOptKeyRow_t;
+typedef struct LinOptKeyElem_s {
+   int i;            /**< Row. */
+   int j;            /**< Column. */
+   double v;         /**< Value. */
+} LinOptKeyElem_t;
+
+/**
+ * @brief Cached solution of a linear program.
+ */
+typedef struct LinOptCache_s {
+   char *key;        /**< Canonical description of the problem. */
+   size_t keylen;    /**< Length of the key. */
+   uint64_t hash;    /**< Hash of the key. */
+   unsigned int lastuse; /**< Last time it was used, for LRU eviction. */
+   LinOptSolution_t sol; /**< The solution. */
+} LinOptCache_t;
 
 /**
  * @brief Our cute little linear program wrapper.
@@ -33,6 +101,20 @@ typedef struct LuaLinOpt_s {
    glp_prob *prob;   /**< Problem structure itself. */
 } LuaLinOpt_t;
 
+static LinOptCache_t linopt_cache[ LINOPT_CACHE_SIZE ]; /**< Solution cache. */
+static unsigned int linopt_cacheTick = 0; /**< Counter for LRU eviction. */
+
+/* Solving. */
+static void linopt_params( lua_State *L, const LuaLinOpt_t *lp, LinOptParams_t *parm );
+static void linopt_solveProb( glp_prob *prob, const LinOptParams_t *parm, LinOptSolution_t *sol );
+static int linopt_pushSolution( lua_State *L, const LinOptSolution_t *sol );
+static void linopt_solutionFree( LinOptSolution_t *sol );
+/* Cache. */
+static char* linopt_key( glp_prob *prob, const LinOptParams_t *parm, size_t *len );
+static uint64_t linopt_hash( const char *key, size_t len );
+static const LinOptSolution_t* linopt_cacheGet( const char *key, size_t len, uint64_t hash );
+static const LinOptSolution_t* linopt_cacheAdd( char *key, size_t len, uint64_t hash, LinOptSolution_t *sol );
+
 /* Optim metatable methods. */
 static int linoptL_gc( lua_State *L );
 static int linoptL_eq( lua_State *L );
@@ -192,6 +274,7 @@ static int linoptL_new( lua_State *L )
    int max;
 
    /* Input. */
+   memset( &lp, 0, sizeof(LuaLinOpt_t) );
    name     = luaL_optstring(L,1,NULL);
    lp.ncols = luaL_checkinteger(L,2);
    lp.nrows = luaL_checkinteger(L,3);
@@ -578,36 +661,26 @@ static int opt_onoff( const char *str, int def )
 }
 #undef STRCHK
 
-#define GETOPT_IOCP( name, func, def ) do {lua_getfield(L,2,#name); parm_iocp.name = func( luaL_optstring(L,-1,NULL), def ); lua_pop(L,1); } while (0)
-#define GETOPT_SMCP( name, func, def ) do {lua_getfield(L,2,#name); parm_smcp.name = func( luaL_optstring(L,-1,NULL), def ); lua_pop(L,1); } while (0)
+#define GETOPT_IOCP( name, func, def ) do {lua_getfield(L,2,#name); parm->iocp.name = func( luaL_optstring(L,-1,NULL), def ); lua_pop(L,1); } while (0)
+#define GETOPT_SMCP( name, func, def ) do {lua_getfield(L,2,#name); parm->smcp.name = func( luaL_optstring(L,-1,NULL), def ); lua_pop(L,1); } while (0)
 /**
- * @brief Solves the linear optimization problem.
+ * @brief Gets the solver parameters from the optional table at index 2.
  *
- *    @luatparam LinOpt lp Linear program to modify.
- *    @luatreturn number The value of the primal funcation.
- *    @luatreturn table Table of column values.
- * @luafunc solve
+ *    @param L Lua state to get parameters from.
+ *    @param lp Linear program to get parameters for.
+ *    @param[out] parm Parameters.
  */
-static int linoptL_solve( lua_State *L )
+static void linopt_params( lua_State *L, const LuaLinOpt_t *lp, LinOptParams_t *parm )
 {
-   LuaLinOpt_t *lp = luaL_checklinopt(L,1);
-   double z;
-   int ret, ismip;
-   glp_iocp parm_iocp;
-   glp_smcp parm_smcp;
-#if DEBUGGING
-   Uint32 starttime = SDL_GetTicks();
-#endif /* DEBUGGING */
-
-   /* Parameters. */
-   ismip = (glp_get_num_int( lp->prob ) > 0);
-   glp_init_smcp(&parm_smcp);
-   parm_smcp.msg_lev = GLP_MSG_ERR;
-   parm_smcp.tm_lim = LINOPT_MAX_TM;
-   if (ismip) {
-      glp_init_iocp(&parm_iocp);
-      parm_iocp.msg_lev  = GLP_MSG_ERR;
-      parm_iocp.tm_lim = LINOPT_MAX_TM;
+   memset( parm, 0, sizeof(LinOptParams_t) );
+   parm->ismip = (glp_get_num_int( lp->prob ) > 0);
+   glp_init_smcp(&parm->smcp);
+   parm->smcp.msg_lev = GLP_MSG_ERR;
+   parm->smcp.tm_lim = LINOPT_MAX_TM;
+   if (parm->ismip) {
+      glp_init_iocp(&parm->iocp);
+      parm->iocp.msg_lev  = GLP_MSG_ERR;
+      parm->iocp.tm_lim = LINOPT_MAX_TM;
    }
 
    /* Load parameters. */
@@ -616,7 +689,7 @@ static int linoptL_solve( lua_State *L )
       GETOPT_SMCP( pricing, opt_pricing, PRICING_DEF );
       GETOPT_SMCP( r_test,  opt_r_test,  R_TEST_DEF );
       GETOPT_SMCP( presolve,opt_onoff,   PRESOLVE_DEF );
-      if (ismip) {
+      if (parm->ismip) {
          GETOPT_IOCP( br_tech,  opt_br_tech, BR_TECH_DEF );
          GETOPT_IOCP( bt_tech,  opt_bt_tech, BT_TECH_DEF );
          GETOPT_IOCP( pp_tech,  opt_pp_tech, PP_TECH_DEF );
@@ -631,81 +704,97 @@ static int linoptL_solve( lua_State *L )
    }
 #if 0
    else {
-      parm_smcp.meth    = METH_DEF;
-      parm_smcp.pricing = PRICING_DEF;
-      parm_smcp.r_test  = R_TEST_DEF;
-      parm_smcp.presolve= PRESOLVE_DEF;
-      if (ismip) {
-         parm_iocp.br_tech  = BR_TECH_DEF;
-         parm_iocp.bt_tech  = BT_TECH_DEF;
-         parm_iocp.pp_tech  = PP_TECH_DEF;
-         parm_iocp.sr_heur  = SR_HEUR_DEF;
-         parm_iocp.fp_heur  = FP_HEUR_DEF;
-         parm_iocp.ps_heur  = PS_HEUR_DEF;
-         parm_iocp.gmi_cuts = GMI_CUTS_DEF;
-         parm_iocp.mir_cuts = MIR_CUTS_DEF;
-         parm_iocp.cov_cuts = COV_CUTS_DEF;
-         parm_iocp.clq_cuts = CLQ_CUTS_DEF;
+      parm->smcp.meth    = METH_DEF;
+      parm->smcp.pricing = PRICING_DEF;
+      parm->smcp.r_test  = R_TEST_DEF;
+      parm->smcp.presolve= PRESOLVE_DEF;
+      if (parm->ismip) {
+         parm->iocp.br_tech  = BR_TECH_DEF;
+         parm->iocp.bt_tech  = BT_TECH_DEF;
+         parm->iocp.pp_tech  = PP_TECH_DEF;
+         parm->iocp.sr_heur  = SR_HEUR_DEF;
+         parm->iocp.fp_heur  = FP_HEUR_DEF;
+         parm->iocp.ps_heur  = PS_HEUR_DEF;
+         parm->iocp.gmi_cuts = GMI_CUTS_DEF;
+         parm->iocp.mir_cuts = MIR_CUTS_DEF;
+         parm->iocp.cov_cuts = COV_CUTS_DEF;
+         parm->iocp.clq_cuts = CLQ_CUTS_DEF;
       }
    }
 #endif
+}
+#undef GETOPT_SMCP
+#undef GETOPT_IOCP
+
+/**
+ * @brief Solves a problem.
+ *
+ *    @param prob Problem to solve.
+ *    @param parm Solver parameters.
+ *    @param[out] sol Solution.
+ */
+static void linopt_solveProb( glp_prob *prob, const LinOptParams_t *parm, LinOptSolution_t *sol )
+{
+   int ret;
+   glp_smcp parm_smcp = parm->smcp;
+   glp_iocp parm_iocp = parm->iocp;
+#if DEBUGGING
+   Uint32 starttime = SDL_GetTicks();
+#endif /* DEBUGGING */
+
+   memset( sol, 0, sizeof(LinOptSolution_t) );
 
    /* Optimization. */
-   if (!ismip || !parm_iocp.presolve) {
-      ret = glp_simplex( lp->prob, &parm_smcp );
-      if ((ret != 0) && (ret != GLP_ETMLIM)) {
-         lua_pushnil(L);
-         lua_pushstring(L, linopt_error(ret));
-         return 2;
+   if (!parm->ismip || !parm_iocp.presolve) {
+      ret = glp_simplex( prob, &parm_smcp );
+      if (ret == GLP_ETMLIM)
+         sol->tmlim = 1;
+      else if (ret != 0) {
+         sol->err = linopt_error(ret);
+         return;
       }
       /* Check for optimality of continuous problem. */
-      ret = glp_get_status(lp->prob);
+      ret = glp_get_status(prob);
       if ((ret != GLP_OPT) && (ret != GLP_FEAS)) {
-         lua_pushnil(L);
-         lua_pushstring(L, linopt_status(ret));
-         return 2;
+         sol->err = linopt_status(ret);
+         return;
       }
    }
-   if (ismip) {
-      ret = glp_intopt( lp->prob, &parm_iocp );
-      if ((ret != 0) && (ret != GLP_ETMLIM)) {
-         lua_pushnil(L);
-         lua_pushstring(L, linopt_error(ret));
-         return 2;
+   if (parm->ismip) {
+      ret = glp_intopt( prob, &parm_iocp );
+      if (ret == GLP_ETMLIM)
+         sol->tmlim = 1;
+      else if (ret != 0) {
+         sol->err = linopt_error(ret);
+         return;
       }
       /* Check for optimality of discrete problem. */
-      ret = glp_mip_status(lp->prob);
+      ret = glp_mip_status(prob);
       if ((ret != GLP_OPT) && (ret != GLP_FEAS)) {
-         lua_pushnil(L);
-         lua_pushstring(L, linopt_status(ret));
-         return 2;
+         sol->err = linopt_status(ret);
+         return;
       }
    }
-   z = glp_get_obj_val( lp->prob );
-
-   /* Output function value. */
-   lua_pushnumber(L,z);
+   sol->z = glp_get_obj_val( prob );
 
    /* Go over variables and store them. */
-   lua_newtable(L); /* t */
-   for (int i=1; i<=lp->ncols; i++) {
-      if (ismip)
-         z = glp_mip_col_val( lp->prob, i );
+   sol->ncols = glp_get_num_cols( prob );
+   sol->cols  = malloc( MAX(sol->ncols,1) * sizeof(double) );
+   for (int i=1; i<=sol->ncols; i++) {
+      if (parm->ismip)
+         sol->cols[i-1] = glp_mip_col_val( prob, i );
       else
-         z = glp_get_col_prim( lp->prob, i );
-      lua_pushnumber( L, z ); /* t, z */
-      lua_rawseti( L, -2, i ); /* t */
+         sol->cols[i-1] = glp_get_col_prim( prob, i );
    }
 
    /* Go over constraints and store them. */
-   lua_newtable(L); /* t */
-   for (int i=1; i<=lp->nrows; i++) {
-      if (ismip)
-         z = glp_mip_row_val( lp->prob, i );
+   sol->nrows = glp_get_num_rows( prob );
+   sol->rows  = malloc( MAX(sol->nrows,1) * sizeof(double) );
+   for (int i=1; i<=sol->nrows; i++) {
+      if (parm->ismip)
+         sol->rows[i-1] = glp_mip_row_val( prob, i );
       else
-         z = glp_get_row_prim( lp->prob, i );
-      lua_pushnumber( L, z ); /* t, z */
-      lua_rawseti( L, -2, i ); /* t */
+         sol->rows[i-1] = glp_get_row_prim( prob, i );
    }
 
    /* Complain about time. */
@@ -713,10 +802,270 @@ static int linoptL_solve( lua_State *L )
    if (SDL_GetTicks() - starttime > LINOPT_MAX_TM)
       WARN(_("glpk: too over 1 second to optimize!"));
 #endif /* DEBUGGING */
+}
+
+/**
+ * @brief Pushes a solution like linoptL_solve() returns it.
+ *
+ *    @param L Lua state to push to.
+ *    @param sol Solution to push.
+ *    @return Number of values pushed.
+ */
+static int linopt_pushSolution( lua_State *L, const LinOptSolution_t *sol )
+{
+   if (sol->err != NULL) {
+      lua_pushnil(L);
+      lua_pushstring(L, sol->err);
+      return 2;
+   }
+
+   /* Output function value. */
+   lua_pushnumber(L,sol->z);
+
+   /* Variables. */
+   lua_newtable(L); /* t */
+   for (int i=0; i<sol->ncols; i++) {
+      lua_pushnumber( L, sol->cols[i] ); /* t, z */
+      lua_rawseti( L, -2, i+1 ); /* t */
+   }
+
+   /* Constraints. */
+   lua_newtable(L); /* t */
+   for (int i=0; i<sol->nrows; i++) {
+      lua_pushnumber( L, sol->rows[i] ); /* t, z */
+      lua_rawseti( L, -2, i+1 ); /* t */
+   }
 
    return 3;
 }
-#undef GETOPT_IOCP
+
+/**
+ * @brief Frees the data of a solution.
+ */
+static void linopt_solutionFree( LinOptSolution_t *sol )
+{
+   free( sol->cols );
+   free( sol->rows );
+   memset( sol, 0, sizeof(LinOptSolution_t) );
+}
+
+/**
+ * @brief Compares matrix elements by column for canonical ordering.
+ */
+static int linopt_elemCmp( const void *p1, const void *p2 )
+{
+   const LinOptKeyElem_t *e1 = p1;
+   const LinOptKeyElem_t *e2 = p2;
+   return e1->j - e2->j;
+}
+
+/**
+ * @brief Creates the canonical description of a problem and its parameters.
+ *
+ * Identical problems give bytewise identical keys, which are used to look
+ *  up the solution cache.
+ *
+ *    @param prob Problem to describe.
+ *    @param parm Solver parameters.
+ *    @param[out] len Length of the key.
+ *    @return Newly allocated key.
+ */
+static char* linopt_key( glp_prob *prob, const LinOptParams_t *parm, size_t *len )
+{
+   LinOptKeyHeader_t *hdr;
+   LinOptKeyCol_t *cols;
+   LinOptKeyRow_t *rows;
+   LinOptKeyElem_t *elem;
+   int ncols, nrows, nnz, *ind, k;
+   double *val;
+   char *key;
+
+   ncols = glp_get_num_cols( prob );
+   nrows = glp_get_num_rows( prob );
+   nnz   = glp_get_num_nz( prob );
+   *len  = sizeof(LinOptKeyHeader_t) + ncols*sizeof(LinOptKeyCol_t) +
+         nrows*sizeof(LinOptKeyRow_t) + nnz*sizeof(LinOptKeyElem_t);
+   key   = calloc( 1, *len );
+   hdr   = (LinOptKeyHeader_t*) key;
+   cols  = (LinOptKeyCol_t*) &hdr[1];
+   rows  = (LinOptKeyRow_t*) &cols[ncols];
+   elem  = (LinOptKeyElem_t*) &rows[nrows];
+
+   /* Header. */
+   hdr->obj0   = glp_get_obj_coef( prob, 0 );
+   hdr->dir    = glp_get_obj_dir( prob );
+   hdr->ncols  = ncols;
+   hdr->nrows  = nrows;
+   hdr->nnz    = nnz;
+   k = 0;
+   hdr->params[k++] = parm->ismip;
+   hdr->params[k++] = parm->smcp.meth;
+   hdr->params[k++] = parm->smcp.pricing;
+   hdr->params[k++] = parm->smcp.r_test;
+   hdr->params[k++] = parm->smcp.presolve;
+   hdr->params[k++] = parm->smcp.tm_lim;
+   if (parm->ismip) {
+      hdr->params[k++] = parm->iocp.br_tech;
+      hdr->params[k++] = parm->iocp.bt_tech;
+      hdr->params[k++] = parm->iocp.pp_tech;
+      hdr->params[k++] = parm->iocp.sr_heur;
+      hdr->params[k++] = parm->iocp.fp_heur;
+      hdr->params[k++] = parm->iocp.ps_heur;
+      hdr->params[k++] = parm->iocp.gmi_cuts;
+      hdr->params[k++] = parm->iocp.mir_cuts;
+      hdr->params[k++] = parm->iocp.cov_cuts;
+      hdr->params[k++] = parm->iocp.clq_cuts;
+      hdr->params[k++] = parm->iocp.presolve;
+      hdr->params[k++] = parm->iocp.tm_lim;
+   }
+
+   /* Columns. */
+   for (int j=0; j<ncols; j++) {
+      cols[j].coef = glp_get_obj_coef( prob, j+1 );
+      cols[j].lb   = glp_get_col_lb( prob, j+1 );
+      cols[j].ub   = glp_get_col_ub( prob, j+1 );
+      cols[j].type = glp_get_col_type( prob, j+1 );
+      cols[j].kind = glp_get_col_kind( prob, j+1 );
+   }
+
+   /* Rows. */
+   for (int i=0; i<nrows; i++) {
+      rows[i].lb   = glp_get_row_lb( prob, i+1 );
+      rows[i].ub   = glp_get_row_ub( prob, i+1 );
+      rows[i].type = glp_get_row_type( prob, i+1 );
+   }
+
+   /* Matrix, sorted by column within each row. */
+   ind = malloc( (ncols+1) * sizeof(int) );
+   val = malloc( (ncols+1) * sizeof(double) );
+   k = 0;
+   for (int i=0; i<nrows; i++) {
+      int n = glp_get_mat_row( prob, i+1, ind, val );
+      for (int l=1; l<=n; l++) {
+         elem[k+l-1].i = i+1;
+         elem[k+l-1].j = ind[l];
+         elem[k+l-1].v = val[l];
+      }
+      qsort( &elem[k], n, sizeof(LinOptKeyElem_t), linopt_elemCmp );
+      k += n;
+   }
+   free( ind );
+   free( val );
+
+   return key;
+}
+
+/**
+ * @brief Hashes a problem key (FNV-1a).
+ */
+static uint64_t linopt_hash( const char *key, size_t len )
+{
+   uint64_t h = 14695981039346656037ULL;
+   for (size_t i=0; i<len; i++) {
+      h ^= (unsigned char) key[i];
+      h *= 1099511628211ULL;
+   }
+   return h;
+}
+
+/**
+ * @brief Looks up a solution in the cache.
+ *
+ *    @return The cached solution or NULL if not found.
+ */
+static const LinOptSolution_t* linopt_cacheGet( const char *key, size_t len, uint64_t hash )
+{
+   for (int i=0; i<LINOPT_CACHE_SIZE; i++) {
+      LinOptCache_t *c = &linopt_cache[i];
+      if ((c->key == NULL) || (c->hash != hash) || (c->keylen != len))
+         continue;
+      if (memcmp( c->key, key, len ) != 0)
+         continue;
+      c->lastuse = ++linopt_cacheTick;
+      return &c->sol;
+   }
+   return NULL;
+}
+
+/**
+ * @brief Adds a solution to the cache, evicting the least recently used one.
+ *
+ *    @param key Key of the problem (ownership is taken).
+ *    @param len Length of the key.
+ *    @param hash Hash of the key.
+ *    @param sol Solution (ownership of the data is taken).
+ *    @return The cached solution.
+ */
+static const LinOptSolution_t* linopt_cacheAdd( char *key, size_t len, uint64_t hash, LinOptSolution_t *sol )
+{
+   LinOptCache_t *c = &linopt_cache[0];
+   for (int i=1; i<LINOPT_CACHE_SIZE; i++) {
+      if (c->key == NULL)
+         break;
+      if ((linopt_cache[i].key == NULL) || (linopt_cache[i].lastuse < c->lastuse))
+         c = &linopt_cache[i];
+   }
+
+   free( c->key );
+   linopt_solutionFree( &c->sol );
+   c->key      = key;
+   c->keylen   = len;
+   c->hash     = hash;
+   c->lastuse  = ++linopt_cacheTick;
+   c->sol      = *sol;
+   memset( sol, 0, sizeof(LinOptSolution_t) );
+   return &c->sol;
+}
+
+/**
+ * @brief Solves the linear optimization problem.
+ *
+ * Identical problems with identical parameters are only solved once, and
+ *  the solution is reused for a while.
+ *
+ *    @luatparam LinOpt lp Linear program to modify.
+ *    @luatparam[opt=nil] table params Solver parameters.
+ *    @luatreturn number The value of the primal funcation.
+ *    @luatreturn table Table of column values.
+ *    @luatreturn table Table of constraint values.
+ * @luafunc solve
+ */
+static int linoptL_solve( lua_State *L )
+{
+   LuaLinOpt_t *lp = luaL_checklinopt(L,1);
+   LinOptParams_t parm;
+   LinOptSolution_t sol;
+   const LinOptSolution_t *csol;
+   size_t len;
+   uint64_t hash;
+   char *key;
+
+   linopt_params( L, lp, &parm );
+
+   /* See if it has already been solved. */
+   key  = linopt_key( lp->prob, &parm, &len );
+   hash = linopt_hash( key, len );
+   csol = linopt_cacheGet( key, len, hash );
+   if (csol != NULL) {
+      free( key );
+      return linopt_pushSolution( L, csol );
+   }
+
+   /* Solve. */
+   linopt_solveProb( lp->prob, &parm, &sol );
+
+   /* Results cut short by the time limit depend on the load, don't remember them. */
+   if (sol.tmlim) {
+      int ret = linopt_pushSolution( L, &sol );
+      linopt_solutionFree( &sol );
+      free( key );
+      return ret;
+   }
+
+   /* Remember. */
+   csol = linopt_cacheAdd( key, len, hash, &sol );
+   return linopt_pushSolution( L, csol );
+}
 
 /**
  * @brief Reads an optimization problem from a file for debugging purposes.
@@ -739,6 +1088,7 @@ static int linoptL_readProblem( lua_State *L )
    if (dirname == NULL)
       NLUA_ERROR( L, _("Failed to read LP problem \"%s\"!"), fname );
    asprintf( &fpath, "%s/%s", dirname, fname );
+   memset( &lp, 0, sizeof(LuaLinOpt_t) );
    lp.prob = glp_create_prob();
    ret = glpk_format ? glp_read_prob( lp.prob, 0, fpath ) : glp_read_mps(  lp.prob, GLP_MPS_FILE, NULL, fpath );
    free( fpath );
@@ -26,6 +26,7 @@
 #include "nlua_misn.h"
 #include "nlua_system.h"
 #include "nluadef.h"
+#include "nmemory.h"
 #include "nstring.h"
 #include "pause.h"
 #include "player.h"
@@ -69,6 +70,9 @@ static int naevL_setTextInput( lua_State *L );
 #if DEBUGGING
 static int naevL_envs( lua_State *L );
 #endif /* DEBUGGING */
+#if DEBUG_ALLOC
+static int naevL_memory( lua_State *L );
+#endif /* DEBUG_ALLOC */
 static const luaL_Reg naev_methods[] = {
    { "version", naevL_version },
    { "versionTest", naevL_versionTest },
@@ -104,6 +108,9 @@ static const luaL_Reg naev_methods[] = {
 #if DEBUGGING
    { "envs", naevL_envs },
 #endif /* DEBUGGING */
+#if DEBUG_ALLOC
+   { "memory", naevL_memory },
+#endif /* DEBUG_ALLOC */
    {0,0}
 }; /**< Naev Lua methods. */
 
@@ -503,6 +510,7 @@ static int naevL_conf( lua_State *L )
    PUSH_DOUBLE( L, "compression_mult", conf.compression_mult );
    PUSH_BOOL( L, "redirect_file", conf.redirect_file );
    PUSH_BOOL( L, "save_compress", conf.save_compress );
+   PUSH_BOOL( L, "save_xml", conf.save_xml );
    PUSH_INT( L, "doubletap_sensitivity", conf.doubletap_sens );
    PUSH_BOOL( L, "mouse_fly", conf.mouse_fly );
    PUSH_INT( L, "mouse_thrust", conf.mouse_thrust );
@@ -843,3 +851,24 @@ static int naevL_envs( lua_State *L )
    return 1;
 }
 #endif /* DEBUGGING */
+
+#if DEBUG_ALLOC
+/**
+ * @brief Gets a report of the memory used by each subsystem.
+ *
+ * Only available in builds with the debug_alloc option. Allocation rates are
+ * measured since the previous report.
+ *
+ * @usage print( naev.memory() )
+ *
+ *    @luatreturn string Report of the memory use.
+ * @luafunc memory
+ */
+static int naevL_memory( lua_State *L )
+{
+   char buf[STRMAX];
+   nmem_report( buf, sizeof(buf) );
+   lua_pushstring( L, buf );
+   return 1;
+}
+#endif /* DEBUG_ALLOC */
@@ -74,6 +74,8 @@ static const luaL_Reg outfitL_methods[] = {
    {0,0}
 }; /**< Outfit metatable methods. */
 
+static int outfit_metatable = LUA_NOREF; /**< Cached reference to the outfit metatable. */
+
 /**
  * @brief Loads the outfit library.
  *
@@ -83,6 +85,7 @@ static const luaL_Reg outfitL_methods[] = {
 int nlua_loadOutfit( nlua_env env )
 {
    nlua_register(env, OUTFIT_METATABLE, outfitL_methods, 1);
+   nlua_refMetatable( OUTFIT_METATABLE, &outfit_metatable );
    return 0;
 }
 
@@ -161,7 +164,7 @@ const Outfit** lua_pushoutfit( lua_State *L, const Outfit *outfit )
 {
    const Outfit **o = (const Outfit**) lua_newuserdata(L, sizeof(Outfit*));
    *o = outfit;
-   luaL_getmetatable(L, OUTFIT_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, outfit_metatable);
    lua_setmetatable(L, -2);
    return o;
 }
@@ -178,7 +181,7 @@ int lua_isoutfit( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, OUTFIT_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, outfit_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -402,7 +405,7 @@ static int outfitL_limit( lua_State *L )
 static int outfitL_icon( lua_State *L )
 {
    const Outfit *o = luaL_validoutfit(L,1);
-   lua_pushtex( L, gl_dupTexture( o->gfx_store ) );
+   lua_pushtex( L, gl_dupTexture( outfit_gfxStore( o ) ) );
    return 1;
 }
 
@@ -395,6 +395,8 @@ static const luaL_Reg pilotL_methods[] = {
    {0,0},
 }; /**< Pilot metatable methods. */
 
+static int pilot_metatable = LUA_NOREF; /**< Cached reference to the pilot metatable. */
+
 /**
  * @brief Loads the pilot library.
  *
@@ -404,6 +406,7 @@ static const luaL_Reg pilotL_methods[] = {
 int nlua_loadPilot( nlua_env env )
 {
    nlua_register(env, PILOT_METATABLE, pilotL_methods, 1);
+   nlua_refMetatable( PILOT_METATABLE, &pilot_metatable );
 
    /* Pilot always loads ship and asteroid. */
    nlua_loadShip(env);
@@ -499,10 +502,25 @@ Pilot* luaL_validpilot( lua_State *L, int ind )
  */
 LuaPilot* lua_pushpilot( lua_State *L, LuaPilot pilot )
 {
-   LuaPilot *p = (LuaPilot*) lua_newuserdata(L, sizeof(LuaPilot));
+   LuaPilot *p;
+   Pilot *plt = pilot_get( pilot );
+
+   /* Live pilots reuse the same userdata so pushing doesn't create garbage. */
+   if ((plt != NULL) && (plt->lua_ref != LUA_NOREF)) {
+      lua_rawgeti(L, LUA_REGISTRYINDEX, plt->lua_ref);
+      return (LuaPilot*) lua_touserdata(L, -1);
+   }
+
+   p = (LuaPilot*) lua_newuserdata(L, sizeof(LuaPilot));
    *p = pilot;
-   luaL_getmetatable(L, PILOT_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, pilot_metatable);
    lua_setmetatable(L, -2);
+
+   /* Remember it, released in pilot_free(). */
+   if (plt != NULL) {
+      lua_pushvalue(L, -1);
+      plt->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+   }
    return p;
 }
 /**
@@ -518,7 +536,7 @@ int lua_ispilot( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, PILOT_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, pilot_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -2378,6 +2396,7 @@ static int pilotL_setPosition( lua_State *L )
 
    /* Warp pilot to new position. */
    p->solid->pos = *vec;
+   pilot_hotSync( p );
 
    /* Update if necessary. */
    if (pilot_isPlayer(p))
@@ -5460,8 +5479,7 @@ static int pilotL_collisionTest( lua_State *L )
       RotatePolygon( &rpoly, a->polygon, (float) a->ang );
       int ret = CollidePolygon( getCollPoly(p), &p->solid->pos,
             &rpoly, &a->pos, &crash );
-      free(rpoly.x);
-      free(rpoly.y);
+      FreePolygon( &rpoly );
       if (!ret)
          return 0;
       lua_pushvector( L, crash );
@@ -37,6 +37,8 @@ static const luaL_Reg poL_methods[] = {
    {0,0}
 }; /**< Pilot outfit metatable methods. */
 
+static int po_metatable = LUA_NOREF; /**< Cached reference to the pilot outfit metatable. */
+
 /**
  * @brief Loads the pilot outfit library.
  *
@@ -46,6 +48,7 @@ static const luaL_Reg poL_methods[] = {
 int nlua_loadPilotOutfit( nlua_env env )
 {
    nlua_register(env, PILOTOUTFIT_METATABLE, poL_methods, 1);
+   nlua_refMetatable( PILOTOUTFIT_METATABLE, &po_metatable );
    return 0;
 }
 
@@ -113,7 +116,7 @@ PilotOutfitSlot** lua_pushpilotoutfit( lua_State *L, PilotOutfitSlot *po )
 {
    PilotOutfitSlot **lpo = (PilotOutfitSlot**) lua_newuserdata(L, sizeof(PilotOutfitSlot*));
    *lpo = po;
-   luaL_getmetatable(L, PILOTOUTFIT_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, po_metatable);
    lua_setmetatable(L, -2);
    return lpo;
 }
@@ -130,7 +133,7 @@ int lua_ispilotoutfit( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, PILOTOUTFIT_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, po_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -182,8 +185,10 @@ static int poL_state( lua_State *L )
       NLUA_ERROR( L, _("Unknown PilotOutfit state '%s'!"), state );
 
    /* Mark as modified if state changed. */
-   if (pos != po->state)
+   if (pos != po->state) {
       pilotoutfit_modified = 1;
+      po->lua_dirty = 1;
+   }
 
    return 0;
 }
@@ -219,8 +224,13 @@ static int poL_set( lua_State *L )
    PilotOutfitSlot *po = luaL_validpilotoutfit(L,1);
    const char *name = luaL_checkstring(L,2);
    double value = luaL_checknumber(L,3);
+   ShipStats old = po->lua_stats;
    ss_statsSet( &po->lua_stats, name, value, 1 );
-   pilotoutfit_modified = 1;
+   /* Only force a stat recomputation if something actually changed. */
+   if (memcmp( &old, &po->lua_stats, sizeof(ShipStats) ) != 0) {
+      pilotoutfit_modified = 1;
+      po->lua_dirty = 1;
+   }
    return 0;
 }
 
@@ -233,7 +243,11 @@ static int poL_set( lua_State *L )
 static int poL_clear( lua_State *L )
 {
    PilotOutfitSlot *po = luaL_validpilotoutfit(L,1);
+   ShipStats old = po->lua_stats;
    ss_statsInit( &po->lua_stats );
-   pilotoutfit_modified = 1;
+   if (memcmp( &old, &po->lua_stats, sizeof(ShipStats) ) != 0) {
+      pilotoutfit_modified = 1;
+      po->lua_dirty = 1;
+   }
    return 0;
 }
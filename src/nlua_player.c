@@ -913,6 +913,7 @@ static int playerL_land( lua_State *L )
       ovr_initAlpha();
    }
    player.p->solid->pos = spob->pos; /* Set position to target. */
+   pilot_hotSync( player.p );
 
    /* Do whatever the spob wants to do. */
    if (spob->lua_land != LUA_NOREF) {
@@ -1967,6 +1968,7 @@ static int playerL_teleport( lua_State *L )
          pilot_clearTrails( p );
       }
    }
+   pilots_hotSync();
 
    return 0;
 }
@@ -81,6 +81,8 @@ static const luaL_Reg shipL_methods[] = {
    {0,0}
 }; /**< Ship metatable methods. */
 
+static int ship_metatable = LUA_NOREF; /**< Cached reference to the ship metatable. */
+
 /**
  * @brief Loads the ship library.
  *
@@ -90,6 +92,7 @@ static const luaL_Reg shipL_methods[] = {
 int nlua_loadShip( nlua_env env )
 {
    nlua_register(env, SHIP_METATABLE, shipL_methods, 1);
+   nlua_refMetatable( SHIP_METATABLE, &ship_metatable );
    return 0;
 }
 
@@ -168,7 +171,7 @@ const Ship** lua_pushship( lua_State *L, const Ship *ship )
    const Ship **p;
    p = (const Ship**) lua_newuserdata(L, sizeof(Ship*));
    *p = ship;
-   luaL_getmetatable(L, SHIP_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, ship_metatable);
    lua_setmetatable(L, -2);
    return p;
 }
@@ -185,7 +188,7 @@ int lua_isship( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, SHIP_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, ship_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -594,7 +597,9 @@ static int shipL_gfxComm( lua_State *L )
 static int shipL_gfxTarget( lua_State *L )
 {
    const Ship *s  = luaL_validship(L,1);
-   glTexture *tex = gl_dupTexture( s->gfx_target );
+   glTexture *tex;
+   ship_gfxLoad( s );
+   tex = gl_dupTexture( s->gfx_target );
    if (tex == NULL) {
       WARN(_("Unable to get ship target graphic for '%s'."), s->name);
       return 0;
@@ -617,7 +622,9 @@ static int shipL_gfxTarget( lua_State *L )
 static int shipL_gfx( lua_State *L )
 {
    const Ship *s  = luaL_validship(L,1);
-   glTexture *tex = gl_dupTexture( s->gfx_space );
+   glTexture *tex;
+   ship_gfxLoad( s );
+   tex = gl_dupTexture( s->gfx_space );
    if (tex == NULL) {
       WARN(_("Unable to get ship graphic for '%s'."), s->name);
       return 0;
@@ -636,6 +643,8 @@ static int shipL_gfx( lua_State *L )
 static int shipL_dims( lua_State *L )
 {
    const Ship *s = luaL_validship(L,1);
+   if (ship_gfxLoad( s ) != 0)
+      return 0;
    lua_pushnumber( L, s->gfx_space->sw );
    lua_pushnumber( L, s->gfx_space->sh );
    return 2;
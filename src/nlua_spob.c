@@ -102,6 +102,8 @@ static const luaL_Reg spob_methods[] = {
    {0,0}
 }; /**< Spob metatable methods. */
 
+static int spob_metatable = LUA_NOREF; /**< Cached reference to the spob metatable. */
+
 /**
  * @brief Loads the spob library.
  *
@@ -111,6 +113,7 @@ static const luaL_Reg spob_methods[] = {
 int nlua_loadSpob( nlua_env env )
 {
    nlua_register(env, SPOB_METATABLE, spob_methods, 1);
+   nlua_refMetatable( SPOB_METATABLE, &spob_metatable );
    return 0; /* No error */
 }
 
@@ -193,7 +196,7 @@ LuaSpob* lua_pushspob( lua_State *L, LuaSpob spob )
 {
    LuaSpob *p = (LuaSpob*) lua_newuserdata(L, sizeof(LuaSpob));
    *p = spob;
-   luaL_getmetatable(L, SPOB_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, spob_metatable);
    lua_setmetatable(L, -2);
    return p;
 }
@@ -210,7 +213,7 @@ int lua_isspob( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, SPOB_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, spob_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -320,6 +323,7 @@ static int spobL_getBackend( lua_State *L, int system, int landable )
    if (rndspob == NULL) {
       arrayShuffle( (void**)spobs );
 
+      spob_luaHold();
       for (int i=0; i<array_size(spobs); i++) {
          if (landable) {
             /* Check landing. */
@@ -335,6 +339,7 @@ static int spobL_getBackend( lua_State *L, int system, int landable )
          rndspob = spobs[i];
          break;
       }
+      spob_luaRelease();
    }
    array_free(spobs);
 
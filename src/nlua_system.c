@@ -95,6 +95,8 @@ static const luaL_Reg system_methods[] = {
    {0,0}
 }; /**< System metatable methods. */
 
+static int system_metatable = LUA_NOREF; /**< Cached reference to the system metatable. */
+
 /**
  * @brief Loads the system library.
  *
@@ -104,6 +106,7 @@ static const luaL_Reg system_methods[] = {
 int nlua_loadSystem( nlua_env env )
 {
    nlua_register(env, SYSTEM_METATABLE, system_methods, 1);
+   nlua_refMetatable( SYSTEM_METATABLE, &system_metatable );
    return 0; /* No error */
 }
 
@@ -186,7 +189,7 @@ LuaSystem* lua_pushsystem( lua_State *L, LuaSystem sys )
 {
    LuaSystem *s = (LuaSystem*) lua_newuserdata(L, sizeof(LuaSystem));
    *s = sys;
-   luaL_getmetatable(L, SYSTEM_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, system_metatable);
    lua_setmetatable(L, -2);
    return s;
 }
@@ -204,7 +207,7 @@ int lua_issystem( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, SYSTEM_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, system_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
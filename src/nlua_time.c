@@ -51,6 +51,8 @@ static const luaL_Reg time_methods[] = {
    {0,0}
 }; /**< Time Lua methods. */
 
+static int time_metatable = LUA_NOREF; /**< Cached reference to the time metatable. */
+
 /**
  * @brief Loads the Time Lua library.
  *
@@ -60,6 +62,7 @@ static const luaL_Reg time_methods[] = {
 int nlua_loadTime( nlua_env env )
 {
    nlua_register(env, TIME_METATABLE, time_methods, 1);
+   nlua_refMetatable( TIME_METATABLE, &time_metatable );
    return 0; /* No error */
 }
 
@@ -127,7 +130,7 @@ ntime_t* lua_pushtime( lua_State *L, ntime_t time )
 {
    ntime_t *p = (ntime_t*) lua_newuserdata(L, sizeof(ntime_t));
    *p = time;
-   luaL_getmetatable(L, TIME_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, time_metatable);
    lua_setmetatable(L, -2);
    return p;
 }
@@ -144,7 +147,7 @@ int lua_istime( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, TIME_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, time_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -33,17 +33,21 @@ static int vectorL_mul( lua_State *L );
 static int vectorL_div__( lua_State *L );
 static int vectorL_div( lua_State *L );
 static int vectorL_dot( lua_State *L );
+static int vectorL_cross( lua_State *L );
 static int vectorL_get( lua_State *L );
 static int vectorL_polar( lua_State *L );
 static int vectorL_set( lua_State *L );
 static int vectorL_setP( lua_State *L );
 static int vectorL_distance( lua_State *L );
 static int vectorL_distance2( lua_State *L );
+static int vectorL_distance2xy( lua_State *L );
 static int vectorL_mod( lua_State *L );
 static int vectorL_angle( lua_State *L );
 static int vectorL_normalize( lua_State *L );
 static int vectorL_collideLineLine( lua_State *L );
 static int vectorL_collideCircleLine( lua_State *L );
+static int vectorL_nearest( lua_State *L );
+static int vectorL_nearestLine( lua_State *L );
 static const luaL_Reg vector_methods[] = {
    { "new", vectorL_new },
    { "newP", vectorL_newP },
@@ -57,20 +61,26 @@ static const luaL_Reg vector_methods[] = {
    { "__div", vectorL_div },
    { "div", vectorL_div__ },
    { "dot", vectorL_dot },
+   { "cross", vectorL_cross },
    { "get", vectorL_get },
    { "polar", vectorL_polar },
    { "set", vectorL_set },
    { "setP", vectorL_setP },
    { "dist", vectorL_distance },
    { "dist2", vectorL_distance2 },
+   { "dist2xy", vectorL_distance2xy },
    { "mod", vectorL_mod },
    { "angle", vectorL_angle },
    { "normalize", vectorL_normalize },
    { "collideLineLine", vectorL_collideLineLine },
    { "collideCircleLine", vectorL_collideCircleLine },
+   { "nearest", vectorL_nearest },
+   { "nearestLine", vectorL_nearestLine },
    {0,0}
 }; /**< Vector metatable methods. */
 
+static int vector_metatable = LUA_NOREF; /**< Cached reference to the vector metatable. */
+
 /**
  * @brief Loads the vector metatable.
  *
@@ -80,6 +90,7 @@ static const luaL_Reg vector_methods[] = {
 int nlua_loadVector( nlua_env env )
 {
    nlua_register(env, VECTOR_METATABLE, vector_methods, 1);
+   nlua_refMetatable( VECTOR_METATABLE, &vector_metatable );
    return 0;
 }
 
@@ -96,6 +107,10 @@ int nlua_loadVector( nlua_env env )
  * my_vec = my_vec - your_vec -- my_vec is now (19,13)
  * @endcode
  *
+ * Operators always create a new vector, while the methods such as add, sub,
+ * mul, div and normalize modify the vector in place and return it, so they
+ * don't allocate anything. Prefer the latter in code that runs often.
+ *
  * To call members of the metatable always use:
  * @code
  * vector:function( param )
@@ -140,7 +155,7 @@ vec2* lua_pushvector( lua_State *L, vec2 vec )
 {
    vec2 *v = (vec2*) lua_newuserdata(L, sizeof(vec2));
    *v = vec;
-   luaL_getmetatable(L, VECTOR_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, vector_metatable);
    lua_setmetatable(L, -2);
    return v;
 }
@@ -158,7 +173,7 @@ int lua_isvector( lua_State *L, int ind )
 
    if (lua_getmetatable(L,ind)==0)
       return 0;
-   lua_getfield(L, LUA_REGISTRYINDEX, VECTOR_METATABLE);
+   lua_rawgeti(L, LUA_REGISTRYINDEX, vector_metatable);
 
    ret = 0;
    if (lua_rawequal(L, -1, -2))  /* does it have the correct mt? */
@@ -252,14 +267,14 @@ static int vectorL_tostring( lua_State *L )
  * If x is a vector it adds both vectors, otherwise it adds cartesian coordinates
  * to the vector.
  *
- * @usage my_vec = my_vec + your_vec
- * @usage my_vec:add( your_vec )
+ * @usage my_vec = my_vec + your_vec -- Creates a new vector
+ * @usage my_vec:add( your_vec ) -- Modifies my_vec in place
  * @usage my_vec:add( 5, 3 )
  *
  *    @luatparam Vector v Vector getting stuff added to.
  *    @luatparam number|Vec2 x X coordinate or vector to add to.
  *    @luatparam number|nil y Y coordinate or nil to add to.
- *    @luatreturn Vec2 The result of the vector operation.
+ *    @luatreturn Vec2 The result of the vector operation, which is v itself when used as a method.
  * @luafunc add
  */
 static int vectorL_add( lua_State *L )
@@ -320,7 +335,7 @@ static int vectorL_add__( lua_State *L )
 
    /* Actually add it */
    vec2_cset( v1, v1->x + x, v1->y + y );
-   lua_pushvector( L, *v1 );
+   lua_pushvalue( L, 1 );
 
    return 1;
 }
@@ -331,14 +346,14 @@ static int vectorL_add__( lua_State *L )
  * If x is a vector it subtracts both vectors, otherwise it subtracts cartesian
  * coordinates to the vector.
  *
- * @usage my_vec = my_vec - your_vec
- * @usage my_vec:sub( your_vec )
+ * @usage my_vec = my_vec - your_vec -- Creates a new vector
+ * @usage my_vec:sub( your_vec ) -- Modifies my_vec in place
  * @usage my_vec:sub( 5, 3 )
  *
  *    @luatparam Vec2 v Vector getting stuff subtracted from.
  *    @luatparam number|Vec2 x X coordinate or vector to subtract.
  *    @luatparam number|nil y Y coordinate or nil to subtract.
- *    @luatreturn Vec2 The result of the vector operation.
+ *    @luatreturn Vec2 The result of the vector operation, which is v itself when used as a method.
  * @luafunc sub
  */
 static int vectorL_sub( lua_State *L )
@@ -392,19 +407,19 @@ static int vectorL_sub__( lua_State *L )
 
    /* Actually add it */
    vec2_cset( v1, v1->x - x, v1->y - y );
-   lua_pushvector( L, *v1 );
+   lua_pushvalue( L, 1 );
    return 1;
 }
 
 /**
  * @brief Multiplies a vector by a number.
  *
- * @usage my_vec = my_vec * 3
- * @usage my_vec:mul( 3 )
+ * @usage my_vec = my_vec * 3 -- Creates a new vector
+ * @usage my_vec:mul( 3 ) -- Modifies my_vec in place
  *
  *    @luatparam Vec2 v Vector to multiply.
  *    @luatparam number mod Amount to multiply by.
- *    @luatreturn Vec2 The result of the vector operation.
+ *    @luatreturn Vec2 The result of the vector operation, which is v itself when used as a method.
  * @luafunc mul
  */
 static int vectorL_mul( lua_State *L )
@@ -449,19 +464,19 @@ static int vectorL_mul__( lua_State *L )
    }
 
    /* Actually add it */
-   lua_pushvector( L, *v1 );
+   lua_pushvalue( L, 1 );
    return 1;
 }
 
 /**
  * @brief Divides a vector by a number.
  *
- * @usage my_vec = my_vec / 3
- * @usage my_vec:div(3)
+ * @usage my_vec = my_vec / 3 -- Creates a new vector
+ * @usage my_vec:div(3) -- Modifies my_vec in place
  *
  *    @luatparam Vec2 v Vector to divide.
  *    @luatparam number mod Amount to divide by.
- *    @luatreturn Vec2 The result of the vector operation.
+ *    @luatreturn Vec2 The result of the vector operation, which is v itself when used as a method.
  * @luafunc div
  */
 static int vectorL_div( lua_State *L )
@@ -497,7 +512,7 @@ static int vectorL_div__( lua_State *L )
       vec2_cset( v1, v1->x / v2->x, v1->y / v2->y );
    }
 
-   lua_pushvector( L, *v1 );
+   lua_pushvalue( L, 1 );
    return 1;
 }
 
@@ -506,7 +521,7 @@ static int vectorL_div__( lua_State *L )
  *
  *    @luatparam Vec2 a First vector.
  *    @luatparam Vec2 b Second vector.
- *    @luatreturn Vec2 The dot product.
+ *    @luatreturn number The dot product.
  * @luafunc dot
  */
 static int vectorL_dot( lua_State *L )
@@ -517,6 +532,25 @@ static int vectorL_dot( lua_State *L )
    return 1;
 }
 
+/**
+ * @brief Cross product of two vectors.
+ *
+ * Gives the z component of the cross product, which is positive when b is
+ * counter-clockwise from a.
+ *
+ *    @luatparam Vec2 a First vector.
+ *    @luatparam Vec2 b Second vector.
+ *    @luatreturn number The cross product.
+ * @luafunc cross
+ */
+static int vectorL_cross( lua_State *L )
+{
+   vec2 *a = luaL_checkvector(L,1);
+   vec2 *b = luaL_checkvector(L,2);
+   lua_pushnumber( L, a->x*b->y - a->y*b->x );
+   return 1;
+}
+
 /**
  * @brief Gets the cartesian positions of the vector.
  *
@@ -561,10 +595,11 @@ static int vectorL_polar( lua_State *L )
  * @brief Sets the vector by cartesian coordinates.
  *
  * @usage my_vec:set(5, 3) -- my_vec is now (5,3)
+ * @usage my_vec:set(your_vec) -- my_vec is now a copy of your_vec
  *
  *    @luatparam Vec2 v Vector to set coordinates of.
- *    @luatparam number x X coordinate to set.
- *    @luatparam number y Y coordinate to set.
+ *    @luatparam number|Vec2 x X coordinate or vector to set.
+ *    @luatparam number|nil y Y coordinate to set or nil if x is a vector.
  * @luafunc set
  */
 static int vectorL_set( lua_State *L )
@@ -574,8 +609,15 @@ static int vectorL_set( lua_State *L )
 
    /* Get parameters. */
    v1 = luaL_checkvector(L,1);
-   x  = luaL_checknumber(L,2);
-   y  = luaL_checknumber(L,3);
+   if (lua_isvector(L,2)) {
+      vec2 *v2 = lua_tovector(L,2);
+      x = v2->x;
+      y = v2->y;
+   }
+   else {
+      x = luaL_checknumber(L,2);
+      y = luaL_checknumber(L,3);
+   }
 
    vec2_cset( v1, x, y );
    return 0;
@@ -677,6 +719,28 @@ static int vectorL_distance2( lua_State *L )
    return 1;
 }
 
+/**
+ * @brief Gets the squared distance from the Vec2 to a point given by its coordinates.
+ *
+ * Same as dist2 but doesn't need a vector for the other point.
+ *
+ * @usage my_vec:dist2xy( 5, 3 ) -- Gets squared distance from my_vec to (5,3).
+ *
+ *    @luatparam Vec2 v Vector to act as origin.
+ *    @luatparam number x X coordinate of the point.
+ *    @luatparam number y Y coordinate of the point.
+ *    @luatreturn number The distance calculated.
+ * @luafunc dist2xy
+ */
+static int vectorL_distance2xy( lua_State *L )
+{
+   vec2 *v1 = luaL_checkvector(L,1);
+   double x = luaL_checknumber(L,2) - v1->x;
+   double y = luaL_checknumber(L,3) - v1->y;
+   lua_pushnumber(L, x*x + y*y);
+   return 1;
+}
+
 /**
  * @brief Gets the modulus of the vector.
  *    @luatparam Vec2 v Vector to get modulus of.
@@ -704,9 +768,9 @@ static int vectorL_angle( lua_State *L )
 }
 
 /**
- * @brief Normalizes a vector.
+ * @brief Normalizes a vector in place.
  *    @luatparam Vec2 v Vector to normalize.
- *    @luatreturn Vec2 Normalized vector.
+ *    @luatreturn Vec2 The vector v, now normalized.
  * @luafunc normalize
  */
 static int vectorL_normalize( lua_State *L )
@@ -715,7 +779,7 @@ static int vectorL_normalize( lua_State *L )
    double m = VMOD(*v);
    v->x /= m;
    v->y /= m;
-   lua_pushvector(L, *v);
+   lua_pushvalue(L, 1);
    return 1;
 }
 
@@ -771,3 +835,110 @@ static int vectorL_collideCircleLine( lua_State *L )
 
    return cnt;
 }
+
+/**
+ * @brief Finds the nearest vector in a list.
+ *
+ * Doesn't create any vectors, so it is much cheaper than looping over the
+ * list in Lua.
+ *
+ * @usage i, d2 = pos:nearest( positions ) -- positions[i] is nearest to pos, at squared distance d2
+ *
+ *    @luatparam Vec2 v Vector to measure from.
+ *    @luatparam {Vec2,...} list List of vectors to search.
+ *    @luatreturn number|nil Index of the nearest vector or nil if the list is empty.
+ *    @luatreturn number|nil Squared distance to the nearest vector.
+ * @luafunc nearest
+ */
+static int vectorL_nearest( lua_State *L )
+{
+   vec2 *v = luaL_checkvector(L,1);
+   int n   = -1;
+   double nd = HUGE_VAL;
+   int len;
+   luaL_checktype(L, 2, LUA_TTABLE);
+
+   len = lua_objlen(L,2);
+   for (int i=1; i<=len; i++) {
+      double d;
+      lua_rawgeti(L, 2, i);
+      d = vec2_dist2( v, luaL_checkvector(L,-1) );
+      lua_pop(L,1);
+      if (d < nd) {
+         nd = d;
+         n  = i;
+      }
+   }
+
+   if (n < 0)
+      return 0;
+   lua_pushinteger(L, n);
+   lua_pushnumber(L, nd);
+   return 2;
+}
+
+/**
+ * @brief Finds the nearest line segment in a list.
+ *
+ * Line segments are given as pairs of vectors, such as {a,b}. Only the
+ * closest point is created as a vector.
+ *
+ * @usage i, d2, p = pos:nearestLine( { {a,b}, {c,d} } )
+ *
+ *    @luatparam Vec2 v Vector to measure from.
+ *    @luatparam table list List of line segments to search.
+ *    @luatreturn number|nil Index of the nearest segment or nil if the list is empty.
+ *    @luatreturn number|nil Squared distance to the nearest segment.
+ *    @luatreturn Vec2|nil Point of the nearest segment closest to v.
+ * @luafunc nearestLine
+ */
+static int vectorL_nearestLine( lua_State *L )
+{
+   vec2 *v = luaL_checkvector(L,1);
+   vec2 np = { .x = 0., .y = 0. };
+   int n   = -1;
+   double nd = HUGE_VAL;
+   int len;
+   luaL_checktype(L, 2, LUA_TTABLE);
+
+   len = lua_objlen(L,2);
+   for (int i=1; i<=len; i++) {
+      vec2 *a, *b, p;
+      double abx, aby, ab2, t, d;
+
+      lua_rawgeti(L, 2, i);
+      if (!lua_istable(L,-1))
+         NLUA_ERROR(L, _("Line segment %d is not a table!"), i);
+      lua_rawgeti(L, -1, 1);
+      lua_rawgeti(L, -2, 2);
+      a = luaL_checkvector(L,-2);
+      b = luaL_checkvector(L,-1);
+
+      /* Closest point on the segment, clamped to its ends. */
+      abx = b->x - a->x;
+      aby = b->y - a->y;
+      ab2 = abx*abx + aby*aby;
+      if (ab2 > 0.) {
+         t = ((v->x - a->x)*abx + (v->y - a->y)*aby) / ab2;
+         t = CLAMP( 0., 1., t );
+      }
+      else
+         t = 0.;
+      vec2_cset( &p, a->x + abx*t, a->y + aby*t );
+      lua_pop(L,3);
+
+      d = vec2_dist2( v, &p );
+      if (d < nd) {
+         nd = d;
+         n  = i;
+         np = p;
+      }
+   }
+
+   if (n < 0)
+      return 0;
+   lua_pushinteger(L, n);
+   lua_pushnumber(L, nd);
+   lua_pushvector(L, np);
+   return 3;
+}
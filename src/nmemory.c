@@ -0,0 +1,283 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+/**
+ * @file nmemory.c
+ *
+ * @brief Optional accounting of memory use per subsystem.
+ *
+ * Enabled with the debug_alloc build option. Allocations made through the
+ * nmem_* functions are tagged with the subsystem they belong to, and the size
+ * actually handed out by the allocator is added to or removed from that
+ * subsystem's count, so no header is needed and mismatched frees only skew
+ * the numbers. Memory that lives outside the heap (textures, sound buffers,
+ * the Lua state) is accounted with nmem_count() and nmem_set() instead.
+ *
+ * Without the option the nmem_* functions are plain macros over the C
+ * allocator and nothing is tracked.
+ */
+/** @cond */
+#include "naev.h"
+
+#if DEBUG_ALLOC
+#if MACOS
+#include <malloc/malloc.h>
+#elif HAVE_MALLOC_H
+#include <malloc.h>
+#endif /* MACOS */
+#include <string.h>
+#include <libxml/xmlmemory.h>
+#include "SDL.h"
+#endif /* DEBUG_ALLOC */
+/** @endcond */
+
+#include "nmemory.h"
+
+#if DEBUG_ALLOC
+#include "log.h"
+#include "nstring.h"
+
+/**
+ * @brief Memory statistics of a subsystem.
+ */
+typedef struct MemStats_ {
+   size_t live;         /**< Bytes currently in use. */
+   size_t peak;         /**< Most bytes in use at once. */
+   size_t allocs;       /**< Number of allocations made. */
+   size_t total;        /**< Bytes allocated over time. */
+   size_t last_allocs;  /**< Allocations made at the last report. */
+   size_t last_total;   /**< Bytes allocated at the last report. */
+} MemStats;
+
+static MemStats nmem_stats[MEM_TAG_MAX]; /**< Statistics of each subsystem. */
+static SDL_SpinLock nmem_lock = 0; /**< Protects the statistics, as loading is threaded. */
+static Uint32 nmem_lastReport = 0; /**< Ticks at the last report. */
+
+/**
+ * @brief Names of the subsystems, in MemTag order.
+ */
+static const char *nmem_names[MEM_TAG_MAX] = {
+   "arrays",
+   "textures",
+   "lua",
+   "pilots",
+   "weapons",
+   "trails",
+   "sounds",
+   "xml",
+};
+
+/*
+ * Prototypes.
+ */
+static size_t nmem_size( void *ptr );
+static void nmem_add( MemTag tag, size_t bytes, int alloc );
+static void nmem_sub( MemTag tag, size_t bytes );
+static void nmem_xmlFree( void *ptr );
+static void *nmem_xmlMalloc( size_t size );
+static void *nmem_xmlRealloc( void *ptr, size_t size );
+static char *nmem_xmlStrdup( const char *str );
+
+/**
+ * @brief Gets the size the allocator actually handed out for a pointer.
+ */
+static size_t nmem_size( void *ptr )
+{
+   if (ptr == NULL)
+      return 0;
+#if WIN32
+   return _msize( ptr );
+#elif MACOS
+   return malloc_size( ptr );
+#else /* WIN32 */
+   return malloc_usable_size( ptr );
+#endif /* WIN32 */
+}
+
+/**
+ * @brief Accounts bytes to a subsystem.
+ *
+ *    @param tag Subsystem to account to.
+ *    @param bytes Bytes to add.
+ *    @param alloc Whether or not it counts as a new allocation.
+ */
+static void nmem_add( MemTag tag, size_t bytes, int alloc )
+{
+   MemStats *s = &nmem_stats[tag];
+   SDL_AtomicLock( &nmem_lock );
+   s->live  += bytes;
+   s->total += bytes;
+   s->allocs += alloc;
+   if (s->live > s->peak)
+      s->peak = s->live;
+   SDL_AtomicUnlock( &nmem_lock );
+}
+
+/**
+ * @brief Removes bytes from a subsystem.
+ */
+static void nmem_sub( MemTag tag, size_t bytes )
+{
+   MemStats *s = &nmem_stats[tag];
+   SDL_AtomicLock( &nmem_lock );
+   s->live -= MIN( s->live, bytes );
+   SDL_AtomicUnlock( &nmem_lock );
+}
+
+/**
+ * @brief Sets up the memory accounting.
+ *
+ * Has to be run before libxml2 is used, as its allocations are routed through
+ * here.
+ */
+void nmem_init (void)
+{
+   memset( nmem_stats, 0, sizeof(nmem_stats) );
+   nmem_lastReport = SDL_GetTicks();
+   xmlMemSetup( nmem_xmlFree, nmem_xmlMalloc, nmem_xmlRealloc, nmem_xmlStrdup );
+}
+
+/**
+ * @brief Tracked malloc.
+ */
+void *nmem_malloc( MemTag tag, size_t size )
+{
+   void *ptr = malloc( size );
+   nmem_add( tag, nmem_size(ptr), 1 );
+   return ptr;
+}
+
+/**
+ * @brief Tracked calloc.
+ */
+void *nmem_calloc( MemTag tag, size_t nmemb, size_t size )
+{
+   void *ptr = calloc( nmemb, size );
+   nmem_add( tag, nmem_size(ptr), 1 );
+   return ptr;
+}
+
+/**
+ * @brief Tracked realloc.
+ */
+void *nmem_realloc( MemTag tag, void *ptr, size_t size )
+{
+   size_t old = nmem_size( ptr );
+   void *new = realloc( ptr, size );
+   if ((new == NULL) && (size > 0))
+      return NULL;
+   nmem_sub( tag, old );
+   nmem_add( tag, nmem_size(new), 1 );
+   return new;
+}
+
+/**
+ * @brief Tracked free.
+ */
+void nmem_free( MemTag tag, void *ptr )
+{
+   if (ptr == NULL)
+      return;
+   nmem_sub( tag, nmem_size(ptr) );
+   free( ptr );
+}
+
+/**
+ * @brief Accounts memory that doesn't live on the heap, like GPU memory.
+ *
+ *    @param tag Subsystem to account to.
+ *    @param bytes Bytes allocated, or freed if negative.
+ */
+void nmem_count( MemTag tag, long bytes )
+{
+   if (bytes >= 0)
+      nmem_add( tag, bytes, 1 );
+   else
+      nmem_sub( tag, -bytes );
+}
+
+/**
+ * @brief Sets how much memory a subsystem uses when it is sampled.
+ *
+ *    @param tag Subsystem to set.
+ *    @param bytes Bytes currently in use.
+ */
+void nmem_set( MemTag tag, size_t bytes )
+{
+   MemStats *s = &nmem_stats[tag];
+   size_t live = s->live;
+   if (bytes > live)
+      nmem_add( tag, bytes-live, 0 );
+   else
+      nmem_sub( tag, live-bytes );
+}
+
+/**
+ * @brief Writes a report of the memory use of each subsystem.
+ *
+ * Rates are measured since the previous report.
+ *
+ *    @param[out] buf Buffer to write to.
+ *    @param size Size of the buffer.
+ */
+void nmem_report( char *buf, int size )
+{
+   Uint32 t = SDL_GetTicks();
+   double dt = MAX( 1e-3, (double)(t - nmem_lastReport) / 1000. );
+   size_t live = 0;
+   int l;
+
+   nmem_lastReport = t;
+   l = scnprintf( buf, size, "%-10s %12s %12s %12s %12s",
+         _("Subsystem"), _("Live KiB"), _("Peak KiB"), _("Allocs/s"), _("KiB/s") );
+   SDL_AtomicLock( &nmem_lock );
+   for (int i=0; i<MEM_TAG_MAX; i++) {
+      MemStats *s = &nmem_stats[i];
+      l += scnprintf( &buf[l], size-l, "\n%-10s %12.1f %12.1f %12.1f %12.1f",
+            nmem_names[i], s->live / 1024., s->peak / 1024.,
+            (s->allocs - s->last_allocs) / dt,
+            (s->total - s->last_total) / 1024. / dt );
+      s->last_allocs = s->allocs;
+      s->last_total  = s->total;
+      live += s->live;
+   }
+   SDL_AtomicUnlock( &nmem_lock );
+   scnprintf( &buf[l], size-l, "\n%-10s %12.1f", _("total"), live / 1024. );
+}
+
+/**
+ * @brief libxml2 free.
+ */
+static void nmem_xmlFree( void *ptr )
+{
+   nmem_free( MEM_XML, ptr );
+}
+
+/**
+ * @brief libxml2 malloc.
+ */
+static void *nmem_xmlMalloc( size_t size )
+{
+   return nmem_malloc( MEM_XML, size );
+}
+
+/**
+ * @brief libxml2 realloc.
+ */
+static void *nmem_xmlRealloc( void *ptr, size_t size )
+{
+   return nmem_realloc( MEM_XML, ptr, size );
+}
+
+/**
+ * @brief libxml2 strdup.
+ */
+static char *nmem_xmlStrdup( const char *str )
+{
+   size_t len = strlen( str ) + 1;
+   char *dup = nmem_malloc( MEM_XML, len );
+   if (dup != NULL)
+      memcpy( dup, str, len );
+   return dup;
+}
+#endif /* DEBUG_ALLOC */
@@ -0,0 +1,42 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+#pragma once
+
+/** @cond */
+#include <stdlib.h>
+/** @endcond */
+
+/**
+ * @brief Subsystems memory is accounted to.
+ */
+typedef enum MemTag_ {
+   MEM_ARRAY,     /**< Arrays from array.h. */
+   MEM_TEXTURE,   /**< OpenGL textures. */
+   MEM_LUA,       /**< Lua state. */
+   MEM_PILOT,     /**< Pilots. */
+   MEM_WEAPON,    /**< Weapons. */
+   MEM_TRAIL,     /**< Trails. */
+   MEM_SOUND,     /**< Sound buffers. */
+   MEM_XML,       /**< libxml2. */
+   MEM_TAG_MAX,   /**< Number of tags. */
+} MemTag;
+
+#if DEBUG_ALLOC
+void nmem_init (void);
+void *nmem_malloc( MemTag tag, size_t size );
+void *nmem_calloc( MemTag tag, size_t nmemb, size_t size );
+void *nmem_realloc( MemTag tag, void *ptr, size_t size );
+void nmem_free( MemTag tag, void *ptr );
+void nmem_count( MemTag tag, long bytes );
+void nmem_set( MemTag tag, size_t bytes );
+void nmem_report( char *buf, int size );
+#else /* DEBUG_ALLOC */
+#define nmem_init()                       ((void)0)
+#define nmem_malloc(tag,size)             malloc(size)
+#define nmem_calloc(tag,nmemb,size)       calloc(nmemb,size)
+#define nmem_realloc(tag,ptr,size)        realloc(ptr,size)
+#define nmem_free(tag,ptr)                free(ptr)
+#define nmem_count(tag,bytes)             ((void)0)
+#define nmem_set(tag,bytes)               ((void)0)
+#endif /* DEBUG_ALLOC */
@@ -88,17 +88,18 @@
 /* Hack for better leak tracing: tools like LeakSanitizer can't trace past xmlGetProp(),
  * but there's no issue if we duplicate the string ourselves. */
 
-#if DEBUGGING
+/* Memory accounting also needs libxml2 memory to be freed with xmlFree(). */
+#if DEBUGGING || DEBUG_ALLOC
 static inline char* nxml_trace_strdup( void* ptr )
 {
    void *pointer_from_libxml2 = ptr;
    char *ret = (ptr == NULL) ? NULL : strdup(ptr);
-   free( pointer_from_libxml2 );
+   xmlFree( pointer_from_libxml2 );
    return ret;
 }
-#else
+#else /* DEBUGGING || DEBUG_ALLOC */
 #define nxml_trace_strdup(ptr)         ((char*) (ptr))
-#endif /* DEBUGGING */
+#endif /* DEBUGGING || DEBUG_ALLOC */
 
 /* Attribute reader (allocates memory). */
 #define xmlr_attr_strd(n,s,a)          a = nxml_trace_strdup( xmlGetProp( n, (xmlChar*)s ) )
@@ -29,6 +29,7 @@
 
 #include "opengl_render.h"
 
+#include "array.h"
 #include "camera.h"
 #include "conf.h"
 #include "gui.h"
@@ -48,6 +49,34 @@ static gl_vbo *gl_triangleVBO = 0;
 static int gl_renderVBOtexOffset = 0; /**< VBO texture offset. */
 static int gl_renderVBOcolOffset = 0; /**< VBO colour offset. */
 
+/**
+ * @brief A single textured quad queued in the sprite batch.
+ */
+typedef struct glBatchSprite_ {
+   GLuint tex;             /**< Texture to render. */
+   GLuint tex2;            /**< Texture to interpolate with (same as tex when not interpolating). */
+   int idx;                /**< Insertion order, used to keep sorting stable. */
+   GLfloat vertex[4][2];   /**< Screen coordinates of the corners. */
+   GLfloat tex_coord[4][2];/**< Texture coordinates of the corners. */
+   GLfloat inter;          /**< Interpolation between tex and tex2. */
+   glColour c;             /**< Colour modifier. */
+} glBatchSprite;
+#define OPENGL_BATCH_VERTEX_SIZE 9 /**< Floats per vertex: position(2), texture(2), colour(4), interpolation(1). */
+static int gl_batchActive        = 0;   /**< Whether or not texture rendering is being batched. */
+static glBatchSprite *gl_batch   = NULL;/**< Queued sprites. */
+static GLfloat *gl_batchData     = NULL;/**< Vertex data for the batch VBO. */
+static gl_vbo *gl_batchVBO       = NULL;/**< Batch VBO. */
+static GLsizei gl_batchVBOSize   = 0;   /**< Current size of the batch VBO. */
+static void gl_batchAdd( GLuint tex, GLuint tex2, uint8_t flags,
+      double x, double y, double w, double h,
+      double tx, double ty, double tw, double th,
+      const glColour *c, double angle, double inter );
+static int gl_batchCmp( const void *p1, const void *p2 );
+
+/* Statistics. */
+unsigned int gl_drawCalls              = 0; /**< Draw calls so far this frame. */
+static unsigned int gl_drawCallsLast   = 0; /**< Draw calls done last frame. */
+
 void gl_beginSolidProgram(mat4 projection, const glColour *c)
 {
    glUseProgram(shaders.solid.program);
@@ -133,6 +162,7 @@ void gl_renderRectH( const mat4 *H, const glColour *c, int filled )
       gl_vboActivateAttribOffset( gl_squareEmptyVBO, shaders.solid.vertex, 0, 2, GL_FLOAT, 0 );
       glDrawArrays( GL_LINE_STRIP, 0, 5 );
    }
+   gl_drawCalls++;
    gl_endSolidProgram();
 }
 
@@ -172,6 +202,7 @@ void gl_renderTriangleEmpty( double x, double y, double a, double s, double leng
    gl_beginSolidProgram(projection, c);
    gl_vboActivateAttribOffset( gl_triangleVBO, shaders.solid.vertex, 0, 2, GL_FLOAT, 0 );
    glDrawArrays( GL_LINE_STRIP, 0, 4 );
+   gl_drawCalls++;
    gl_endSolidProgram();
 }
 
@@ -200,6 +231,12 @@ void gl_renderTextureRaw( GLuint texture, uint8_t flags,
    double hw, hh;
    mat4 projection, tex_mat;
 
+   /* Defer to the batch if active. */
+   if (gl_batchActive) {
+      gl_batchAdd( texture, texture, flags, x, y, w, h, tx, ty, tw, th, c, angle, 1. );
+      return;
+   }
+
    glUseProgram(shaders.texture.program);
 
    /* Bind the texture. */
@@ -240,6 +277,7 @@ void gl_renderTextureRaw( GLuint texture, uint8_t flags,
 
    /* Draw. */
    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   gl_drawCalls++;
 
    /* Clear state. */
    glDisableVertexAttribArray( shaders.texture.vertex );
@@ -314,6 +352,12 @@ void gl_renderTextureInterpolate(  const glTexture* ta,
 
    mat4 projection, tex_mat;
 
+   /* Defer to the batch if active. */
+   if (gl_batchActive) {
+      gl_batchAdd( ta->texture, tb->texture, ta->flags, x, y, w, h, tx, ty, tw, th, c, 0., inter );
+      return;
+   }
+
    glUseProgram(shaders.texture_interpolate.program);
 
    /* Bind the textures. */
@@ -349,6 +393,7 @@ void gl_renderTextureInterpolate(  const glTexture* ta,
 
    /* Draw. */
    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   gl_drawCalls++;
 
    /* Clear state. */
    glDisableVertexAttribArray( shaders.texture_interpolate.vertex );
@@ -359,6 +404,194 @@ void gl_renderTextureInterpolate(  const glTexture* ta,
    glUseProgram(0);
 }
 
+/**
+ * @brief Starts batching texture rendering.
+ *
+ * While batching, all the calls that end up in gl_renderTextureRaw() or
+ * gl_renderTextureInterpolate() are queued instead of drawn. They are then
+ * sorted by texture and drawn with as few draw calls as possible when
+ * gl_batchEnd() is called. Rendering order is only kept between sprites that
+ * share textures, so it should only be used for layers where sprites do not
+ * depend on the order they are drawn in.
+ */
+void gl_batchBegin (void)
+{
+   if (gl_batchActive)
+      gl_batchEnd();
+   if (gl_batch == NULL)
+      gl_batch = array_create( glBatchSprite );
+   array_resize( &gl_batch, 0 );
+   gl_batchActive = 1;
+}
+
+/**
+ * @brief Queues a texture in the sprite batch.
+ *
+ * Parameters are the same as gl_renderTextureRaw().
+ */
+static void gl_batchAdd( GLuint tex, GLuint tex2, uint8_t flags,
+      double x, double y, double w, double h,
+      double tx, double ty, double tw, double th,
+      const glColour *c, double angle, double inter )
+{
+   const GLfloat u[4] = { 0., 1., 0., 1. };
+   const GLfloat v[4] = { 0., 0., 1., 1. };
+   double hw, hh, ca, sa;
+   glBatchSprite *spr = &array_grow( &gl_batch );
+
+   spr->tex    = tex;
+   spr->tex2   = tex2;
+   spr->idx    = array_size(gl_batch)-1;
+   spr->inter  = inter;
+   spr->c      = (c==NULL) ? cWhite : *c;
+
+   hw = w/2.;
+   hh = h/2.;
+   if (angle != 0.) {
+      ca = cos(angle);
+      sa = sin(angle);
+   }
+   else {
+      ca = 1.;
+      sa = 0.;
+   }
+   for (int i=0; i<4; i++) {
+      /* Same transformation as gl_renderTextureRaw(), but done on the CPU. */
+      double px = u[i]*w - hw;
+      double py = v[i]*h - hh;
+      double ty2 = ty + v[i]*th;
+      spr->vertex[i][0] = x + hw + ca*px - sa*py;
+      spr->vertex[i][1] = y + hh + sa*px + ca*py;
+      spr->tex_coord[i][0] = tx + u[i]*tw;
+      spr->tex_coord[i][1] = (flags & OPENGL_TEX_VFLIP) ? 1.-ty2 : ty2;
+   }
+}
+
+/**
+ * @brief Compares two queued sprites to group them by texture.
+ */
+static int gl_batchCmp( const void *p1, const void *p2 )
+{
+   const glBatchSprite *s1 = p1;
+   const glBatchSprite *s2 = p2;
+   if (s1->tex != s2->tex)
+      return (s1->tex < s2->tex) ? -1 : +1;
+   if (s1->tex2 != s2->tex2)
+      return (s1->tex2 < s2->tex2) ? -1 : +1;
+   return s1->idx - s2->idx;
+}
+
+/**
+ * @brief Stops batching and renders all the queued sprites.
+ */
+void gl_batchEnd (void)
+{
+   /* Triangle list corners for each quad. */
+   const int corners[6] = { 0, 1, 2, 1, 3, 2 };
+   const GLsizei stride = sizeof(GLfloat) * OPENGL_BATCH_VERTEX_SIZE;
+   int n, start;
+   GLsizei size;
+
+   if (!gl_batchActive)
+      return;
+   gl_batchActive = 0;
+   n = array_size(gl_batch);
+   if (n <= 0)
+      return;
+
+   /* Group by texture. */
+   qsort( gl_batch, n, sizeof(glBatchSprite), gl_batchCmp );
+
+   /* Generate the vertex data. */
+   size = stride * 6 * n;
+   if (size > gl_batchVBOSize) {
+      gl_batchVBOSize = size;
+      gl_batchData = realloc( gl_batchData, size );
+      gl_vboData( gl_batchVBO, size, NULL );
+   }
+   for (int i=0; i<n; i++) {
+      const glBatchSprite *spr = &gl_batch[i];
+      for (int j=0; j<6; j++) {
+         GLfloat *d = &gl_batchData[ (6*i+j) * OPENGL_BATCH_VERTEX_SIZE ];
+         int k = corners[j];
+         d[0] = spr->vertex[k][0];
+         d[1] = spr->vertex[k][1];
+         d[2] = spr->tex_coord[k][0];
+         d[3] = spr->tex_coord[k][1];
+         d[4] = spr->c.r;
+         d[5] = spr->c.g;
+         d[6] = spr->c.b;
+         d[7] = spr->c.a;
+         d[8] = spr->inter;
+      }
+   }
+   gl_vboSubData( gl_batchVBO, 0, size, gl_batchData );
+
+   /* Set up the program. */
+   glUseProgram( shaders.texture_batch.program );
+   glEnableVertexAttribArray( shaders.texture_batch.vertex );
+   glEnableVertexAttribArray( shaders.texture_batch.vertex_tex );
+   glEnableVertexAttribArray( shaders.texture_batch.vertex_color );
+   glEnableVertexAttribArray( shaders.texture_batch.vertex_inter );
+   gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.vertex,
+         0, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.vertex_tex,
+         sizeof(GLfloat)*2, 2, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.vertex_color,
+         sizeof(GLfloat)*4, 4, GL_FLOAT, stride );
+   gl_vboActivateAttribOffset( gl_batchVBO, shaders.texture_batch.vertex_inter,
+         sizeof(GLfloat)*8, 1, GL_FLOAT, stride );
+   gl_uniformMat4( shaders.texture_batch.projection, &gl_view_matrix );
+   glUniform1i( shaders.texture_batch.sampler1, 0 );
+   glUniform1i( shaders.texture_batch.sampler2, 1 );
+
+   /* One draw call per texture pair. */
+   start = 0;
+   for (int i=1; i<=n; i++) {
+      if ((i < n) && (gl_batch[i].tex == gl_batch[start].tex) &&
+            (gl_batch[i].tex2 == gl_batch[start].tex2))
+         continue;
+      glActiveTexture( GL_TEXTURE1 );
+      glBindTexture( GL_TEXTURE_2D, gl_batch[start].tex2 );
+      glActiveTexture( GL_TEXTURE0 );
+      glBindTexture( GL_TEXTURE_2D, gl_batch[start].tex );
+      glDrawArrays( GL_TRIANGLES, 6*start, 6*(i-start) );
+      gl_drawCalls++;
+      start = i;
+   }
+
+   /* Clear state. */
+   glDisableVertexAttribArray( shaders.texture_batch.vertex );
+   glDisableVertexAttribArray( shaders.texture_batch.vertex_tex );
+   glDisableVertexAttribArray( shaders.texture_batch.vertex_color );
+   glDisableVertexAttribArray( shaders.texture_batch.vertex_inter );
+   glUseProgram(0);
+
+   /* anything failed? */
+   gl_checkErr();
+
+   array_resize( &gl_batch, 0 );
+}
+
+/**
+ * @brief Marks the start of a new frame for the render statistics.
+ */
+void gl_renderStatsReset (void)
+{
+   gl_drawCallsLast = gl_drawCalls;
+   gl_drawCalls = 0;
+}
+
+/**
+ * @brief Gets the number of draw calls done in the last frame.
+ *
+ *    @return Number of draw calls done in the last complete frame.
+ */
+unsigned int gl_renderStatsDrawCalls (void)
+{
+   return gl_drawCallsLast;
+}
+
 /**
  * @brief Converts in-game coordinates to screen coordinates.
  *
@@ -910,6 +1143,7 @@ void gl_renderShaderH( const SimpleShader *shd, const mat4 *H, const glColour *c
    gl_uniformMat4(shd->projection, H);
 
    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   gl_drawCalls++;
 
    glDisableVertexAttribArray(shd->vertex);
    glUseProgram(0);
@@ -1066,6 +1300,10 @@ int gl_initRender (void)
    vertex[7] = vertex[1];
    gl_triangleVBO = gl_vboCreateStatic( sizeof(GLfloat) * 8, vertex );
 
+   /* Sprite batching. */
+   gl_batchVBO = gl_vboCreateStream( 0, NULL );
+   gl_batchVBOSize = 0;
+
    gl_checkErr();
 
    return 0;
@@ -1083,5 +1321,15 @@ void gl_exitRender (void)
    gl_vboDestroy( gl_squareEmptyVBO );
    gl_vboDestroy( gl_lineVBO );
    gl_vboDestroy( gl_triangleVBO );
+   gl_vboDestroy( gl_batchVBO );
    gl_renderVBO = NULL;
+   gl_batchVBO = NULL;
+
+   /* Clean up the batch. */
+   array_free( gl_batch );
+   gl_batch = NULL;
+   free( gl_batchData );
+   gl_batchData = NULL;
+   gl_batchVBOSize = 0;
+   gl_batchActive = 0;
 }
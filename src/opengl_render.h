@@ -123,3 +123,12 @@ void gl_renderTriangleEmpty( double x, double y, double a, double s, double leng
 /* Clipping. */
 void gl_clipRect( int x, int y, int w, int h );
 void gl_unclipRect (void);
+
+/* Sprite batching. */
+void gl_batchBegin (void);
+void gl_batchEnd (void);
+
+/* Statistics. */
+extern unsigned int gl_drawCalls;
+void gl_renderStatsReset (void);
+unsigned int gl_renderStatsDrawCalls (void);
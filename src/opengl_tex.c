@@ -21,6 +21,7 @@
 #include "log.h"
 #include "md5.h"
 #include "nfile.h"
+#include "nmemory.h"
 #include "nstring.h"
 #include "opengl.h"
 
@@ -43,6 +44,8 @@ typedef struct glTexList_ {
 } glTexList;
 static glTexList* texture_list = NULL; /**< Texture list. */
 
+#define TEX_BYTES(t) ((long)((t)->w * (t)->h * 4.)) /**< Approximate GPU memory used by an RGBA8 texture. */
+
 /*
  * prototypes
  */
@@ -50,6 +53,7 @@ static glTexList* texture_list = NULL; /**< Texture list. */
 static int SDL_IsTrans( SDL_Surface* s, int x, int y );
 static uint8_t* SDL_MapTrans( SDL_Surface* s, int w, int h );
 static size_t gl_transSize( const int w, const int h );
+static void gl_texMapMask( glTexture *t );
 /* glTexture */
 static GLuint gl_texParameters( unsigned int flags );
 static GLuint gl_loadSurface( SDL_Surface* surface, unsigned int flags, int freesur );
@@ -143,6 +147,58 @@ static uint8_t* SDL_MapTrans( SDL_Surface* s, int w, int h )
    return t;
 }
 
+/**
+ * @brief Builds the per-sprite collision bitmasks from the transparency map.
+ *
+ * Each sprite gets its rows packed into 64-bit words, using the same flipped
+ *  coordinates as the collision code, plus the tight bounding box of its
+ *  opaque pixels so collisions can be rejected early.
+ *
+ *    @param t Texture to build the masks of (must have a transparency map).
+ */
+static void gl_texMapMask( glTexture *t )
+{
+   int sx, sy, sw, sh, w, words;
+
+   sx    = (int)t->sx;
+   sy    = (int)t->sy;
+   sw    = (int)t->sw;
+   sh    = (int)t->sh;
+   w     = (int)t->w;
+   words = (sw+63) / 64;
+
+   free( t->mask );
+   free( t->mask_box );
+   t->mask_words = words;
+   t->mask     = calloc( (size_t)sx*sy*sh*words, sizeof(uint64_t) );
+   t->mask_box = malloc( 4*sx*sy*sizeof(int) );
+
+   for (int j=0; j<sy; j++) {
+      /* Sprites are flipped vertically in the transparency map. */
+      int ty = (sy-j-1)*sh;
+      for (int i=0; i<sx; i++) {
+         int *box = &t->mask_box[ 4*(j*sx+i) ];
+         box[0] = sw;
+         box[1] = sh;
+         box[2] = -1;
+         box[3] = -1;
+         for (int y=0; y<sh; y++) {
+            uint64_t *row = &t->mask[ ((size_t)(j*sx+i)*sh + y) * words ];
+            for (int x=0; x<sw; x++) {
+               size_t k = (size_t)(ty+y)*w + i*sw + x;
+               if (!(t->trans[ k/8 ] & (1 << (k%8))))
+                  continue;
+               row[ x/64 ] |= (uint64_t)1 << (x%64);
+               box[0] = MIN( box[0], x );
+               box[1] = MIN( box[1], y );
+               box[2] = MAX( box[2], x );
+               box[3] = MAX( box[3], y );
+            }
+         }
+      }
+   }
+}
+
 /*
  * @brief Gets the size needed for a transparency map.
  *
@@ -425,6 +481,8 @@ glTexture* gl_loadImagePadTrans( const char *name, SDL_Surface* surface, SDL_RWo
    else if (freesur)
       SDL_FreeSurface( surface );
    texture->trans = trans;
+   if (trans != NULL)
+      gl_texMapMask( texture );
    return texture;
 }
 
@@ -449,8 +507,11 @@ glTexture* gl_loadImagePad( const char *name, SDL_Surface* surface,
    /* Make sure doesn't already exist. */
    if ((name != NULL) && !(flags & OPENGL_TEX_SKIPCACHE)) {
       texture = gl_texExists( name, sx, sy );
-      if (texture != NULL)
+      if (texture != NULL) {
+         if (freesur)
+            SDL_FreeSurface( surface );
          return texture;
+      }
    }
 
    if (flags & OPENGL_TEX_MAPTRANS)
@@ -545,6 +606,7 @@ static int gl_texAdd( glTexture *tex, int sx, int sy )
    new->tex  = tex;
    new->sx   = sx;
    new->sy   = sy;
+   nmem_count( MEM_TEXTURE, TEX_BYTES(tex) );
 
    if (texture_list == NULL) /* special condition - creating new list */
       texture_list = new;
@@ -766,8 +828,11 @@ void gl_freeTexture( glTexture *texture )
          cur->used--;
          if (cur->used <= 0) { /* not used anymore */
             /* free the texture */
+            nmem_count( MEM_TEXTURE, -TEX_BYTES(texture) );
             glDeleteTextures( 1, &texture->texture );
             free(texture->trans);
+            free(texture->mask);
+            free(texture->mask_box);
             free(texture->name);
             free(texture);
 
@@ -794,6 +859,8 @@ void gl_freeTexture( glTexture *texture )
    /* Free anyways */
    glDeleteTextures( 1, &texture->texture );
    free(texture->trans);
+   free(texture->mask);
+   free(texture->mask_box);
    free(texture->name);
    free(texture);
 
@@ -49,6 +49,9 @@ typedef struct glTexture_ {
    /* data */
    GLuint texture; /**< the opengl texture itself */
    uint8_t* trans; /**< maps the transparency */
+   uint64_t* mask; /**< Opaque pixels of each sprite as rows of 64-bit words. */
+   int* mask_box; /**< Tight bounding box (x1,y1,x2,y2) of each sprite's opaque pixels. */
+   int mask_words; /**< Number of words per sprite row in mask. */
 
    /* properties */
    uint8_t flags; /**< flags used for texture properties */
@@ -23,6 +23,7 @@
 #include "array.h"
 #include "conf.h"
 #include "damagetype.h"
+#include "intern.h"
 #include "log.h"
 #include "mapData.h"
 #include "ndata.h"
@@ -48,11 +49,13 @@
 #define XML_OUTFIT_TAG     "outfit"    /**< XML section identifier. */
 
 #define OUTFIT_SHORTDESC_MAX  STRMAX_SHORT /**< Max length of the short description of the outfit. */
+#define OUTFIT_GFX_STORE_TIMEOUT (5*60*1000) /**< Milliseconds before an unused store graphic is freed. */
 
 /*
  * the stack
  */
 static Outfit* outfit_stack = NULL; /**< Stack of outfits. */
+static int *outfit_idmap = NULL; /**< Array (array.h): Maps interned outfit names to outfit_stack indices. */
 static char **license_stack = NULL; /**< Stack of available licenses. */
 
 /*
@@ -131,8 +134,10 @@ const Outfit* outfit_get( const char* name )
  */
 const Outfit* outfit_getW( const char* name )
 {
-   const Outfit s = {.name = (char*)name };
-   return bsearch( &s, outfit_stack, array_size(outfit_stack), sizeof(Outfit), outfit_cmp );
+   int id = intern_mapGet( outfit_idmap, name );
+   if (id < 0)
+      return NULL;
+   return &outfit_stack[id];
 }
 
 /**
@@ -608,6 +613,37 @@ const glTexture* outfit_gfx( const Outfit* o )
    else if (outfit_isLauncher(o)) return o->u.lau.gfx_space;
    return NULL;
 }
+/**
+ * @brief Gets the outfit's store graphic, loading it if necessary.
+ *    @param o Outfit to get information from.
+ *    @return The store graphic of the outfit (not duplicated).
+ */
+glTexture* outfit_gfxStore( const Outfit *o )
+{
+   Outfit *temp = (Outfit*) o;
+   if ((temp->gfx_store == NULL) && (temp->gfx_store_path != NULL))
+      temp->gfx_store = gl_newImage( temp->gfx_store_path, OPENGL_TEX_MIPMAPS );
+   temp->gfx_store_used = SDL_GetTicks();
+   return temp->gfx_store;
+}
+/**
+ * @brief Frees the store graphics that have not been used for a while.
+ *
+ * Anything still holding a duplicate of the texture keeps it alive.
+ */
+void outfit_gfxStoreEvict (void)
+{
+   Uint32 t = SDL_GetTicks();
+   for (int i=0; i<array_size(outfit_stack); i++) {
+      Outfit *o = &outfit_stack[i];
+      if (o->gfx_store == NULL)
+         continue;
+      if (t - o->gfx_store_used < OUTFIT_GFX_STORE_TIMEOUT)
+         continue;
+      gl_freeTexture( o->gfx_store );
+      o->gfx_store = NULL;
+   }
+}
 /**
  * @brief Gets the outfit's collision polygon.
  *    @param o Outfit to get information from.
@@ -2233,6 +2269,7 @@ static int outfit_parse( Outfit* temp, const char* file )
    temp->lua_init       = LUA_NOREF;
    temp->lua_cleanup    = LUA_NOREF;
    temp->lua_update     = LUA_NOREF;
+   temp->lua_update_all = LUA_NOREF;
    temp->lua_ontoggle   = LUA_NOREF;
    temp->lua_onhit      = LUA_NOREF;
    temp->lua_outofenergy = LUA_NOREF;
@@ -2286,8 +2323,15 @@ static int outfit_parse( Outfit* temp, const char* file )
                continue;
             }
             else if (xml_isNode(cur,"gfx_store")) {
-               temp->gfx_store = xml_parseTexture( cur,
-                     OUTFIT_GFX_PATH"store/%s", 1, 1, OPENGL_TEX_MIPMAPS );
+               /* Loaded on demand by outfit_gfxStore(). */
+               char *buf = xml_get(cur);
+               if (buf != NULL) {
+                  free( temp->gfx_store_path );
+                  if (buf[0]=='/')
+                     temp->gfx_store_path = strdup( buf );
+                  else
+                     asprintf( &temp->gfx_store_path, OUTFIT_GFX_PATH"store/%s", buf );
+               }
                continue;
             }
             else if (xml_isNode(cur,"gfx_overlays")) {
@@ -2462,7 +2506,7 @@ if (o) WARN( _("Outfit '%s' missing/invalid '%s' element"), temp->name, s) /**<
    MELEMENT(temp->name==NULL,"name");
    MELEMENT(temp->slot.type==OUTFIT_SLOT_NULL,"slot");
    MELEMENT((temp->slot.type!=OUTFIT_SLOT_NA) && (temp->slot.size==OUTFIT_SLOT_SIZE_NA),"size");
-   MELEMENT(temp->gfx_store==NULL,"gfx_store");
+   MELEMENT(temp->gfx_store_path==NULL,"gfx_store");
    /*MELEMENT(temp->mass==0,"mass"); Not really needed */
    MELEMENT(temp->type==0,"type");
    /*MELEMENT(temp->price==0,"price");*/
@@ -2519,6 +2563,8 @@ int outfit_load (void)
    noutfits = array_size(outfit_stack);
    /* Sort up licenses. */
    qsort( outfit_stack, noutfits, sizeof(Outfit), outfit_cmp );
+   for (int i=0; i<noutfits; i++)
+      intern_mapSet( &outfit_idmap, outfit_stack[i].name, i );
    if (license_stack != NULL)
       qsort( license_stack, array_size(license_stack), sizeof(char*), strsort );
 
@@ -2562,6 +2608,7 @@ int outfit_load (void)
       o->lua_init       = nlua_refenvtype( env, "init",     LUA_TFUNCTION );
       o->lua_cleanup    = nlua_refenvtype( env, "cleanup",  LUA_TFUNCTION );
       o->lua_update     = nlua_refenvtype( env, "update",   LUA_TFUNCTION );
+      o->lua_update_all = nlua_refenvtype( env, "update_all", LUA_TFUNCTION );
       o->lua_ontoggle   = nlua_refenvtype( env, "ontoggle", LUA_TFUNCTION );
       o->lua_onhit      = nlua_refenvtype( env, "onhit",    LUA_TFUNCTION );
       o->lua_outofenergy= nlua_refenvtype( env, "outofenergy",LUA_TFUNCTION );
@@ -2775,20 +2822,16 @@ void outfit_free (void)
 
       if (outfit_isLauncher(o)) {
          /* Free collision polygons. */
-         for (int j=0; j<array_size(o->u.lau.polygon); j++) {
-            free(o->u.lau.polygon[j].x);
-            free(o->u.lau.polygon[j].y);
-         }
+         for (int j=0; j<array_size(o->u.lau.polygon); j++)
+            FreePolygon( &o->u.lau.polygon[j] );
          array_free(o->u.lau.polygon);
       }
       /* Type specific. */
       else if (outfit_isBolt(o)) {
          gl_freeTexture(o->u.blt.gfx_end);
          /* Free collision polygons. */
-         for (int j=0; j<array_size(o->u.blt.polygon); j++) {
-            free(o->u.blt.polygon[j].x);
-            free(o->u.blt.polygon[j].y);
-         }
+         for (int j=0; j<array_size(o->u.blt.polygon); j++)
+            FreePolygon( &o->u.blt.polygon[j] );
          array_free(o->u.blt.polygon);
       }
       else if (outfit_isFighterBay(o))
@@ -2819,6 +2862,7 @@ void outfit_free (void)
       free(o->condstr);
       free(o->name);
       gl_freeTexture(o->gfx_store);
+      free(o->gfx_store_path);
       for (int j=0; j<array_size(o->gfx_overlays); j++)
          gl_freeTexture(o->gfx_overlays[j]);
       array_free(o->gfx_overlays);
@@ -2831,4 +2875,6 @@ void outfit_free (void)
 
    array_free(outfit_stack);
    array_free(license_stack);
+   array_free(outfit_idmap);
+   outfit_idmap = NULL;
 }
@@ -325,7 +325,9 @@ typedef struct Outfit_ {
    char *desc_extra; /**< Extra description string (if static). */
    int priority;     /**< Sort priority, highest first. */
 
-   glTexture *gfx_store;   /**< Store graphic. */
+   char *gfx_store_path;   /**< Path of the store graphic. */
+   glTexture *gfx_store;   /**< Store graphic, use outfit_gfxStore() to access. */
+   Uint32 gfx_store_used;  /**< Last time the store graphic was used in ticks. */
    glTexture **gfx_overlays;/**< Array (array.h): Store overlay graphics. */
 
    unsigned int properties;/**< Properties stored bitwise. */
@@ -346,6 +348,7 @@ typedef struct Outfit_ {
    int lua_init;     /**< Run when pilot enters a system. */
    int lua_cleanup;  /**< Run when the pilot is erased. */
    int lua_update;   /**< Run periodically. */
+   int lua_update_all;/**< Run periodically once for all instances of the outfit. */
    int lua_ontoggle; /**< Run when toggled. */
    int lua_onhit;    /**< Run when pilot takes damage. */
    int lua_outofenergy;/**< Run when the pilot runs out of energy. */
@@ -440,6 +443,8 @@ char outfit_slotTypeColourFont( const OutfitSlot* os );
 size_t outfit_getNameWithClass( const Outfit* outfit, char* buf, size_t size );
 OutfitSlotSize outfit_toSlotSize( const char *s );
 const glTexture* outfit_gfx( const Outfit* o );
+glTexture* outfit_gfxStore( const Outfit *o );
+void outfit_gfxStoreEvict (void);
 const CollPoly* outfit_plg( const Outfit* o );
 int outfit_spfxArmour( const Outfit* o );
 int outfit_spfxShield( const Outfit* o );
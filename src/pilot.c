@@ -39,6 +39,7 @@
 #include "nlua_pilotoutfit.h"
 #include "nlua_vec2.h"
 #include "ndata.h"
+#include "nmemory.h"
 #include "nstring.h"
 #include "ntime.h"
 #include "nxml.h"
@@ -56,6 +57,7 @@ static unsigned int pilot_id = PLAYER_ID; /**< Stack of pilot ids to assure uniq
 
 /* stack of pilots */
 static Pilot** pilot_stack = NULL; /**< All the pilots in space. (Player may have other Pilot objects, e.g. backup ships.) */
+static PilotHot* pilot_hot = NULL; /**< Frequently scanned data of the pilot stack, same order. */
 
 /* misc */
 static const double pilot_commTimeout  = 15.; /**< Time for text above pilot to time out. */
@@ -75,6 +77,9 @@ static void pilot_refuel( Pilot *p, double dt );
 static void pilot_erase( Pilot *p );
 /* Misc. */
 static int pilot_getStackPos( unsigned int id );
+static void pilot_hotSyncIndex( int i );
+static void pilot_hotAdd( const Pilot *p );
+static void pilot_hotErase( int i );
 static void pilot_init_trails( Pilot* p );
 static int pilot_trail_generated( Pilot* p, int generator );
 
@@ -86,6 +91,93 @@ Pilot*const* pilot_getAll (void)
    return pilot_stack;
 }
 
+/**
+ * @brief Gets the frequently scanned data of the pilot stack.
+ *
+ * It is indexed like pilot_getAll(), but pilots that are still being created
+ * may not be in it yet, so use its own size when iterating.
+ */
+const PilotHot* pilot_getAllHot (void)
+{
+   return pilot_hot;
+}
+
+/**
+ * @brief Synchronizes the frequently scanned data of a stack position.
+ */
+static void pilot_hotSyncIndex( int i )
+{
+   const Pilot *p = pilot_stack[i];
+   PilotHot *h = &pilot_hot[i];
+   h->p        = pilot_stack[i];
+   h->id       = p->id;
+   h->pos      = p->solid->pos;
+   h->vel      = p->solid->vel;
+   h->ew_detect = p->stats.ew_detect;
+   if ((p->ship != NULL) && (p->ship->gfx_space != NULL))
+      h->radius = hypot( p->ship->gfx_space->sw, p->ship->gfx_space->sh ) / 2.;
+   else
+      h->radius = HUGE_VAL;
+}
+
+/**
+ * @brief Synchronizes the frequently scanned data of a pilot.
+ *
+ * Should be called when the pilot is moved outside of its update or has
+ * its stats changed. Does nothing for pilots not on the stack.
+ *
+ *    @param p Pilot to synchronize.
+ */
+void pilot_hotSync( const Pilot *p )
+{
+   int i = pilot_getStackPos( p->id );
+   if ((i < 0) || (i >= array_size(pilot_hot)) || (pilot_stack[i] != p))
+      return;
+   pilot_hotSyncIndex( i );
+}
+
+/**
+ * @brief Rebuilds the frequently scanned data of the whole pilot stack.
+ */
+void pilots_hotSync (void)
+{
+   if (pilot_hot == NULL)
+      pilot_hot = array_create_size( PilotHot, PILOT_SIZE_MIN );
+   array_resize( &pilot_hot, array_size(pilot_stack) );
+   for (int i=0; i<array_size(pilot_stack); i++)
+      pilot_hotSyncIndex( i );
+}
+
+/**
+ * @brief Adds a pilot just pushed onto the stack to the frequently scanned data.
+ *
+ * Only the new position is synchronized, so spawning stays linear in the
+ * number of pilots. The whole stack is rebuilt if the data is not exactly one
+ * pilot behind, like when pilots are created while another is being set up.
+ *
+ *    @param p Pilot that was pushed onto the stack.
+ */
+static void pilot_hotAdd( const Pilot *p )
+{
+   int n = array_size(pilot_hot);
+   if ((pilot_hot == NULL) || (n != array_size(pilot_stack)-1) || (pilot_stack[n] != p)) {
+      pilots_hotSync();
+      return;
+   }
+   array_resize( &pilot_hot, n+1 );
+   pilot_hotSyncIndex( n );
+}
+
+/**
+ * @brief Removes a stack position from the frequently scanned data.
+ */
+static void pilot_hotErase( int i )
+{
+   if ((i < 0) || (i >= array_size(pilot_hot)))
+      return;
+   array_erase( &pilot_hot, &pilot_hot[i], &pilot_hot[i+1] );
+}
+
 /**
  * @brief Compare id (for use with bsearch)
  */
@@ -315,18 +407,17 @@ unsigned int pilot_getNearestEnemy( const Pilot* p )
    unsigned int tp = 0;
    double d = 0.;
 
-   for (int i=0; i<array_size(pilot_stack); i++) {
-      double td;
+   for (int i=0; i<array_size(pilot_hot); i++) {
+      /* Check distance first, it's much cheaper. */
+      double td = vec2_dist2(&pilot_hot[i].pos, &p->solid->pos);
+      if (tp && (td >= d))
+         continue;
 
-      if (!pilot_validEnemy( p, pilot_stack[i] ))
+      if (!pilot_validEnemy( p, pilot_hot[i].p ))
          continue;
 
-      /* Check distance. */
-      td = vec2_dist2(&pilot_stack[i]->solid->pos, &p->solid->pos);
-      if (!tp || (td < d)) {
-         d  = td;
-         tp = pilot_stack[i]->id;
-      }
+      d  = td;
+      tp = pilot_hot[i].id;
    }
    return tp;
 }
@@ -344,21 +435,22 @@ unsigned int pilot_getNearestEnemy_size( const Pilot* p, double target_mass_LB,
    unsigned int tp = 0;
    double d = 0.;
 
-   for (int i=0; i<array_size(pilot_stack); i++) {
-      double td;
+   for (int i=0; i<array_size(pilot_hot); i++) {
+      const Pilot *t = pilot_hot[i].p;
 
-      if (!pilot_validEnemy( p, pilot_stack[i] ))
+      /* Check distance first, it's much cheaper. */
+      double td = vec2_dist2(&pilot_hot[i].pos, &p->solid->pos);
+      if (tp && (td >= d))
          continue;
 
-      if (pilot_stack[i]->solid->mass < target_mass_LB || pilot_stack[i]->solid->mass > target_mass_UB)
+      if (!pilot_validEnemy( p, t ))
          continue;
 
-      /* Check distance. */
-      td = vec2_dist2(&pilot_stack[i]->solid->pos, &p->solid->pos);
-      if (!tp || (td < d)) {
-         d = td;
-         tp = pilot_stack[i]->id;
-      }
+      if (t->solid->mass < target_mass_LB || t->solid->mass > target_mass_UB)
+         continue;
+
+      d = td;
+      tp = pilot_hot[i].id;
    }
 
    return tp;
@@ -435,46 +527,45 @@ unsigned int pilot_getBoss( const Pilot* p )
    /* Initialized to 0.25 which would mean equivalent power. */
    ppower = 0.5*0.5;
 
-   for (int i=0; i<array_size(pilot_stack); i++) {
+   for (int i=0; i<array_size(pilot_hot); i++) {
       double dx, dy, td, curpower;
+      const PilotHot *h = &pilot_hot[i];
 
       /* Must not be self. */
-      if (pilot_stack[i] == p)
+      if (h->p == p)
          continue;
 
-      /* Shouldn't be disabled. */
-      if (pilot_isDisabled(pilot_stack[i]))
+      /* Maximum distance in 2 seconds. */
+      dx = h->pos.x + 2*h->vel.x - p->solid->pos.x - 2*p->solid->vel.x;
+      dy = h->pos.y + 2*h->vel.y - p->solid->pos.y - 2*p->solid->vel.y;
+      td = sqrt( pow2(dx) + pow2(dy) );
+      if (td > 5e3)
          continue;
 
-      /* Must be a valid target. */
-      if (!pilot_validTarget( p, pilot_stack[i] ))
+      /* Shouldn't be disabled. */
+      if (pilot_isDisabled(h->p))
          continue;
 
-      /* Maximum distance in 2 seconds. */
-      dx = pilot_stack[i]->solid->pos.x + 2*pilot_stack[i]->solid->vel.x -
-           p->solid->pos.x - 2*p->solid->vel.x;
-      dy = pilot_stack[i]->solid->pos.y + 2*pilot_stack[i]->solid->vel.y -
-           p->solid->pos.y - 2*p->solid->vel.y;
-      td = sqrt( pow2(dx) + pow2(dy) );
-      if (td > 5e3)
+      /* Must be a valid target. */
+      if (!pilot_validTarget( p, h->p ))
          continue;
 
       /* Must have the same faction. */
-      if (pilot_stack[i]->faction != p->faction)
+      if (h->p->faction != p->faction)
          continue;
 
       /* Must be slower. */
-      if (pilot_stack[i]->speed > p->speed)
+      if (h->p->speed > p->speed)
          continue;
 
       /* Should not be weaker than the current pilot*/
-      curpower = pilot_reldps(  pilot_stack[i], p ) * pilot_relhp(  pilot_stack[i], p );
+      curpower = pilot_reldps(  h->p, p ) * pilot_relhp(  h->p, p );
       if (ppower >= curpower )
          continue;
 
       if (relpower < curpower ) {
          relpower = curpower;
-         t = pilot_stack[i]->id;
+         t = h->id;
       }
    }
    return t;
@@ -495,32 +586,33 @@ double pilot_getNearestPos( const Pilot *p, unsigned int *tp, double x, double y
    double d = 0.;
 
    *tp = PLAYER_ID;
-   for (int i=0; i<array_size(pilot_stack); i++) {
-      double td;
+   for (int i=0; i<array_size(pilot_hot); i++) {
+      const Pilot *t = pilot_hot[i].p;
+
+      /* Minimum distance, checked first as it's much cheaper. */
+      double td = pow2(x-pilot_hot[i].pos.x) + pow2(y-pilot_hot[i].pos.y);
+      if ((*tp!=PLAYER_ID) && (td >= d))
+         continue;
 
       /* Must not be self. */
-      if (pilot_stack[i] == p)
+      if (t == p)
          continue;
 
       /* Player doesn't select escorts (unless disabled is active). */
       if (!disabled && pilot_isPlayer(p) &&
-            pilot_isWithPlayer(pilot_stack[i]))
+            pilot_isWithPlayer(t))
          continue;
 
       /* Shouldn't be disabled. */
-      if (!disabled && pilot_isDisabled(pilot_stack[i]))
+      if (!disabled && pilot_isDisabled(t))
          continue;
 
       /* Must be a valid target. */
-      if (!pilot_validTarget( p, pilot_stack[i] ))
+      if (!pilot_validTarget( p, t ))
          continue;
 
-      /* Minimum distance. */
-      td = pow2(x-pilot_stack[i]->solid->pos.x) + pow2(y-pilot_stack[i]->solid->pos.y);
-      if (((*tp==PLAYER_ID) || (td < d))) {
-         d = td;
-         *tp = pilot_stack[i]->id;
-      }
+      d = td;
+      *tp = pilot_hot[i].id;
    }
    return d;
 }
@@ -2523,14 +2615,9 @@ void pilot_update( Pilot* pilot, double dt )
    /* Update pilot Lua. */
    pilot_shipLUpdate( pilot, dt );
 
-   /* Update outfits if necessary. */
+   /* Update outfits if necessary. The Lua updates themselves are run in
+    * batches by pilot_outfitLUpdateAll() once all pilots are updated. */
    pilot->otimer += dt;
-   while (pilot->otimer >= PILOT_OUTFIT_LUA_UPDATE_DT) {
-      pilot_outfitLUpdate( pilot, PILOT_OUTFIT_LUA_UPDATE_DT );
-      if (pilot_isFlag( pilot, PILOT_DELETE ))
-         return; /* Same as with the effects, it is theoretically possible for the outfit to remove the pilot. */
-      pilot->otimer -= PILOT_OUTFIT_LUA_UPDATE_DT;
-   }
 }
 
 /**
@@ -2985,6 +3072,7 @@ static void pilot_init( Pilot* pilot, const Ship* ship, const char* name, int fa
    /* Defaults. */
    pilot->lua_mem = LUA_NOREF;
    pilot->lua_ship_mem = LUA_NOREF;
+   pilot->lua_ref = LUA_NOREF;
    pilot->autoweap = 1;
    pilot->aimLines = 0;
    pilot->dockpilot = dockpilot;
@@ -2994,6 +3082,7 @@ static void pilot_init( Pilot* pilot, const Ship* ship, const char* name, int fa
 
    /* Basic information. */
    pilot->ship = ship;
+   ship_gfxLoad( ship );
    pilot->name = strdup( (name==NULL) ? _(ship->name) : name );
 
    /* faction */
@@ -3179,7 +3268,7 @@ unsigned int pilot_create( const Ship* ship, const char* name, int faction, cons
    Pilot *p;
 
    /* Allocate pilot memory. */
-   p = malloc(sizeof(Pilot));
+   p = nmem_malloc(MEM_PILOT, sizeof(Pilot));
    if (p == NULL) {
       WARN(_("Unable to allocate memory"));
       return 0;
@@ -3195,9 +3284,12 @@ unsigned int pilot_create( const Ship* ship, const char* name, int faction, cons
    if (pilot_isFlagRaw(flags, PILOT_PLAYER)) { /* Set player ID. TODO should probably be fixed to something better someday. */
       p->id = PLAYER_ID;
       qsort( pilot_stack, array_size(pilot_stack), sizeof(Pilot*), pilot_cmp );
+      pilots_hotSync();
    }
-   else
+   else {
       p->id = ++pilot_id; /* new unique pilot id based on pilot_id, can't be 0 */
+      pilot_hotAdd( p );
+   }
 
    /* Initialize AI if applicable. */
    if (ai == NULL)
@@ -3230,7 +3322,7 @@ unsigned int pilot_create( const Ship* ship, const char* name, int faction, cons
 Pilot* pilot_createEmpty( const Ship* ship, const char* name,
       int faction, PilotFlags flags )
 {
-   Pilot *dyn = malloc(sizeof(Pilot));
+   Pilot *dyn = nmem_malloc(MEM_PILOT, sizeof(Pilot));
    if (dyn == NULL) {
       WARN(_("Unable to allocate memory"));
       return 0;
@@ -3254,7 +3346,7 @@ unsigned int pilot_clone( const Pilot *ref )
    pilot_setFlagRaw( pf, PILOT_NO_OUTFITS );
 
    /* Allocate pilot memory. */
-   dyn = malloc(sizeof(Pilot));
+   dyn = nmem_malloc(MEM_PILOT, sizeof(Pilot));
    if (dyn == NULL) {
       WARN(_("Unable to allocate memory"));
       return 0;
@@ -3277,6 +3369,7 @@ unsigned int pilot_clone( const Pilot *ref )
 
    /* Reset the pilot. */
    pilot_reset( dyn );
+   pilot_hotAdd( dyn );
 
    return dyn->id;
 }
@@ -3293,6 +3386,7 @@ unsigned int pilot_addStack( Pilot *p )
 
    /* Have to reset after adding to stack, as some Lua functions will run code on the pilot. */
    pilot_reset( p );
+   pilot_hotAdd( p );
 
    /* Animated trail. */
    pilot_init_trails( p );
@@ -3326,6 +3420,7 @@ Pilot* pilot_setPlayer( Pilot* after )
 {
    int i = pilot_getStackPos( PLAYER_ID);
    int l = pilot_getStackPos( after->id );
+   int inplace = 0;
 
    if (i < 0) { /* No existing player ID. */
       if (l < 0) /* No existing pilot, have to create. */
@@ -3334,11 +3429,18 @@ Pilot* pilot_setPlayer( Pilot* after )
    else { /* Player pilot already exists. */
       if (l >= 0)
          pilot_delete( pilot_stack[i] ); /* Both player and after are on stack. Remove player. */
-      else
+      else {
          pilot_stack[i] = after; /* after overwrites player. */
+         inplace = 1;
+      }
    }
    after->id = PLAYER_ID;
    qsort( pilot_stack, array_size(pilot_stack), sizeof(Pilot*), pilot_cmp );
+   /* Replacing in place keeps the order, only that position changes. */
+   if (inplace)
+      pilot_hotSync( after );
+   else
+      pilots_hotSync();
 
    /* Set up stuff. */
    player.p = after;
@@ -3507,11 +3609,15 @@ void pilot_free( Pilot *p )
    /* Free messages. */
    luaL_unref(naevL, p->messages, LUA_REGISTRYINDEX);
 
+   /* Free the Lua handle, any copies left in Lua just become invalid. */
+   if (naevL != NULL)
+      luaL_unref(naevL, LUA_REGISTRYINDEX, p->lua_ref);
+
 #ifdef DEBUGGING
    memset( p, 0, sizeof(Pilot) );
 #endif /* DEBUGGING */
 
-   free(p);
+   nmem_free(MEM_PILOT, p);
 }
 
 /**
@@ -3524,6 +3630,7 @@ static void pilot_erase( Pilot *p )
    int i = pilot_getStackPos( p->id );
    pilot_free(p);
    array_erase( &pilot_stack, &pilot_stack[i], &pilot_stack[i+1] );
+   pilot_hotErase( i );
 }
 
 /**
@@ -3538,6 +3645,7 @@ void pilot_stackRemove( Pilot *p )
 #endif /* DEBUGGING */
    p->id = 0;
    array_erase( &pilot_stack, &pilot_stack[i], &pilot_stack[i+1] );
+   pilot_hotErase( i );
 }
 
 /**
@@ -3546,6 +3654,7 @@ void pilot_stackRemove( Pilot *p )
 void pilots_init (void)
 {
    pilot_stack = array_create_size( Pilot*, PILOT_SIZE_MIN );
+   pilot_hot   = array_create_size( PilotHot, PILOT_SIZE_MIN );
 }
 
 /**
@@ -3570,6 +3679,8 @@ void pilots_free (void)
       pilot_free(pilot_stack[i]);
    array_free(pilot_stack);
    pilot_stack = NULL;
+   array_free(pilot_hot);
+   pilot_hot = NULL;
    player.p = NULL;
    free( player.ps.acquired );
    memset( &player.ps, 0, sizeof(PlayerShip_t) );
@@ -3623,6 +3734,7 @@ void pilots_clean( int persist )
          pilot_free(pilot_stack[i]);
    }
    array_erase( &pilot_stack, &pilot_stack[persist_count], array_end(pilot_stack) );
+   pilots_hotSync();
 
    /* Init AI on the remaining pilots, has to be done here so the pilot_stack is consistent. */
    for (int i=0; i<array_size(pilot_stack); i++) {
@@ -3671,6 +3783,7 @@ void pilots_cleanAll (void)
       memset( &player.ps, 0, sizeof(PlayerShip_t) );
    }
    array_erase( &pilot_stack, array_begin(pilot_stack), array_end(pilot_stack) );
+   pilots_hotSync();
 }
 
 /**
@@ -3692,6 +3805,9 @@ void pilots_update( double dt )
          pilot_erase( p );
    }
 
+   /* Make sure what the pilots look at is up to date. */
+   pilots_hotSync();
+
    /* Have all the pilots think. */
    for (int i=0; i<array_size(pilot_stack); i++) {
       Pilot *p = pilot_stack[i];
@@ -3750,7 +3866,14 @@ void pilots_update( double dt )
          player_update( p, dt );
       else
          pilot_update( p, dt );
+
+      /* Pilots still to be updated haven't moved, so this stays exact. */
+      if ((i < array_size(pilot_hot)) && (pilot_hot[i].p == p))
+         pilot_hotSyncIndex( i );
    }
+
+   /* Run the Lua outfit updates grouped by outfit. */
+   pilot_outfitLUpdateAll();
 }
 
 /**
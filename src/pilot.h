@@ -138,6 +138,7 @@ typedef struct PilotOutfitSlot_ {
    /* In the case of Lua stuff. */
    int lua_mem; /**< Lua reference to the memory table of the specific outfit. */
    ShipStats lua_stats; /**< Intrinsic ship stats for the outfit calculated on the fly. Used only by Lua outfits. */
+   int lua_dirty; /**< Whether or not the Lua stats or state changed since the last stat computation. */
 } PilotOutfitSlot;
 
 /**
@@ -164,6 +165,9 @@ typedef struct PilotWeaponSet_ {
    int manual;    /**< Whether or not is manually aiming. */
    double range[PILOT_WEAPSET_MAX_LEVELS]; /**< Range of the levels in the outfit slot. */
    double speed[PILOT_WEAPSET_MAX_LEVELS]; /**< Speed of the levels in the outfit slot. */
+   double ammo[PILOT_WEAPSET_MAX_LEVELS]; /**< Ammo fraction of the levels in the outfit slot. */
+   double ammo_all; /**< Ammo fraction of all the levels in the outfit slot. */
+   int dirty;     /**< Whether or not range, speed and ammo have to be recomputed. */
 } PilotWeaponSet;
 
 /**
@@ -373,9 +377,28 @@ typedef struct Pilot_ {
                              In per one of max shield + armour. */
    double engine_glow;/**< Amount of engine glow to display. */
    int messages;     /**< Queued messages (Lua ref). */
+   int lua_ref;      /**< Persistent Lua userdata of the pilot (Lua ref). */
    lvar *shipvar;    /**< Per-ship version of lua mission variables. */
 } Pilot;
 
+/**
+ * @brief Frequently scanned pilot data, stored densely by stack position.
+ *
+ * Loops over all the pilots that mainly look at positions use this instead of
+ * going through the much larger Pilot structure. Entries are added and
+ * removed along with the pilot stack and the data is synchronized before the
+ * weapons and pilots are updated, after each pilot is updated, and when a
+ * pilot is moved or has its stats changed.
+ */
+typedef struct PilotHot_ {
+   Pilot *p;            /**< Pilot the data belongs to. */
+   unsigned int id;     /**< ID of the pilot. */
+   vec2 pos;            /**< Position of the pilot. */
+   vec2 vel;            /**< Velocity of the pilot. */
+   double radius;       /**< Radius bounding the pilot's collision shape. */
+   double ew_detect;    /**< Detection modifier of the pilot. */
+} PilotHot;
+
 /* These depend on Pilot being defined first. */
 #include "pilot_cargo.h"
 #include "pilot_heat.h"
@@ -388,6 +411,9 @@ typedef struct Pilot_ {
  * Getting pilot stuff.
  */
 Pilot*const* pilot_getAll (void);
+const PilotHot* pilot_getAllHot (void);
+void pilot_hotSync( const Pilot *p );
+void pilots_hotSync (void);
 Pilot* pilot_get( unsigned int id );
 Pilot* pilot_getTarget( Pilot *p );
 unsigned int pilot_getNextID( unsigned int id, int mode );
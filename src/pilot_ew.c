@@ -332,6 +332,30 @@ int pilot_inRangeAsteroid( const Pilot *p, int ast, int fie )
    return 0;
 }
 
+/**
+ * @brief Check to see if any asteroid of a field can be in sensor range of the pilot.
+ *
+ * Asteroids can drift out of the field by its margin before being pushed
+ * back, so that is included.
+ *
+ *    @param p Pilot who is trying to check to see if the field is in sensor range.
+ *    @param fie Field to see if is in sensor range.
+ *    @return 1 if asteroids of the field may be in range, 0 if none can be.
+ */
+int pilot_inRangeAsteroidField( const Pilot *p, int fie )
+{
+   double d;
+   AsteroidAnchor *f;
+
+   /* pilot must exist */
+   if (p == NULL)
+      return 0;
+
+   f = &cur_system->asteroids[fie];
+   d = vec2_dist2( &p->solid->pos, &f->pos );
+   return (d < pow2( MAX( 0., EW_ASTEROID_DIST * p->stats.ew_detect ) + f->radius + f->margin ));
+}
+
 /**
  * @brief Check to see if a jump point is in sensor range of the pilot.
  *
@@ -401,7 +425,7 @@ double pilot_ewWeaponTrack( const Pilot *p, const Pilot *t, double trackmin, dou
  */
 static int pilot_ewStealthGetNearby( const Pilot *p, double *mod, int *close, int *isplayer )
 {
-   Pilot *const* ps;
+   const PilotHot *ph;
    int n;
 
    /* Check nearby non-allies. */
@@ -412,10 +436,15 @@ static int pilot_ewStealthGetNearby( const Pilot *p, double *mod, int *close, in
    if (isplayer != NULL)
       *isplayer = 0;
    n = 0;
-   ps = pilot_getAll();
-   for (int i=0; i<array_size(ps); i++) {
+   ph = pilot_getAllHot();
+   for (int i=0; i<array_size(ph); i++) {
       double dist;
-      Pilot *t = ps[i];
+      Pilot *t = ph[i].p;
+
+      /* Pilots out of range can't affect anything, and this is the cheapest check. */
+      dist = vec2_dist2( &p->solid->pos, &ph[i].pos );
+      if (dist > pow2( MAX( 0., p->ew_stealth * ph[i].ew_detect * ((close != NULL) ? 1.5 : 1.) )))
+         continue;
 
       /* Quick checks first. */
       if (pilot_isDisabled(t))
@@ -438,8 +467,6 @@ static int pilot_ewStealthGetNearby( const Pilot *p, double *mod, int *close, in
       //if (pilot_isFlag(t, PILOT_STEALTH))
       //   continue;
 
-      /* Compute distance. */
-      dist = vec2_dist2( &p->solid->pos, &t->solid->pos );
       /* TODO maybe not hardcode the close value. */
       if ((close != NULL) && !pilot_isFlag(t,PILOT_STEALTH) &&
             (dist < pow2( MAX( 0., p->ew_stealth * t->stats.ew_detect * 1.5 ))))
@@ -16,6 +16,7 @@ int pilot_inRange( const Pilot *p, double x, double y );
 int pilot_inRangePilot( const Pilot *p, const Pilot *target, double *dist2);
 int pilot_inRangeSpob( const Pilot *p, int target );
 int pilot_inRangeAsteroid( const Pilot *p, int ast, int fie );
+int pilot_inRangeAsteroidField( const Pilot *p, int fie );
 int pilot_inRangeJump( const Pilot *p, int target );
 
 /*
@@ -678,6 +678,7 @@ int pilot_addAmmo( Pilot* pilot, PilotOutfitSlot *s, int quantity )
    q                   = s->u.ammo.quantity - q; /* Amount actually added. */
    pilot->mass_outfit += q * outfit_ammoMass( s->outfit );
    pilot_updateMass( pilot );
+   pilot_weapSetDirty( pilot );
 
    return q;
 }
@@ -707,6 +708,7 @@ int pilot_rmAmmo( Pilot* pilot, PilotOutfitSlot *s, int quantity )
    s->u.ammo.quantity -= q;
    pilot->mass_outfit -= q * outfit_ammoMass( s->outfit );
    pilot_updateMass( pilot );
+   pilot_weapSetDirty( pilot );
    /* We don't set the outfit to null so it "remembers" old ammo. */
 
    return q;
@@ -841,8 +843,10 @@ static void pilot_calcStatsSlot( Pilot *pilot, PilotOutfitSlot *slot )
    if (slot->lua_mem != LUA_NOREF)
       ss_statsMerge( &pilot->stats, &slot->lua_stats );
 
+   slot->lua_dirty = 0;
+
    /* Has update function. */
-   if (o->lua_update != LUA_NOREF)
+   if ((o->lua_update != LUA_NOREF) || (o->lua_update_all != LUA_NOREF))
       pilot->outfitlupdate = 1;
 
    /* Apply modifications. */
@@ -1032,7 +1036,10 @@ void pilot_calcStats( Pilot* pilot )
    gui_setGeneric( pilot );
 
    /* Update weapon set range. */
-   pilot_weapSetUpdateStats( pilot );
+   pilot_weapSetDirty( pilot );
+
+   /* Detection may have changed. */
+   pilot_hotSync( pilot );
 
    /* In case the time_mod has changed. */
    if (pilot_isPlayer(pilot) && (tm != s->time_mod))
@@ -1380,17 +1387,225 @@ static void outfitLUpdate( const Pilot *pilot, PilotOutfitSlot *po, const void *
       lua_pop(naevL, 1);
    }
 }
+
+/**
+ * @brief A pilot outfit slot queued for a batched Lua update.
+ */
+typedef struct OutfitLBatch_ {
+   const Outfit *outfit; /**< Outfit being updated, used for grouping. */
+   unsigned int pilot;  /**< ID of the pilot owning the slot. */
+   int slot;            /**< Index into outfits, or -(index+1) into the intrinsic outfits. */
+} OutfitLBatch;
+static OutfitLBatch *outfitl_batch = NULL; /**< Queued batched updates. */
+static int outfitl_batch_list = LUA_NOREF; /**< List table passed to update_all. */
+static int outfitl_batch_pool = LUA_NOREF; /**< Pool of entry tables reused by the list. */
+static int outfitl_batch_n    = 0; /**< Number of entries in the list table. */
+
+/**
+ * @brief Compares batched updates to group them by outfit.
+ */
+static int outfitLBatchCompare( const void *p1, const void *p2 )
+{
+   const OutfitLBatch *b1 = p1;
+   const OutfitLBatch *b2 = p2;
+   uintptr_t o1 = (uintptr_t)b1->outfit;
+   uintptr_t o2 = (uintptr_t)b2->outfit;
+   if (o1 < o2)
+      return -1;
+   else if (o1 > o2)
+      return +1;
+   return 0;
+}
+
 /**
- * @brief Runs the pilot's Lua outfits update script.
+ * @brief Gets the slot of a batched update, making sure it is still valid.
  *
- *    @param pilot Pilot to run Lua outfits for.
- *    @param dt Delta-tick from last time it was run.
+ * Scripts can remove pilots, so the pilot is looked up again every time.
+ *
+ *    @param b Batched update to get slot of.
+ *    @param[out] pilot Pilot owning the slot.
+ *    @return The slot or NULL if no longer valid.
  */
-void pilot_outfitLUpdate( Pilot *pilot, double dt )
+static PilotOutfitSlot *outfitLBatchSlot( const OutfitLBatch *b, Pilot **pilot )
+{
+   PilotOutfitSlot *po;
+   Pilot *p = pilot_get( b->pilot );
+   if ((p==NULL) || pilot_isFlag( p, PILOT_DELETE ))
+      return NULL;
+   if (b->slot >= 0) {
+      if (b->slot >= array_size(p->outfits))
+         return NULL;
+      po = p->outfits[ b->slot ];
+   }
+   else {
+      int i = -b->slot-1;
+      if (i >= array_size(p->outfit_intrinsic))
+         return NULL;
+      po = &p->outfit_intrinsic[i];
+   }
+   /* Outfit may have been changed by a previous script. */
+   if ((po->outfit != b->outfit) || (po->lua_mem == LUA_NOREF))
+      return NULL;
+   *pilot = p;
+   return po;
+}
+
+/**
+ * @brief Runs the update of a pilot's outfits, queueing the batched ones.
+ */
+static void outfitLUpdateQueue( Pilot *p, double dt )
 {
-   if (!pilot->outfitlupdate)
+   pilotoutfit_modified = 0;
+   for (int i=0; i<array_size(p->outfits); i++) {
+      PilotOutfitSlot *po = p->outfits[i];
+      if (po->outfit==NULL)
+         continue;
+      if (po->outfit->lua_update_all != LUA_NOREF) {
+         OutfitLBatch *b = &array_grow( &outfitl_batch );
+         b->outfit = po->outfit;
+         b->pilot  = p->id;
+         b->slot   = i;
+         continue;
+      }
+      outfitLUpdate( p, po, &dt );
+   }
+   for (int i=0; i<array_size(p->outfit_intrinsic); i++) {
+      PilotOutfitSlot *po = &p->outfit_intrinsic[i];
+      if (po->outfit==NULL)
+         continue;
+      if (po->outfit->lua_update_all != LUA_NOREF) {
+         OutfitLBatch *b = &array_grow( &outfitl_batch );
+         b->outfit = po->outfit;
+         b->pilot  = p->id;
+         b->slot   = -i-1;
+         continue;
+      }
+      outfitLUpdate( p, po, &dt );
+   }
+   /* Recalculate if anything changed. */
+   if (pilotoutfit_modified)
+      pilot_calcStats( p );
+}
+
+/**
+ * @brief Runs update_all( list, dt ) for a group of batched updates of the same outfit.
+ *
+ * Each list entry is a table with the fields p, po and mem. The tables are
+ * reused between calls so scripts should not keep references to them.
+ */
+static void outfitLUpdateGroup( const OutfitLBatch *batch, int n, double dt )
+{
+   const Outfit *o = batch[0].outfit;
+   int k = 0;
+
+   lua_rawgeti(naevL, LUA_REGISTRYINDEX, outfitl_batch_pool); /* pool */
+   lua_rawgeti(naevL, LUA_REGISTRYINDEX, outfitl_batch_list); /* pool, l */
+   for (int i=0; i<n; i++) {
+      Pilot *p;
+      PilotOutfitSlot *po = outfitLBatchSlot( &batch[i], &p );
+      if (po==NULL)
+         continue;
+      k++;
+
+      /* Get an entry table from the pool. */
+      lua_rawgeti(naevL, -2, k); /* pool, l, e */
+      if (lua_isnil(naevL,-1)) {
+         lua_pop(naevL,1); /* pool, l */
+         lua_newtable(naevL); /* pool, l, e */
+         lua_pushvalue(naevL,-1); /* pool, l, e, e */
+         lua_rawseti(naevL,-4,k); /* pool, l, e */
+      }
+      lua_pushpilot(naevL, p->id); /* pool, l, e, p */
+      lua_setfield(naevL,-2,"p"); /* pool, l, e */
+      lua_pushpilotoutfit(naevL, po); /* pool, l, e, po */
+      lua_setfield(naevL,-2,"po"); /* pool, l, e */
+      lua_rawgeti(naevL, LUA_REGISTRYINDEX, po->lua_mem); /* pool, l, e, mem */
+      lua_setfield(naevL,-2,"mem"); /* pool, l, e */
+      lua_rawseti(naevL,-2,k); /* pool, l */
+   }
+   /* Clear leftovers from the previous call. */
+   for (int i=k+1; i<=outfitl_batch_n; i++) {
+      lua_pushnil(naevL); /* pool, l, nil */
+      lua_rawseti(naevL,-2,i); /* pool, l */
+   }
+   outfitl_batch_n = k;
+   lua_remove(naevL,-2); /* l */
+   if (k<=0) {
+      lua_pop(naevL,1); /* */
       return;
-   pilot_outfitLRun( pilot, outfitLUpdate, &dt );
+   }
+
+   /* Set up the function: update_all( list, dt ) */
+   lua_rawgeti(naevL, LUA_REGISTRYINDEX, o->lua_update_all); /* l, f */
+   lua_insert(naevL,-2); /* f, l */
+   lua_pushnumber(naevL, dt); /* f, l, dt */
+   if (nlua_pcall( o->lua_env, 2, 0 )) { /* */
+      WARN( _("Outfit '%s' -> '%s':\n%s"), o->name, "update_all", lua_tostring(naevL,-1) );
+      lua_pop(naevL, 1);
+   }
+}
+
+/**
+ * @brief Runs the Lua outfit updates of all the pilots that are due.
+ *
+ * Outfits defining update_all get a single call per update step with all
+ * their instances, while the rest run update per slot as usual. Stats are
+ * only recomputed for the pilots whose Lua stats or outfit states changed.
+ */
+void pilot_outfitLUpdateAll (void)
+{
+   const double dt = PILOT_OUTFIT_LUA_UPDATE_DT;
+   int run;
+
+   if (outfitl_batch == NULL)
+      outfitl_batch = array_create( OutfitLBatch );
+   if (outfitl_batch_list == LUA_NOREF) {
+      lua_newtable(naevL); /* l */
+      outfitl_batch_list = luaL_ref(naevL, LUA_REGISTRYINDEX); /* */
+      lua_newtable(naevL); /* pool */
+      outfitl_batch_pool = luaL_ref(naevL, LUA_REGISTRYINDEX); /* */
+   }
+
+   do {
+      run = 0;
+      array_resize( &outfitl_batch, 0 );
+
+      /* Pilots can be added by the scripts, so the stack is fetched every time. */
+      for (int i=0; i<array_size(pilot_getAll()); i++) {
+         Pilot *p = pilot_getAll()[i];
+         if (pilot_isFlag( p, PILOT_DELETE ))
+            continue;
+         if (p->otimer < dt)
+            continue;
+         p->otimer -= dt;
+         run = 1;
+         if (!p->outfitlupdate)
+            continue;
+         outfitLUpdateQueue( p, dt );
+      }
+
+      if (array_size(outfitl_batch) <= 0)
+         continue;
+
+      /* Run each outfit once with all its instances. */
+      qsort( outfitl_batch, array_size(outfitl_batch), sizeof(OutfitLBatch), outfitLBatchCompare );
+      for (int i=0; i<array_size(outfitl_batch); ) {
+         int j = i+1;
+         while ((j<array_size(outfitl_batch)) && (outfitl_batch[j].outfit==outfitl_batch[i].outfit))
+            j++;
+         outfitLUpdateGroup( &outfitl_batch[i], j-i, dt );
+         i = j;
+      }
+
+      /* Recompute stats only for pilots with modified slots. Computing the
+       * stats clears the dirty flags, so each pilot is only done once. */
+      for (int i=0; i<array_size(outfitl_batch); i++) {
+         Pilot *p;
+         PilotOutfitSlot *po = outfitLBatchSlot( &outfitl_batch[i], &p );
+         if ((po!=NULL) && po->lua_dirty)
+            pilot_calcStats( p );
+      }
+   } while (run);
 }
 
 static void outfitLOutofenergy( const Pilot *pilot, PilotOutfitSlot *po, const void *data )
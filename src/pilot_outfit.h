@@ -59,7 +59,7 @@ int pilot_outfitLAdd( Pilot *pilot, PilotOutfitSlot *po );
 int pilot_outfitLRemove( Pilot *pilot, PilotOutfitSlot *po );
 void pilot_outfitLInitAll( Pilot *pilot );
 int pilot_outfitLInit( Pilot *pilot, PilotOutfitSlot *po );
-void pilot_outfitLUpdate( Pilot *pilot, double dt );
+void pilot_outfitLUpdateAll (void);
 void pilot_outfitLOutfofenergy( Pilot *pilot );
 void pilot_outfitLOnhit( Pilot *pilot, double armour, double shield, unsigned int attacker );
 int pilot_outfitLOntoggle( Pilot *pilot, PilotOutfitSlot *po, int on );
@@ -45,7 +45,8 @@ static void pilot_weapSetUpdateOutfits( Pilot* p, PilotWeaponSet *ws );
 static int pilot_weapSetFire( Pilot *p, PilotWeaponSet *ws, int level );
 static int pilot_shootWeaponSetOutfit( Pilot* p, PilotWeaponSet *ws, const Outfit *o, int level, double time, int aim );
 static int pilot_shootWeapon( Pilot *p, PilotOutfitSlot *w, double time, int aim );
-static void pilot_weapSetUpdateRange( const Pilot *p, PilotWeaponSet *ws );
+static void pilot_weapSetUpdateCache( const Pilot *p, PilotWeaponSet *ws );
+static PilotWeaponSet* pilot_weapSetCached( Pilot *p, int id );
 unsigned int pilot_weaponSetShootStop( Pilot* p, PilotWeaponSet *ws, int level );
 
 /**
@@ -145,13 +146,20 @@ static int pilot_weapSetFire( Pilot *p, PilotWeaponSet *ws, int level )
 }
 
 /**
- * @brief Useful function for AI, clears activeness of all weapon sets.
+ * @brief Useful function for AI, stops the weapon sets it didn't hold this think.
+ *
+ * Weapon sets the AI presses stay active across frames, only the ones it let
+ * go of are turned off.
+ *
+ *    @param p Pilot to update.
+ *    @param held Bitmask of the weapon sets pressed since the last think.
  */
-void pilot_weapSetAIClear( Pilot* p )
+void pilot_weapSetAIRelease( Pilot* p, unsigned int held )
 {
    for (int i=0; i<PILOT_WEAPON_SETS; i++) {
       PilotWeaponSet *ws = &p->weapon_sets[i];
-      ws->active = 0;
+      if (ws->active && !(held & (1U << i)))
+         ws->active = 0;
    }
 }
 
@@ -477,8 +485,8 @@ void pilot_weapSetAdd( Pilot* p, int id, PilotOutfitSlot *o, int level )
       }
    }
 
-   /* Update range. */
-   pilot_weapSetUpdateRange( p, ws );
+   /* Range has to be recomputed. */
+   ws->dirty = 1;
 
    /* Update if needed. */
    if (id == p->active_set)
@@ -501,8 +509,8 @@ void pilot_weapSetRm( Pilot* p, int id, PilotOutfitSlot *o )
 
       array_erase( &ws->slots, &ws->slots[i], &ws->slots[i+1] );
 
-      /* Update range. */
-      pilot_weapSetUpdateRange( p, ws );
+      /* Range has to be recomputed. */
+      ws->dirty = 1;
 
       /* Update if needed. */
       if (id == p->active_set)
@@ -541,30 +549,45 @@ int pilot_weapSetCheck( Pilot* p, int id, PilotOutfitSlot *o )
 }
 
 /**
- * @brief Update the weapon sets given pilot stat changes.
+ * @brief Marks the cached range, speed and ammo of the weapon sets as stale.
+ *
+ * Has to be called whenever the outfits, ammo or stats of the pilot change.
  *
  *    @param p Pilot to update.
  */
-void pilot_weapSetUpdateStats( Pilot *p )
+void pilot_weapSetDirty( Pilot *p )
 {
    for (int i=0; i<PILOT_WEAPON_SETS; i++)
-      pilot_weapSetUpdateRange( p, &p->weapon_sets[i] );
+      p->weapon_sets[i].dirty = 1;
 }
 
 /**
- * @brief Updates the weapon range for a pilot weapon set.
+ * @brief Gets a weapon set making sure its cached values are up to date.
+ */
+static PilotWeaponSet* pilot_weapSetCached( Pilot *p, int id )
+{
+   PilotWeaponSet *ws = pilot_weapSet(p,id);
+   if (ws->dirty)
+      pilot_weapSetUpdateCache( p, ws );
+   return ws;
+}
+
+/**
+ * @brief Updates the weapon range, speed and ammo for a pilot weapon set.
  *
  *    @param p Pilot whos weapon set is being updated.
  *    @param ws Weapon Set to update range for.
  */
-static void pilot_weapSetUpdateRange( const Pilot *p, PilotWeaponSet *ws )
+static void pilot_weapSetUpdateCache( const Pilot *p, PilotWeaponSet *ws )
 {
-   int lev;
-   double range, speed;
+   int lev, amount, nammo_all;
+   double range, speed, ammo_all;
    double range_accum[PILOT_WEAPSET_MAX_LEVELS];
    int range_num[PILOT_WEAPSET_MAX_LEVELS];
    double speed_accum[PILOT_WEAPSET_MAX_LEVELS];
    int speed_num[PILOT_WEAPSET_MAX_LEVELS];
+   double ammo_accum[PILOT_WEAPSET_MAX_LEVELS];
+   int ammo_num[PILOT_WEAPSET_MAX_LEVELS];
 
    /* Calculate ranges. */
    for (int i=0; i<PILOT_WEAPSET_MAX_LEVELS; i++) {
@@ -572,7 +595,11 @@ static void pilot_weapSetUpdateRange( const Pilot *p, PilotWeaponSet *ws )
       range_num[i]   = 0;
       speed_accum[i] = 0.;
       speed_num[i]   = 0;
+      ammo_accum[i]  = 0.;
+      ammo_num[i]    = 0;
    }
+   ammo_all  = 0.;
+   nammo_all = 0;
    for (int i=0; i<array_size(ws->slots); i++) {
       PilotOutfitSlot *pos = p->outfits[ ws->slots[i].slotid ];
       if (pos->outfit == NULL)
@@ -580,6 +607,19 @@ static void pilot_weapSetUpdateRange( const Pilot *p, PilotWeaponSet *ws )
 
       /* Get level. */
       lev = ws->slots[i].level;
+
+      /* Get ammo, empty launchers count here. */
+      amount = pilot_maxAmmoO( p, pos->outfit );
+      if (amount > 0) {
+         double a = (double)pos->u.ammo.quantity / (double)amount;
+         ammo_all += a;
+         nammo_all++;
+         if ((lev >= 0) && (lev < PILOT_WEAPSET_MAX_LEVELS)) {
+            ammo_accum[ lev ] += a;
+            ammo_num[ lev ]++;
+         }
+      }
+
       if (lev >= PILOT_WEAPSET_MAX_LEVELS)
          continue;
 
@@ -619,7 +659,15 @@ static void pilot_weapSetUpdateRange( const Pilot *p, PilotWeaponSet *ws )
          ws->speed[i] = 0;
       else
          ws->speed[i] = speed_accum[i] / (double) speed_num[i];
+
+      /* Postprocess ammo. */
+      if (ammo_num[i] == 0)
+         ws->ammo[i] = 0.;
+      else
+         ws->ammo[i] = ammo_accum[i] / (double) ammo_num[i];
    }
+   ws->ammo_all = (nammo_all==0) ? 0. : ammo_all / (double)nammo_all;
+   ws->dirty    = 0;
 }
 
 /**
@@ -632,7 +680,7 @@ static void pilot_weapSetUpdateRange( const Pilot *p, PilotWeaponSet *ws )
 double pilot_weapSetRange( Pilot* p, int id, int level )
 {
    double range;
-   PilotWeaponSet *ws = pilot_weapSet(p,id);
+   PilotWeaponSet *ws = pilot_weapSetCached(p,id);
    if (level < 0) {
       range = 0.;
       for (int i=0; i<PILOT_WEAPSET_MAX_LEVELS; i++)
@@ -654,7 +702,7 @@ double pilot_weapSetRange( Pilot* p, int id, int level )
 double pilot_weapSetSpeed( Pilot* p, int id, int level )
 {
    double speed;
-   PilotWeaponSet *ws = pilot_weapSet(p,id);
+   PilotWeaponSet *ws = pilot_weapSetCached(p,id);
    if (level < 0) {
       speed = 0.;
       for (int i=0; i<PILOT_WEAPSET_MAX_LEVELS; i++)
@@ -675,24 +723,12 @@ double pilot_weapSetSpeed( Pilot* p, int id, int level )
  */
 double pilot_weapSetAmmo( Pilot* p, int id, int level )
 {
-   PilotWeaponSet *ws;
-   int amount, nammo;
-   double ammo;
-
-   ammo = 0.;
-   nammo = 0;
-   ws = pilot_weapSet(p,id);
-   for (int i=0; i<array_size(ws->slots); i++) {
-      PilotOutfitSlot *s = p->outfits[ ws->slots[i].slotid ];
-      if ((level >= 0) && (ws->slots[i].level != level))
-         continue;
-      amount = pilot_maxAmmoO( p, s->outfit );
-      if (amount > 0) {
-         ammo += (double)s->u.ammo.quantity / (double)amount;
-         nammo++;
-      }
-   }
-   return (nammo==0) ? 0. : ammo / (double)nammo;
+   PilotWeaponSet *ws = pilot_weapSetCached(p,id);
+   if (level < 0)
+      return ws->ammo_all;
+   else if (level >= PILOT_WEAPSET_MAX_LEVELS)
+      return 0.;
+   return ws->ammo[ level ];
 }
 
 /**
@@ -708,8 +744,8 @@ void pilot_weapSetCleanup( Pilot* p, int id )
    array_free( ws->slots );
    ws->slots = NULL;
 
-   /* Update range. */
-   pilot_weapSetUpdateRange( p, ws );
+   /* Range has to be recomputed. */
+   ws->dirty = 1;
 }
 
 /**
@@ -1153,12 +1189,6 @@ static int pilot_shootWeapon( Pilot *p, PilotOutfitSlot *w, double time, int aim
       /* Make the AI aware a seeker has been shot */
       if (outfit_isSeeker(w->outfit))
          p->shoot_indicator = 1;
-
-      /* If last ammo was shot, update the range */
-      if (w->u.ammo.quantity <= 0) {
-         for (int j=0; j<PILOT_WEAPON_SETS; j++)
-            pilot_weapSetUpdateRange( p, &p->weapon_sets[j] );
-      }
    }
 
    /*
@@ -1189,6 +1219,7 @@ static int pilot_shootWeapon( Pilot *p, PilotOutfitSlot *w, double time, int aim
       w->u.ammo.quantity -= 1; /* we just shot it */
       p->mass_outfit     -= w->outfit->u.bay.ship_mass;
       pilot_updateMass( p );
+      pilot_weapSetDirty( p );
    }
    else
       WARN(_("Shooting unknown weapon type: %s"), w->outfit->name);
@@ -1288,8 +1319,8 @@ void pilot_weaponAuto( Pilot *p )
    if (!pilot_isPlayer(p))
       for (int i=0; i<PILOT_WEAPON_SETS; i++) {
          pilot_weapSetInrange( p, i, 1 );
-         /* Update range and speed (at 0)*/
-         pilot_weapSetUpdateRange( p, &p->weapon_sets[i] );
+         /* Range and speed have to be recomputed. */
+         p->weapon_sets[i].dirty = 1;
       }
 
    /* Iterate through all the outfits. */
@@ -1412,8 +1443,8 @@ void pilot_weaponSafe( Pilot *p )
          for (int i=0; i<array_size(ws->slots); i++)
             ws->slots[i].level = 0;
 
-      /* Update range. */
-      pilot_weapSetUpdateRange( p, ws );
+      /* Range has to be recomputed. */
+      ws->dirty = 1;
    }
 }
 
@@ -1581,8 +1612,10 @@ void ws_copy( PilotWeaponSet dest[PILOT_WEAPON_SETS], const PilotWeaponSet src[P
 {
    ws_free( dest );
    memcpy( dest, src, sizeof(PilotWeaponSet)*PILOT_WEAPON_SETS );
-   for (int i=0; i<PILOT_WEAPON_SETS; i++)
+   for (int i=0; i<PILOT_WEAPON_SETS; i++) {
       dest[i].slots = array_copy( PilotWeaponSetOutfit, src[i].slots );
+      dest[i].dirty = 1;
+   }
 }
 
 /**
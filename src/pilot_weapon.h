@@ -24,8 +24,8 @@ double pilot_weapFlyTime( const Outfit *o, const Pilot *parent,
       const vec2 *pos, const vec2 *vel);
 
 /* Updating. */
-void pilot_weapSetUpdateStats( Pilot *p );
-void pilot_weapSetAIClear( Pilot* p );
+void pilot_weapSetDirty( Pilot *p );
+void pilot_weapSetAIRelease( Pilot* p, unsigned int held );
 void pilot_weapSetPress( Pilot* p, int id, int type );
 void pilot_weapSetUpdate( Pilot* p );
 
@@ -908,6 +908,7 @@ void player_warp( double x, double y )
 {
    unsigned int target = cam_getTarget();
    vec2_cset( &player.p->solid->pos, x, y );
+   pilot_hotSync( player.p );
    /* Have to move camera over to avoid moving stars when loading. */
    if (target == player.p->id)
       cam_setTargetPilot( target, 0 );
@@ -2611,7 +2612,7 @@ int player_ships( char** sships, glTexture** tships )
    /* Create the struct. */
    for (int i=0; i < array_size(player_stack); i++) {
       sships[i] = strdup(player_stack[i].p->name);
-      tships[i] = player_stack[i].p->ship->gfx_store;
+      tships[i] = ship_gfxStore( player_stack[i].p->ship );
    }
 
    return array_size(player_stack);
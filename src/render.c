@@ -202,6 +202,9 @@ void render_all( double game_dt, double real_dt )
 
    dt = (paused) ? 0. : game_dt;
 
+   /* New frame for the statistics. */
+   gl_renderStatsReset();
+
    /* Set up the default viewport. */
    gl_defViewport();
 
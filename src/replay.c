@@ -0,0 +1,491 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+/**
+ * @file replay.c
+ *
+ * @brief Records and plays back sessions for reproducible performance captures.
+ *
+ * A recording starts when a saved game is loaded. A copy of the save is kept
+ * next to the recording, the random number generators are reseeded with a
+ * logged seed and the player takes off. From then on every frame logs its
+ * frame time, the key bindings run before it and how many random numbers each
+ * simulation tick drew.
+ *
+ * Playing back loads the copied save, seeds the generators the same way and
+ * feeds the frame times and key bindings back in instead of the real ones, so
+ * the simulation runs the same way no matter how fast the machine renders.
+ * The logged random number counts are used to detect when the playback stops
+ * matching the recording.
+ *
+ * Only key bindings are captured. Mouse flight, clicks and toolkit windows are
+ * not, so captures should stick to flying with the keyboard.
+ */
+/** @cond */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "physfs.h"
+
+#include "naev.h"
+/** @endcond */
+
+#include "replay.h"
+
+#include "input.h"
+#include "land.h"
+#include "load.h"
+#include "log.h"
+#include "menu.h"
+#include "ndata.h"
+#include "nlua.h"
+#include "player.h"
+#include "rng.h"
+
+#define REPLAY_PATH     "replays"   /**< Directory replays are stored in. */
+#define REPLAY_VERSION  1           /**< Version of the replay format. */
+#define REPLAY_BUFSIZE  (64*1024)   /**< Size of the buffer used when recording. */
+
+/**
+ * @brief What the replay subsystem is doing.
+ */
+typedef enum ReplayMode_ {
+   REPLAY_OFF,    /**< Neither recording nor playing. */
+   REPLAY_RECORD, /**< Recording a session. */
+   REPLAY_PLAY,   /**< Playing back a session. */
+} ReplayMode;
+
+/**
+ * @brief How far along the recording or playback is.
+ */
+typedef enum ReplayState_ {
+   REPLAY_WAITING,   /**< Waiting for the game to be loaded. */
+   REPLAY_PENDING,   /**< Game loaded, starts on the next frame. */
+   REPLAY_RUNNING,   /**< Recording or playing back. */
+   REPLAY_DONE,      /**< Finished. */
+} ReplayState;
+
+static ReplayMode replay_mode    = REPLAY_OFF; /**< Current mode. */
+static ReplayState replay_state  = REPLAY_WAITING; /**< Current state. */
+static char *replay_name         = NULL; /**< Name of the replay. */
+static unsigned int replay_seed  = 0; /**< Seed the session starts with. */
+static unsigned int replay_frames = 0; /**< Frames recorded or played so far. */
+static int replay_diverged       = 0; /**< Whether playback stopped matching the recording. */
+static Uint64 replay_timer       = 0; /**< Performance counter when playback started. */
+static PHYSFS_File *replay_out   = NULL; /**< File being recorded to. */
+static char *replay_buf          = NULL; /**< Contents of the file being played back. */
+static char *replay_cur          = NULL; /**< Current line of the file being played back. */
+static char *replay_end          = NULL; /**< End of the file being played back. */
+
+/*
+ * Prototypes.
+ */
+static void replay_path( char *buf, size_t size, const char *ext );
+static void replay_printf( const char *fmt, ... );
+static char *replay_peek (void);
+static char *replay_next (void);
+static void replay_begin (void);
+static void replay_finish (void);
+static void replay_diverge (void);
+
+/**
+ * @brief Gets the PhysicsFS path of a file belonging to the replay.
+ */
+static void replay_path( char *buf, size_t size, const char *ext )
+{
+   snprintf( buf, size, "%s/%s.%s", REPLAY_PATH, replay_name, ext );
+}
+
+/**
+ * @brief Writes a line to the recording.
+ */
+static void replay_printf( const char *fmt, ... )
+{
+   char buf[STRMAX_SHORT];
+   va_list ap;
+   int n;
+
+   if (replay_out == NULL)
+      return;
+
+   va_start( ap, fmt );
+   n = vsnprintf( buf, sizeof(buf), fmt, ap );
+   va_end( ap );
+
+   if (PHYSFS_writeBytes( replay_out, buf, n ) < n) {
+      WARN(_("Failed to write replay '%s': %s"), replay_name,
+            _(PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
+      PHYSFS_close( replay_out );
+      replay_out     = NULL;
+      replay_state   = REPLAY_DONE;
+   }
+}
+
+/**
+ * @brief Gets the current line of the playback without consuming it.
+ *
+ *    @return The line or NULL if the playback is over.
+ */
+static char *replay_peek (void)
+{
+   if ((replay_cur == NULL) || (replay_cur >= replay_end))
+      return NULL;
+   return replay_cur;
+}
+
+/**
+ * @brief Consumes the current line of the playback.
+ *
+ *    @return The line or NULL if the playback is over.
+ */
+static char *replay_next (void)
+{
+   char *line = replay_peek();
+   if (line != NULL)
+      replay_cur += strlen(line)+1;
+   return line;
+}
+
+/**
+ * @brief Notes that the playback no longer matches the recording.
+ */
+static void replay_diverge (void)
+{
+   if (replay_diverged)
+      return;
+   replay_diverged = 1;
+   WARN(_("Replay '%s' diverged from the recording at frame %u!"),
+         replay_name, replay_frames);
+}
+
+/**
+ * @brief Starts recording a session.
+ *
+ * The recording begins once a saved game is loaded.
+ *
+ *    @param name Name to store the replay as.
+ */
+void replay_record( const char *name )
+{
+   replay_exit();
+   replay_mode    = REPLAY_RECORD;
+   replay_state   = REPLAY_WAITING;
+   replay_name    = strdup( name );
+   LOG(_("Recording replay '%s' once a game is loaded."), replay_name);
+}
+
+/**
+ * @brief Plays back a recorded session.
+ *
+ * Loads the saved game the recording started from, so it should be called
+ * once the data is loaded.
+ *
+ *    @param name Name of the replay.
+ *    @return 0 on success.
+ */
+int replay_play( const char *name )
+{
+   char path[PATH_MAX], version[STRMAX_SHORT];
+   size_t bufsize;
+   int ver;
+   char *line;
+
+   replay_exit();
+   replay_name = strdup( name );
+
+   /* Read the whole recording and split it into lines. */
+   replay_path( path, sizeof(path), "txt" );
+   replay_buf = ndata_read( path, &bufsize );
+   if (replay_buf == NULL) {
+      replay_exit();
+      return -1;
+   }
+   replay_cur = replay_buf;
+   replay_end = replay_buf + bufsize;
+   for (char *c=replay_buf; c<replay_end; c++)
+      if (*c == '\n')
+         *c = '\0';
+
+   /* Header. */
+   line = replay_next();
+   if ((line == NULL) || (sscanf( line, "naev-replay %d", &ver ) != 1) || (ver != REPLAY_VERSION)) {
+      WARN(_("Replay '%s' is not a valid replay!"), replay_name);
+      replay_exit();
+      return -1;
+   }
+   line = replay_next();
+   if ((line != NULL) && (sscanf( line, "version %1023s", version ) == 1)
+         && (naev_versionCompare( version ) != 0))
+      WARN(_("Replay '%s' was recorded with version %s and may not play back the same."),
+            replay_name, version);
+   line = replay_next();
+   if ((line == NULL) || (sscanf( line, "seed %u", &replay_seed ) != 1)) {
+      WARN(_("Replay '%s' is missing its seed!"), replay_name);
+      replay_exit();
+      return -1;
+   }
+
+   /* Load the game it starts from. */
+   replay_mode    = REPLAY_PLAY;
+   replay_state   = REPLAY_WAITING;
+   replay_path( path, sizeof(path), "ns" );
+   if (load_gameFile( path ) || (replay_state != REPLAY_PENDING)) {
+      WARN(_("Unable to load the saved game of replay '%s'!"), replay_name);
+      replay_exit();
+      return -1;
+   }
+   LOG(_("Playing back replay '%s'."), replay_name);
+   return 0;
+}
+
+/**
+ * @brief Stops recording or playing back and frees everything.
+ */
+void replay_exit (void)
+{
+   if ((replay_mode == REPLAY_RECORD) && (replay_state == REPLAY_RUNNING))
+      replay_finish();
+   if (replay_out != NULL)
+      PHYSFS_close( replay_out );
+   replay_out     = NULL;
+   free( replay_buf );
+   replay_buf     = NULL;
+   replay_cur     = NULL;
+   replay_end     = NULL;
+   free( replay_name );
+   replay_name    = NULL;
+   replay_mode    = REPLAY_OFF;
+   replay_state   = REPLAY_WAITING;
+   replay_frames  = 0;
+   replay_diverged = 0;
+}
+
+/**
+ * @brief Checks to see if a replay is being played back.
+ *
+ * Real input and frame timing should be ignored in favour of the replay's.
+ */
+int replay_isPlaying (void)
+{
+   return (replay_mode == REPLAY_PLAY);
+}
+
+/**
+ * @brief Lets the replay know a saved game was loaded.
+ *
+ *    @param file PhysicsFS path of the saved game.
+ */
+void replay_start( const char *file )
+{
+   char path[PATH_MAX];
+
+   if (replay_mode == REPLAY_OFF)
+      return;
+
+   /* Another game was loaded midway, which can't be captured. */
+   if (replay_state != REPLAY_WAITING) {
+      if (replay_state != REPLAY_DONE)
+         replay_finish();
+      return;
+   }
+
+   if (replay_mode == REPLAY_RECORD) {
+      /* Keep a copy of the save, as it gets overwritten when playing. */
+      if (!PHYSFS_exists( REPLAY_PATH ) && (PHYSFS_mkdir( REPLAY_PATH ) == 0)) {
+         WARN(_("Unable to create '%s' directory: %s"), REPLAY_PATH,
+               _(PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
+         replay_state = REPLAY_DONE;
+         return;
+      }
+      replay_path( path, sizeof(path), "ns" );
+      if (!PHYSFS_exists( file ) || (ndata_copyIfExists( file, path ) < 0)) {
+         replay_state = REPLAY_DONE;
+         return;
+      }
+
+      replay_path( path, sizeof(path), "txt" );
+      replay_out = PHYSFS_openWrite( path );
+      if (replay_out == NULL) {
+         WARN(_("Unable to open '%s' for writing: %s"), path,
+               _(PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
+         replay_state = REPLAY_DONE;
+         return;
+      }
+      PHYSFS_setBuffer( replay_out, REPLAY_BUFSIZE );
+   }
+
+   /* Actually starting is deferred to the main loop, as we may be in a hook. */
+   replay_state = REPLAY_PENDING;
+}
+
+/**
+ * @brief Starts the session once the game is loaded.
+ */
+static void replay_begin (void)
+{
+   if (replay_mode == REPLAY_RECORD) {
+      replay_seed = randint();
+      replay_printf( "naev-replay %d\n", REPLAY_VERSION );
+      replay_printf( "version %s\n", naev_version(0) );
+      replay_printf( "seed %u\n", replay_seed );
+   }
+
+   /* Both the engine and Lua random numbers have to start out the same. */
+   rng_seed( replay_seed );
+   lua_getglobal( naevL, "math" );
+   lua_getfield( naevL, -1, "randomseed" );
+   lua_pushnumber( naevL, replay_seed );
+   if (lua_pcall( naevL, 1, 0, 0 )) {
+      WARN(_("Unable to seed the Lua random numbers: %s"), lua_tostring( naevL, -1 ));
+      lua_pop( naevL, 1 );
+   }
+   lua_pop( naevL, 1 );
+
+   /* Landed windows can't be captured, so sessions start in space. */
+   if (landed)
+      takeoff( 1, 1 );
+
+   replay_state   = REPLAY_RUNNING;
+   replay_frames  = 0;
+   replay_timer   = SDL_GetPerformanceCounter();
+}
+
+/**
+ * @brief Ends the session.
+ */
+static void replay_finish (void)
+{
+   double elapsed;
+
+   replay_state = REPLAY_DONE;
+
+   if (replay_mode == REPLAY_RECORD) {
+      replay_printf( "e\n" );
+      if (replay_out != NULL)
+         PHYSFS_close( replay_out );
+      replay_out = NULL;
+      LOG(_("Recorded %u frames to replay '%s'."), replay_frames, replay_name);
+      return;
+   }
+
+   elapsed = (double)(SDL_GetPerformanceCounter() - replay_timer) / (double)SDL_GetPerformanceFrequency();
+   LOG(_("Played back %u frames of replay '%s' in %.3f s (%.1f FPS)%s"),
+         replay_frames, replay_name, elapsed,
+         (elapsed > 0.) ? (double)replay_frames / elapsed : 0.,
+         replay_diverged ? _(", but it diverged from the recording.") : ".");
+   naev_quit();
+}
+
+/**
+ * @brief Runs the replay at the start of a frame.
+ *
+ * When recording, logs the frame time. When playing back, runs the key
+ * bindings recorded before this frame and replaces the frame time with the
+ * recorded one.
+ *
+ *    @param[in, out] dt Real frame time.
+ */
+void replay_frame( double *dt )
+{
+   char *line;
+
+   if (replay_mode == REPLAY_OFF)
+      return;
+   if (replay_state == REPLAY_PENDING)
+      replay_begin();
+   if (replay_state != REPLAY_RUNNING)
+      return;
+
+   if (replay_mode == REPLAY_RECORD) {
+      /* Stop once the game is over. */
+      if ((player.p == NULL) || menu_isOpen(MENU_MAIN)) {
+         replay_finish();
+         return;
+      }
+      replay_printf( "f %a\n", *dt );
+      replay_frames++;
+      return;
+   }
+
+   /* Key bindings may run nested main loops, which read further ahead. */
+   while ((replay_state == REPLAY_RUNNING) && ((line = replay_next()) != NULL)) {
+      int keynum, repeat;
+      double value, kabs;
+
+      switch (line[0]) {
+         case 'k':
+            if (sscanf( line, "k %d %la %la %d", &keynum, &value, &kabs, &repeat ) != 4) {
+               WARN(_("Replay '%s' has an invalid key line: %s"), replay_name, line);
+               break;
+            }
+            input_keyReplay( keynum, value, kabs, repeat );
+            break;
+
+         case 't':
+            /* The recording ran more ticks than we did. */
+            replay_diverge();
+            break;
+
+         case 'f':
+            *dt = strtod( &line[2], NULL );
+            replay_frames++;
+            return;
+
+         case 'e':
+            replay_cur = replay_end;
+            break;
+
+         default:
+            WARN(_("Replay '%s' has an invalid line: %s"), replay_name, line);
+            break;
+      }
+   }
+
+   if (replay_state == REPLAY_RUNNING)
+      replay_finish();
+}
+
+/**
+ * @brief Runs the replay after a simulation tick.
+ *
+ * Logs or checks how many random numbers have been drawn so far.
+ */
+void replay_tick (void)
+{
+   char *line;
+   unsigned long count;
+
+   if (replay_state != REPLAY_RUNNING)
+      return;
+
+   if (replay_mode == REPLAY_RECORD) {
+      replay_printf( "t %lu\n", rng_count() );
+      return;
+   }
+
+   /* Lines other than ticks mean we ran more ticks than the recording. */
+   line = replay_peek();
+   if ((line == NULL) || (line[0] != 't')) {
+      replay_diverge();
+      return;
+   }
+   replay_next();
+   if ((sscanf( line, "t %lu", &count ) != 1) || (count != rng_count()))
+      replay_diverge();
+}
+
+/**
+ * @brief Records a key binding being run.
+ *
+ *    @param keynum The index of the keybind.
+ *    @param value The value of the keypress.
+ *    @param kabs The absolute value.
+ *    @param repeat Whether the key is still held down, rather than newly pressed.
+ */
+void replay_key( int keynum, double value, double kabs, int repeat )
+{
+   if ((replay_mode != REPLAY_RECORD) || (replay_state != REPLAY_RUNNING))
+      return;
+   replay_printf( "k %d %a %a %d\n", keynum, value, kabs, repeat );
+}
@@ -0,0 +1,20 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+#pragma once
+
+/*
+ * Setting up.
+ */
+void replay_record( const char *name );
+int replay_play( const char *name );
+void replay_exit (void);
+int replay_isPlaying (void);
+
+/*
+ * Hooks into the game loop.
+ */
+void replay_start( const char *file );
+void replay_frame( double *dt );
+void replay_tick (void);
+void replay_key( int keynum, double value, double kabs, int repeat );
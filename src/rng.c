@@ -38,6 +38,7 @@
 static uint32_t MT[624]; /**< Mersenne twister state. */
 static uint32_t mt_y; /**< Internal mersenne twister variable. */
 static int mt_pos = 0; /**< Current number being used. */
+static unsigned long mt_count = 0; /**< Numbers drawn since the last seeding. */
 
 /*
  * prototypes
@@ -80,6 +81,32 @@ void rng_init (void)
       mt_initArray( i );
    for (i=0; i<10; i++) /* generate numbers to get away from poor initial values */
       mt_genArray();
+   mt_count = 0;
+}
+
+/**
+ * @brief Reseeds the random subsystem so it generates a known sequence.
+ *
+ *    @param seed Seed to use.
+ */
+void rng_seed( unsigned int seed )
+{
+   mt_initArray( seed );
+   for (int i=0; i<10; i++) /* generate numbers to get away from poor initial values */
+      mt_genArray();
+   mt_count = 0;
+}
+
+/**
+ * @brief Gets how many random numbers have been drawn since the last seeding.
+ *
+ * Used to check that replayed sessions stay in sync with the recording.
+ *
+ *    @return Number of random numbers drawn.
+ */
+unsigned long rng_count (void)
+{
+   return mt_count;
 }
 
 /**
@@ -148,6 +175,7 @@ static uint32_t mt_getInt (void)
    if (mt_pos >= 624)
       mt_genArray();
 
+   mt_count++;
    mt_y = MT[mt_pos++];
    mt_y ^= mt_y >> 11;
    mt_y ^= (mt_y << 7) & 2636928640U;
@@ -40,6 +40,8 @@
 
 /* Init */
 void rng_init (void);
+void rng_seed( unsigned int seed );
+unsigned long rng_count (void);
 
 /* Random functions */
 unsigned int randint (void);
@@ -32,10 +32,21 @@
 #include "nxml.h"
 #include "player.h"
 #include "plugin.h"
+#include "savefile.h"
 #include "shiplog.h"
 #include "start.h"
 #include "unidiff.h"
 
+#define SAVE_TMP_SUFFIX   ".part" /**< Suffix of saves while they are being written. */
+
+/**
+ * @brief Section of a saved game handled by a subsystem.
+ */
+typedef struct SaveSection_ {
+   const char *chunk; /**< Tag of the chunk holding it. */
+   int (*save)( xmlTextWriterPtr writer ); /**< Saves the section. */
+} SaveSection;
+
 int save_loaded   = 0; /**< Just loaded the saved game. */
 
 /*
@@ -62,6 +73,27 @@ extern int economy_sysSave( xmlTextWriterPtr writer ); /**< Saves the economy st
 extern int diff_save( xmlTextWriterPtr writer ); /**< Saves the universe diffs. */
 /* static */
 static int save_data( xmlTextWriterPtr writer );
+static int save_xml( const char *path );
+static int save_head( SaveFile *sf );
+static int save_chunk( SaveFile *sf, xmlBufferPtr buf, const SaveSection *s );
+static int save_chunked( const char *path );
+
+/**
+ * @brief Sections of the saved game, in the order they are saved.
+ */
+static const SaveSection save_sections[] = {
+   { SAVE_CHUNK_DIFF,      diff_save }, /* Must save first or can get cleared. */
+   { SAVE_CHUNK_PLAYER,    player_save },
+   { SAVE_CHUNK_MISSIONS,  missions_saveActive },
+   { SAVE_CHUNK_EVENTS,    events_saveActive },
+   { SAVE_CHUNK_NEWS,      news_saveArticles },
+   { SAVE_CHUNK_VARS,      var_save },
+   { SAVE_CHUNK_FACTIONS,  pfaction_save },
+   { SAVE_CHUNK_HOOKS,     hook_save },
+   { SAVE_CHUNK_SPACE,     space_sysSave },
+   { SAVE_CHUNK_ECONOMY,   economy_sysSave },
+   { SAVE_CHUNK_SHIPLOG,   shiplog_save },
+};
 
 /**
  * @brief Saves all the player's game data.
@@ -71,52 +103,30 @@ static int save_data( xmlTextWriterPtr writer );
  */
 static int save_data( xmlTextWriterPtr writer )
 {
-   /* the data itself */
-   if (diff_save(writer) < 0) return -1; /* Must save first or can get cleared. */
-   if (player_save(writer) < 0) return -1;
-   if (missions_saveActive(writer) < 0) return -1;
-   if (events_saveActive(writer) < 0) return -1;
-   if (news_saveArticles( writer ) < 0) return -1;
-   if (var_save(writer) < 0) return -1;
-   if (pfaction_save(writer) < 0) return -1;
-   if (hook_save(writer) < 0) return -1;
-   if (space_sysSave(writer) < 0) return -1;
-   if (economy_sysSave(writer) < 0) return -1;
-   if (shiplog_save(writer) < 0) return -1;
+   for (size_t i=0; i<sizeof(save_sections)/sizeof(save_sections[0]); i++)
+      if (save_sections[i].save( writer ) < 0)
+         return -1;
    return 0;
 }
 
 /**
- * @brief Saves the current game.
+ * @brief Saves the current game as a single XML document.
  *
- *    @return 0 on success.
- */
-int save_all (void)
-{
-   return save_all_with_name( "autosave" );
-}
-
-/**
- * @brief Saves the current game.
+ * This is the export format, it is also what older versions used.
  *
- *    @param name Name of custom snapshot.
+ *    @param path Path of the file to write to.
  *    @return 0 on success.
  */
-int save_all_with_name( const char *name )
+static int save_xml( const char *path )
 {
-   char file[PATH_MAX];
    const plugin_t *plugins = plugin_list();
-   xmlDocPtr doc;
    xmlTextWriterPtr writer;
 
-   /* Do not save if saving is off. */
-   if (player_isFlag(PLAYER_NOSAVE))
-      return 0;
-
-   /* Create the writer. */
-   writer = xmlNewTextWriterDoc(&doc, conf.save_compress);
+   /* Create the writer. It streams straight into the file (gzipped if
+    * save_compress is set) instead of building a document in memory. */
+   writer = xmlNewTextWriterFilename(path, conf.save_compress);
    if (writer == NULL) {
-      ERR(_("testXmlwriterDoc: Error creating the xml writer"));
+      WARN(_("Unable to create the xml writer for '%s'!"), path);
       return -1;
    }
 
@@ -151,20 +161,164 @@ int save_all_with_name( const char *name )
    /* Finish element. */
    xmlw_endElem(writer); /* "naev_save" */
    xmlw_done(writer);
+   if (xmlTextWriterFlush(writer) < 0) {
+      WARN(_("Failed to write saved game to '%s'!"), path);
+      goto err_writer;
+   }
+   xmlFreeTextWriter(writer);
+   return 0;
+
+err_writer:
+   xmlFreeTextWriter(writer);
+   return -1;
+}
+
+/**
+ * @brief Saves the header chunk.
+ *
+ * Holds everything the load menus display, so they never have to look at the
+ * rest of the saved game.
+ *
+ *    @param sf Saved game to write to.
+ *    @return 0 on success.
+ */
+static int save_head( SaveFile *sf )
+{
+   const plugin_t *plugins = plugin_list();
+   char *buf = array_create( char );
+   int ret;
+
+   savefile_packStr( &buf, naev_version( 0 ) );
+   savefile_packStr( &buf, start_name() );
+   savefile_packU64( &buf, time(NULL) );
+   savefile_packU32( &buf, array_size(plugins) );
+   for (int i=0; i<array_size(plugins); i++)
+      savefile_packStr( &buf, plugin_name( &plugins[i] ) );
+   savefile_packStr( &buf, player.name );
+   savefile_packStr( &buf, land_spob->name );
+   savefile_packStr( &buf, player.chapter );
+   savefile_packStr( &buf, player.difficulty );
+   savefile_packU64( &buf, player.p->credits );
+   savefile_packU64( &buf, ntime_get() );
+   savefile_packStr( &buf, player.p->name );
+   savefile_packStr( &buf, player.p->ship->name );
+
+   ret = savefile_write( sf, SAVE_CHUNK_HEAD, SAVE_HEAD_VERSION, buf, array_size(buf) );
+   array_free( buf );
+   return ret;
+}
+
+/**
+ * @brief Saves a section of the saved game into its own chunk.
+ *
+ *    @param sf Saved game to write to.
+ *    @param buf Buffer to use, reused between chunks.
+ *    @param s Section to save.
+ *    @return 0 on success.
+ */
+static int save_chunk( SaveFile *sf, xmlBufferPtr buf, const SaveSection *s )
+{
+   xmlTextWriterPtr writer;
+   int ret;
+
+   xmlBufferEmpty( buf );
+   writer = xmlNewTextWriterMemory( buf, 0 );
+   if (writer == NULL) {
+      WARN(_("Unable to create the xml writer for the '%s' chunk!"), s->chunk);
+      return -1;
+   }
+
+   /* Wrapped like a whole saved game so the loaders work unchanged. Not
+    * indented, nobody reads it. */
+   xmlw_start(writer);
+   xmlw_startElem(writer,"naev_save");
+   ret = s->save( writer );
+   xmlw_endElem(writer); /* "naev_save" */
+   xmlw_done(writer);
+   xmlFreeTextWriter(writer); /* Flushes into buf. */
+   if (ret < 0)
+      return -1;
 
-   /* Write to file. */
+   return savefile_write( sf, s->chunk, SAVE_CHUNK_VERSION,
+         xmlBufferContent(buf), xmlBufferLength(buf) );
+}
+
+/**
+ * @brief Saves the current game in the chunked format.
+ *
+ *    @param path Path of the file to write to.
+ *    @return 0 on success.
+ */
+static int save_chunked( const char *path )
+{
+   xmlBufferPtr buf;
+   SaveFile *sf = savefile_create( path, conf.save_compress );
+   if (sf == NULL)
+      return -1;
+
+   /* Header first so the load menus only have to read the start. */
+   if (save_head( sf ) < 0)
+      goto err;
+
+   buf = xmlBufferCreate();
+   for (size_t i=0; i<sizeof(save_sections)/sizeof(save_sections[0]); i++) {
+      if (save_chunk( sf, buf, &save_sections[i] ) < 0) {
+         ERR(_("Trying to save game data"));
+         xmlBufferFree( buf );
+         goto err;
+      }
+   }
+   xmlBufferFree( buf );
+
+   if (savefile_close( sf ) < 0) {
+      WARN(_("Failed to write saved game to '%s'!"), path);
+      return -1;
+   }
+   return 0;
+
+err:
+   savefile_close( sf );
+   return -1;
+}
+
+/**
+ * @brief Saves the current game.
+ *
+ *    @return 0 on success.
+ */
+int save_all (void)
+{
+   return save_all_with_name( "autosave" );
+}
+
+/**
+ * @brief Saves the current game.
+ *
+ *    @param name Name of custom snapshot.
+ *    @return 0 on success.
+ */
+int save_all_with_name( const char *name )
+{
+   char file[PATH_MAX], tmp[PATH_MAX];
+   int ret;
+
+   /* Do not save if saving is off. */
+   if (player_isFlag(PLAYER_NOSAVE))
+      return 0;
+
+   /* Make sure the directories exist. */
    if (PHYSFS_mkdir("saves") == 0) {
       snprintf(file, sizeof(file), "%s/saves", PHYSFS_getWriteDir());
       WARN(_( "Dir '%s' does not exist and unable to create: %s" ), file,
          _(PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
-      goto err_writer;
+      return -1;
    }
    snprintf(file, sizeof(file), "saves/%s", player.name);
    if (PHYSFS_mkdir(file) == 0) {
       snprintf(file, sizeof(file), "%s/saves/%s", PHYSFS_getWriteDir(), player.name);
       WARN(_( "Dir '%s' does not exist and unable to create: %s" ), file,
          _(PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
-      goto err_writer;
+      return -1;
    }
 
    /* Back up old saved game. */
@@ -175,29 +329,37 @@ int save_all_with_name( const char *name )
          snprintf(backup, sizeof(backup), "saves/%s/backup.ns", player.name);
          if (ndata_copyIfExists(file, backup) < 0) {
             WARN(_("Aborting save…"));
-            goto err_writer;
+            return -1;
          }
       }
       save_loaded = 0;
    }
 
-   /* Critical section, if crashes here player's game gets corrupted.
-    * Luckily we have a copy just in case... */
-   xmlFreeTextWriter(writer);
+   /* Write to a temporary file first. */
    snprintf(file, sizeof(file), "%s/saves/%s/%s.ns", PHYSFS_getWriteDir(), player.name, name); /* TODO: write via physfs */
-   if (xmlSaveFileEnc(file, doc, "UTF-8") < 0) {
-      WARN(_("Failed to write saved game!  You'll most likely have to restore it by copying your backup saved game over your current saved game."));
-      goto err;
+   snprintf(tmp, sizeof(tmp), "%s"SAVE_TMP_SUFFIX, file);
+   if (conf.save_xml)
+      ret = save_xml( tmp );
+   else
+      ret = save_chunked( tmp );
+   if (ret < 0) {
+      remove(tmp);
+      return -1;
    }
-   xmlFreeDoc(doc);
 
-   return 0;
+   /* Only replace the old save once the new one is fully written, so a crash
+    * while saving can not corrupt the player's game. */
+   if (rename(tmp, file) != 0) {
+      /* Windows will not rename over an existing file. */
+      remove(file);
+      if (rename(tmp, file) != 0) {
+         WARN(_("Failed to move saved game '%s' to '%s': %s"), tmp, file, strerror(errno));
+         remove(tmp);
+         return -1;
+      }
+   }
 
-err_writer:
-   xmlFreeTextWriter(writer);
-err:
-   xmlFreeDoc(doc);
-   return -1;
+   return 0;
 }
 
 /**
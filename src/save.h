@@ -3,6 +3,24 @@
  */
 #pragma once
 
+/*
+ * Chunks of saved games, see savefile.h.
+ */
+#define SAVE_HEAD_VERSION     1        /**< Version of the header chunk. */
+#define SAVE_CHUNK_VERSION    1        /**< Version of the subsystem chunks. */
+#define SAVE_CHUNK_HEAD       "HEAD"   /**< Header shown in the load menus. */
+#define SAVE_CHUNK_DIFF       "DIFF"   /**< Universe diffs. */
+#define SAVE_CHUNK_PLAYER     "PLYR"   /**< Player, ships and outfits. */
+#define SAVE_CHUNK_MISSIONS   "MISN"   /**< Active missions. */
+#define SAVE_CHUNK_EVENTS     "EVTS"   /**< Active events. */
+#define SAVE_CHUNK_NEWS       "NEWS"   /**< News articles. */
+#define SAVE_CHUNK_VARS       "VARS"   /**< Mission variables. */
+#define SAVE_CHUNK_FACTIONS   "FACT"   /**< Faction standings. */
+#define SAVE_CHUNK_HOOKS      "HOOK"   /**< Hooks. */
+#define SAVE_CHUNK_SPACE      "SPCE"   /**< Known systems and spobs. */
+#define SAVE_CHUNK_ECONOMY    "ECON"   /**< Economy. */
+#define SAVE_CHUNK_SHIPLOG    "SLOG"   /**< Ship log. */
+
 int save_all (void);
 int save_all_with_name( const char *name );
 void save_reload (void);
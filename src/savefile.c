@@ -0,0 +1,462 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+/**
+ * @file savefile.c
+ *
+ * @brief Chunked container for saved games.
+ *
+ * A saved game is a small header followed by a list of chunks:
+ *
+ *    "NAEVSAVE" | u32 container version
+ *    tag[4] | u32 chunk version | u32 flags | u32 length | u32 stored length | data
+ *    ...
+ *
+ * All values are little endian. Every subsystem gets its own chunk with its
+ * own version so it can be read back without going through the rest of the
+ * file, and chunks can be compressed individually.
+ */
+/** @cond */
+#include <errno.h>
+#include <stdio.h>
+#include <zlib.h>
+#include "physfs.h"
+
+#include "naev.h"
+/** @endcond */
+
+#include "savefile.h"
+
+#include "array.h"
+#include "log.h"
+
+#define SAVEFILE_MAGIC     "NAEVSAVE" /**< Identifies chunked saves. */
+#define SAVEFILE_MAGICLEN  8 /**< Length of the magic. */
+#define SAVEFILE_HEADLEN   (SAVEFILE_TAGLEN+4*4) /**< Length of a chunk header. */
+
+#define SAVEFILE_MAXLEN    (256*1024*1024) /**< Largest chunk that will be read, anything bigger is corrupt. */
+
+#define SAVEFILE_ZLIB      (1<<0) /**< Chunk data is compressed with zlib. */
+
+/**
+ * @brief Chunk of a saved game being read.
+ */
+typedef struct SaveChunk_ {
+   char tag[SAVEFILE_TAGLEN+1]; /**< Tag of the chunk. */
+   uint32_t version; /**< Version of the chunk contents. */
+   uint32_t flags; /**< Chunk flags. */
+   uint32_t len; /**< Length of the data. */
+   uint32_t stored; /**< Length of the data in the file. */
+   PHYSFS_uint64 offset; /**< Offset of the data in the file. */
+} SaveChunk;
+
+/**
+ * @brief A chunked saved game.
+ */
+struct SaveFile_ {
+   FILE *fw; /**< File being written. */
+   int compress; /**< Whether or not to compress chunks being written. */
+   int err; /**< Writing failed. */
+   PHYSFS_File *fr; /**< File being read. */
+   SaveChunk *chunks; /**< Chunks of the file being read (array.h). */
+};
+
+/*
+ * Prototypes.
+ */
+static void savefile_setU32( unsigned char *b, uint32_t val );
+static uint32_t savefile_getU32( const unsigned char *b );
+static int savefile_fwrite( SaveFile *sf, const void *data, size_t len );
+static const SaveChunk *savefile_find( const SaveFile *sf, const char *tag );
+
+/**
+ * @brief Stores a little endian 32 bit value.
+ */
+static void savefile_setU32( unsigned char *b, uint32_t val )
+{
+   for (int i=0; i<4; i++)
+      b[i] = (val >> (8*i)) & 0xff;
+}
+
+/**
+ * @brief Gets a little endian 32 bit value.
+ */
+static uint32_t savefile_getU32( const unsigned char *b )
+{
+   uint32_t val = 0;
+   for (int i=0; i<4; i++)
+      val |= (uint32_t)b[i] << (8*i);
+   return val;
+}
+
+/**
+ * @brief Writes raw data to a saved game being written, remembering failures.
+ */
+static int savefile_fwrite( SaveFile *sf, const void *data, size_t len )
+{
+   if (sf->err)
+      return -1;
+   if ((len > 0) && (fwrite( data, 1, len, sf->fw ) != len)) {
+      sf->err = 1;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * @brief Creates a new chunked saved game.
+ *
+ *    @param path Path of the file to write to (not a PhysicsFS path).
+ *    @param compress Whether or not to compress the chunks.
+ *    @return The new saved game or NULL on failure.
+ */
+SaveFile *savefile_create( const char *path, int compress )
+{
+   unsigned char ver[4];
+   SaveFile *sf = calloc( 1, sizeof(SaveFile) );
+   sf->compress = compress;
+   sf->fw = fopen( path, "wb" );
+   if (sf->fw == NULL) {
+      WARN(_("Unable to open '%s' for writing: %s"), path, strerror(errno));
+      free( sf );
+      return NULL;
+   }
+
+   savefile_setU32( ver, SAVEFILE_VERSION );
+   savefile_fwrite( sf, SAVEFILE_MAGIC, SAVEFILE_MAGICLEN );
+   savefile_fwrite( sf, ver, sizeof(ver) );
+   return sf;
+}
+
+/**
+ * @brief Appends a chunk to a saved game being written.
+ *
+ *    @param sf Saved game to write to.
+ *    @param tag Tag of the chunk, SAVEFILE_TAGLEN characters.
+ *    @param version Version of the contents of the chunk.
+ *    @param data Data of the chunk.
+ *    @param len Length of the data.
+ *    @return 0 on success.
+ */
+int savefile_write( SaveFile *sf, const char *tag, uint32_t version, const void *data, size_t len )
+{
+   unsigned char head[SAVEFILE_HEADLEN];
+   const void *stored = data;
+   uLongf slen = len;
+   Bytef *buf = NULL;
+   uint32_t flags = 0;
+   int ret;
+
+   if (len > UINT32_MAX) {
+      WARN(_("Saved game chunk '%s' is too large!"), tag);
+      sf->err = 1;
+      return -1;
+   }
+
+   /* Compress, only keeping the result if it is actually smaller. Speed is
+    * favoured as this is done on every landing. */
+   if (sf->compress && (len > 0)) {
+      slen = compressBound( len );
+      buf  = malloc( slen );
+      if ((compress2( buf, &slen, data, len, Z_BEST_SPEED ) == Z_OK) && (slen < len)) {
+         stored = buf;
+         flags |= SAVEFILE_ZLIB;
+      }
+      else
+         slen = len;
+   }
+
+   memcpy( head, tag, SAVEFILE_TAGLEN );
+   savefile_setU32( &head[SAVEFILE_TAGLEN],    version );
+   savefile_setU32( &head[SAVEFILE_TAGLEN+4],  flags );
+   savefile_setU32( &head[SAVEFILE_TAGLEN+8],  len );
+   savefile_setU32( &head[SAVEFILE_TAGLEN+12], slen );
+   ret = savefile_fwrite( sf, head, sizeof(head) );
+   if (ret == 0)
+      ret = savefile_fwrite( sf, stored, slen );
+   free( buf );
+   return ret;
+}
+
+/**
+ * @brief Finishes writing a saved game and frees it.
+ *
+ *    @param sf Saved game to close.
+ *    @return 0 if the whole file was written successfully.
+ */
+int savefile_close( SaveFile *sf )
+{
+   int err = sf->err;
+   if (fflush( sf->fw ) != 0)
+      err = 1;
+   if (fclose( sf->fw ) != 0)
+      err = 1;
+   free( sf );
+   return err ? -1 : 0;
+}
+
+/**
+ * @brief Checks to see if a file is a chunked saved game.
+ *
+ *    @param path PhysicsFS path of the file.
+ *    @return 1 if it is a chunked saved game, 0 otherwise.
+ */
+int savefile_isChunked( const char *path )
+{
+   char magic[SAVEFILE_MAGICLEN];
+   PHYSFS_sint64 n;
+   PHYSFS_File *f = PHYSFS_openRead( path );
+   if (f == NULL)
+      return 0;
+   n = PHYSFS_readBytes( f, magic, sizeof(magic) );
+   PHYSFS_close( f );
+   return (n == SAVEFILE_MAGICLEN) && (memcmp( magic, SAVEFILE_MAGIC, SAVEFILE_MAGICLEN )==0);
+}
+
+/**
+ * @brief Opens a chunked saved game for reading.
+ *
+ * Only the chunk headers are read, the contents are read on demand with
+ * savefile_read().
+ *
+ *    @param path PhysicsFS path of the file.
+ *    @return The saved game or NULL if it is not a valid chunked saved game.
+ */
+SaveFile *savefile_open( const char *path )
+{
+   unsigned char buf[SAVEFILE_HEADLEN];
+   PHYSFS_sint64 flen, n;
+   uint32_t version;
+   SaveFile *sf;
+
+   sf = calloc( 1, sizeof(SaveFile) );
+   sf->fr = PHYSFS_openRead( path );
+   if (sf->fr == NULL) {
+      WARN(_("Unable to open '%s' for reading: %s"), path,
+            _(PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
+      free( sf );
+      return NULL;
+   }
+   flen = PHYSFS_fileLength( sf->fr );
+
+   /* Container header. */
+   n = PHYSFS_readBytes( sf->fr, buf, SAVEFILE_MAGICLEN+4 );
+   if ((n != SAVEFILE_MAGICLEN+4) || (memcmp( buf, SAVEFILE_MAGIC, SAVEFILE_MAGICLEN )!=0)) {
+      WARN(_("Saved game '%s' is not a chunked saved game!"), path);
+      goto err;
+   }
+   version = savefile_getU32( &buf[SAVEFILE_MAGICLEN] );
+   if (version > SAVEFILE_VERSION) {
+      WARN(_("Saved game '%s' uses a newer format (%u > %u)!"), path, version, SAVEFILE_VERSION);
+      goto err;
+   }
+
+   /* Chunk directory. */
+   sf->chunks = array_create( SaveChunk );
+   while ((n = PHYSFS_readBytes( sf->fr, buf, SAVEFILE_HEADLEN )) > 0) {
+      SaveChunk *c;
+      if (n != SAVEFILE_HEADLEN) {
+         WARN(_("Saved game '%s' is truncated!"), path);
+         goto err;
+      }
+      c = &array_grow( &sf->chunks );
+      memcpy( c->tag, buf, SAVEFILE_TAGLEN );
+      c->tag[SAVEFILE_TAGLEN] = '\0';
+      c->version  = savefile_getU32( &buf[SAVEFILE_TAGLEN] );
+      c->flags    = savefile_getU32( &buf[SAVEFILE_TAGLEN+4] );
+      c->len      = savefile_getU32( &buf[SAVEFILE_TAGLEN+8] );
+      c->stored   = savefile_getU32( &buf[SAVEFILE_TAGLEN+12] );
+      c->offset   = PHYSFS_tell( sf->fr );
+      if ((c->len > SAVEFILE_MAXLEN) || (c->stored > SAVEFILE_MAXLEN) ||
+            (!(c->flags & SAVEFILE_ZLIB) && (c->len != c->stored))) {
+         WARN(_("Saved game '%s' has a corrupt '%s' chunk!"), path, c->tag);
+         goto err;
+      }
+      if (((flen >= 0) && ((PHYSFS_sint64)(c->offset + c->stored) > flen)) ||
+            !PHYSFS_seek( sf->fr, c->offset + c->stored )) {
+         WARN(_("Saved game '%s' is truncated!"), path);
+         goto err;
+      }
+   }
+   if (n < 0) {
+      WARN(_("Unable to read '%s': %s"), path,
+            _(PHYSFS_getErrorByCode( PHYSFS_getLastErrorCode() ) ) );
+      goto err;
+   }
+
+   return sf;
+
+err:
+   savefile_free( sf );
+   return NULL;
+}
+
+/**
+ * @brief Finds a chunk by tag.
+ */
+static const SaveChunk *savefile_find( const SaveFile *sf, const char *tag )
+{
+   for (int i=0; i<array_size(sf->chunks); i++)
+      if (strncmp( sf->chunks[i].tag, tag, SAVEFILE_TAGLEN )==0)
+         return &sf->chunks[i];
+   return NULL;
+}
+
+/**
+ * @brief Checks to see if a saved game has a chunk.
+ *
+ *    @param sf Saved game to check.
+ *    @param tag Tag of the chunk.
+ *    @return 1 if the chunk exists, 0 otherwise.
+ */
+int savefile_has( const SaveFile *sf, const char *tag )
+{
+   return (savefile_find( sf, tag ) != NULL);
+}
+
+/**
+ * @brief Reads the contents of a chunk.
+ *
+ *    @param sf Saved game to read from.
+ *    @param tag Tag of the chunk to read.
+ *    @param[out] version Version of the chunk contents (can be NULL).
+ *    @param[out] len Length of the data (can be NULL).
+ *    @return Newly allocated, nul terminated, data of the chunk or NULL on failure.
+ */
+char *savefile_read( SaveFile *sf, const char *tag, uint32_t *version, size_t *len )
+{
+   const SaveChunk *c = savefile_find( sf, tag );
+   char *stored, *data;
+
+   if (c == NULL) {
+      WARN(_("Saved game is missing the '%s' chunk!"), tag);
+      return NULL;
+   }
+
+   stored = malloc( (size_t)c->stored+1 );
+   if (stored == NULL) {
+      WARN(_("Out of Memory"));
+      return NULL;
+   }
+   if (!PHYSFS_seek( sf->fr, c->offset ) ||
+         (PHYSFS_readBytes( sf->fr, stored, c->stored ) != (PHYSFS_sint64)c->stored)) {
+      WARN(_("Unable to read the '%s' chunk of the saved game!"), tag);
+      free( stored );
+      return NULL;
+   }
+
+   if (c->flags & SAVEFILE_ZLIB) {
+      uLongf dlen = c->len;
+      data = malloc( (size_t)c->len+1 );
+      if (data == NULL) {
+         WARN(_("Out of Memory"));
+         free( stored );
+         return NULL;
+      }
+      if ((uncompress( (Bytef*)data, &dlen, (const Bytef*)stored, c->stored ) != Z_OK) || (dlen != c->len)) {
+         WARN(_("The '%s' chunk of the saved game is corrupt!"), tag);
+         free( stored );
+         free( data );
+         return NULL;
+      }
+      free( stored );
+   }
+   else
+      data = stored;
+   data[c->len] = '\0';
+
+   if (version != NULL)
+      *version = c->version;
+   if (len != NULL)
+      *len = c->len;
+   return data;
+}
+
+/**
+ * @brief Frees a saved game being read.
+ */
+void savefile_free( SaveFile *sf )
+{
+   if (sf == NULL)
+      return;
+   if (sf->fr != NULL)
+      PHYSFS_close( sf->fr );
+   array_free( sf->chunks );
+   free( sf );
+}
+
+/**
+ * @brief Appends a 32 bit value to a chunk.
+ */
+void savefile_packU32( char **buf, uint32_t val )
+{
+   int n = array_size(*buf);
+   array_resize( buf, n+4 );
+   savefile_setU32( (unsigned char*)&(*buf)[n], val );
+}
+
+/**
+ * @brief Appends a 64 bit value to a chunk.
+ */
+void savefile_packU64( char **buf, uint64_t val )
+{
+   savefile_packU32( buf, val & 0xffffffff );
+   savefile_packU32( buf, val >> 32 );
+}
+
+/**
+ * @brief Appends a string to a chunk, NULL is stored as an empty string.
+ */
+void savefile_packStr( char **buf, const char *str )
+{
+   size_t len = (str != NULL) ? strlen(str) : 0;
+   int n;
+   savefile_packU32( buf, len );
+   n = array_size(*buf);
+   array_resize( buf, n+len );
+   if (len > 0)
+      memcpy( &(*buf)[n], str, len );
+}
+
+/**
+ * @brief Reads a 32 bit value from a chunk.
+ */
+uint32_t savefile_unpackU32( SaveCursor *sc )
+{
+   uint32_t val;
+   if (sc->err || (sc->len - sc->pos < 4)) {
+      sc->err = 1;
+      return 0;
+   }
+   val = savefile_getU32( (const unsigned char*)&sc->data[sc->pos] );
+   sc->pos += 4;
+   return val;
+}
+
+/**
+ * @brief Reads a 64 bit value from a chunk.
+ */
+uint64_t savefile_unpackU64( SaveCursor *sc )
+{
+   uint64_t lo = savefile_unpackU32( sc );
+   uint64_t hi = savefile_unpackU32( sc );
+   return lo | (hi << 32);
+}
+
+/**
+ * @brief Reads a string from a chunk.
+ *
+ *    @return Newly allocated string or NULL if it is empty or on failure.
+ */
+char *savefile_unpackStr( SaveCursor *sc )
+{
+   uint32_t len = savefile_unpackU32( sc );
+   if (sc->err || (sc->len - sc->pos < len)) {
+      sc->err = 1;
+      return NULL;
+   }
+   sc->pos += len;
+   if (len == 0)
+      return NULL;
+   return strndup( &sc->data[sc->pos-len], len );
+}
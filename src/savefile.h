@@ -0,0 +1,47 @@
+/*
+ * See Licensing and Copyright notice in naev.h
+ */
+#pragma once
+
+/** @cond */
+#include <stddef.h>
+#include <stdint.h>
+/** @endcond */
+
+#define SAVEFILE_VERSION   1 /**< Version of the chunked save container. */
+#define SAVEFILE_TAGLEN    4 /**< Length of a chunk tag. */
+
+/**
+ * @brief A chunked saved game, either being written or being read.
+ */
+typedef struct SaveFile_ SaveFile;
+
+/**
+ * @brief Cursor to unpack the values of a chunk.
+ */
+typedef struct SaveCursor_ {
+   const char *data; /**< Chunk data. */
+   size_t len; /**< Length of the data. */
+   size_t pos; /**< Current position. */
+   int err; /**< Set when reading past the end of the data. */
+} SaveCursor;
+
+/* Writing. */
+SaveFile *savefile_create( const char *path, int compress );
+int savefile_write( SaveFile *sf, const char *tag, uint32_t version, const void *data, size_t len );
+int savefile_close( SaveFile *sf );
+
+/* Reading. */
+int savefile_isChunked( const char *path );
+SaveFile *savefile_open( const char *path );
+int savefile_has( const SaveFile *sf, const char *tag );
+char *savefile_read( SaveFile *sf, const char *tag, uint32_t *version, size_t *len );
+void savefile_free( SaveFile *sf );
+
+/* Packing values, buf is an array.h char array. */
+void savefile_packU32( char **buf, uint32_t val );
+void savefile_packU64( char **buf, uint64_t val );
+void savefile_packStr( char **buf, const char *str );
+uint32_t savefile_unpackU32( SaveCursor *sc );
+uint64_t savefile_unpackU64( SaveCursor *sc );
+char *savefile_unpackStr( SaveCursor *sc );
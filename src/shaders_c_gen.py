@@ -101,6 +101,14 @@ SHADERS = [
       uniforms = ["projection", "color", "tex_mat", "sampler"],
       subroutines = {},
    ),
+   Shader(
+      name = "texture_batch",
+      vs_path = "texture_batch.vert",
+      fs_path = "texture_batch.frag",
+      attributes = ["vertex", "vertex_tex", "vertex_color", "vertex_inter"],
+      uniforms = ["projection", "sampler1", "sampler2"],
+      subroutines = {},
+   ),
    Shader(
       name = "texture_interpolate",
       vs_path = "texture.vert",
@@ -166,6 +174,30 @@ SHADERS = [
       subroutines = {},
       geom_path = "dust.geom",
    ),
+   Shader(
+      name = "map_jumplanes",
+      vs_path = "map_jumplanes.vert",
+      fs_path = "map_jumplanes.frag",
+      attributes = ["vertex", "vertex_lane", "vertex_color", "vertex_color2", "vertex_width"],
+      uniforms = ["projection", "view", "radius"],
+      subroutines = {},
+   ),
+   Shader(
+      name = "map_systems",
+      vs_path = "map_systems.vert",
+      fs_path = "map_systems.frag",
+      attributes = ["vertex", "vertex_center", "vertex_disk", "vertex_color"],
+      uniforms = ["projection", "view", "radius"],
+      subroutines = {},
+   ),
+   Shader(
+      name = "radarmarker",
+      vs_path = "radarmarker.vert",
+      fs_path = "radarmarker.frag",
+      attributes = ["vertex", "vertex_center", "vertex_size", "vertex_angle", "vertex_shape", "vertex_color"],
+      uniforms = ["projection"],
+      subroutines = {},
+   ),
    Shader(
       name = "lines",
       vs_path = "lines.vert",
@@ -182,6 +214,14 @@ SHADERS = [
       uniforms = ["projection", "m", "color", "outline_color"],
       subroutines = {},
    ),
+   Shader(
+      name = "font_layout",
+      vs_path = "font_layout.vert",
+      fs_path = "font_layout.frag",
+      attributes = ["vertex", "tex_coord", "vertex_color", "vertex_m"],
+      uniforms = ["projection", "color", "base", "outline_color"],
+      subroutines = {},
+   ),
    Shader(
       name = "beam",
       vs_path = "project_pos.vert",
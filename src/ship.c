@@ -19,6 +19,7 @@
 #include "array.h"
 #include "colour.h"
 #include "conf.h"
+#include "intern.h"
 #include "log.h"
 #include "ndata.h"
 #include "nfile.h"
@@ -46,12 +47,15 @@
 
 #define STATS_DESC_MAX 256 /**< Maximum length for statistics description. */
 
+#define SHIP_GFX_STORE_TIMEOUT   (5*60*1000) /**< Milliseconds before an unused store graphic is freed. */
+
 static Ship* ship_stack = NULL; /**< Stack of ships available in the game. */
+static int *ship_idmap = NULL; /**< Array (array.h): Maps interned ship names to ship_stack indices. */
 
 /*
  * Prototypes
  */
-static int ship_loadGFX( Ship *temp, const char *buf, int sx, int sy, int engine );
+static int ship_loadGFX( Ship *temp, const char *buf, int engine );
 static int ship_loadPLG( Ship *temp, const char *buf, int size_hint );
 static int ship_parse( Ship *temp, const char *filename );
 static void ship_freeSlot( ShipOutfitSlot* s );
@@ -89,8 +93,10 @@ const Ship* ship_get( const char* name )
  */
 const Ship* ship_getW( const char* name )
 {
-   const Ship s = {.name = (char*)name };
-   return bsearch( &s, ship_stack, array_size(ship_stack), sizeof(Ship), ship_cmp );
+   int id = intern_mapGet( ship_idmap, name );
+   if (id < 0)
+      return NULL;
+   return &ship_stack[id];
 }
 
 /**
@@ -337,138 +343,138 @@ int ship_size( const Ship *s )
 }
 
 /**
- * @brief Generates a target graphic for a ship.
+ * @brief Generates the target and store graphics for a ship.
+ *
+ * Only the graphics that are not already loaded are generated.
+ *
+ *    @param temp Ship to generate graphics for.
+ *    @param surface Space sprite sheet surface.
+ *    @param sx Number of X sprites in image.
+ *    @param sy Number of Y sprites in image.
+ *    @param target Whether to generate the target graphic too.
  */
-static int ship_genTargetGFX( Ship *temp, SDL_Surface *surface, int sx, int sy )
+static int ship_genTargetGFX( Ship *temp, SDL_Surface *surface, int sx, int sy, int target )
 {
    SDL_Surface *gfx, *gfx_store;
    int x, y, sw, sh;
    SDL_Rect rtemp, dstrect;
    char buf[PATH_MAX];
+   glTexture sheet;
 
    /* Get sprite size. */
-   sw = temp->gfx_space->w / sx;
-   sh = temp->gfx_space->h / sy;
+   sw = surface->w / sx;
+   sh = surface->h / sy;
 
    /* Create the surface. */
    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
 
-   /* create the temp POT surface */
-   gfx = SDL_CreateRGBSurface( 0, sw, sh,
-         surface->format->BytesPerPixel*8, RGBAMASK );
-   gfx_store = SDL_CreateRGBSurface( 0, SHIP_TARGET_W, SHIP_TARGET_H,
-         surface->format->BytesPerPixel*8, RGBAMASK );
-
-   if (gfx == NULL) {
-      WARN( _("Unable to create ship '%s' targeting surface."), temp->name );
-      return -1;
-   }
-
-   /* Copy over for target. */
-   gl_getSpriteFromDir( &x, &y, temp->gfx_space, M_PI* 5./4. );
+   /* Get the sprite to use without needing the space texture. */
+   memset( &sheet, 0, sizeof(sheet) );
+   sheet.sx = sx;
+   sheet.sy = sy;
+   gl_getSpriteFromDir( &x, &y, &sheet, M_PI* 5./4. );
    rtemp.x = sw * x;
    rtemp.y = sh * y;
    rtemp.w = sw;
    rtemp.h = sh;
-   dstrect.x = 0;
-   dstrect.y = 0;
-   dstrect.w = rtemp.w;
-   dstrect.h = rtemp.h;
-   SDL_BlitSurface( surface, &rtemp, gfx, &dstrect );
 
-   /* Copy over for store. */
-   dstrect.x = (SHIP_TARGET_W - sw) / 2;
-   dstrect.y = (SHIP_TARGET_H - sh) / 2;
-   dstrect.w = rtemp.w;
-   dstrect.h = rtemp.h;
-   SDL_BlitSurface( surface, &rtemp, gfx_store, &dstrect );
-
-   /* Load the store surface. */
-   snprintf( buf, sizeof(buf), "%s_gfx_store", temp->name );
-   temp->gfx_store = gl_loadImagePad( buf, gfx_store, OPENGL_TEX_VFLIP, SHIP_TARGET_W, SHIP_TARGET_H, 1, 1, 1 );
+   /* Copy over for target. */
+   if (target && (temp->gfx_target == NULL)) {
+      /* create the temp POT surface */
+      gfx = SDL_CreateRGBSurface( 0, sw, sh,
+            surface->format->BytesPerPixel*8, RGBAMASK );
+      if (gfx == NULL) {
+         WARN( _("Unable to create ship '%s' targeting surface."), temp->name );
+         return -1;
+      }
+      dstrect.x = 0;
+      dstrect.y = 0;
+      dstrect.w = rtemp.w;
+      dstrect.h = rtemp.h;
+      SDL_BlitSurface( surface, &rtemp, gfx, &dstrect );
+
+      /* Load the surface. */
+      snprintf( buf, sizeof(buf), "%s_gfx_target", temp->name );
+      temp->gfx_target = gl_loadImagePad( buf, gfx, OPENGL_TEX_VFLIP, sw, sh, 1, 1, 1 );
+   }
 
-   /* Load the surface. */
-   snprintf( buf, sizeof(buf), "%s_gfx_target", temp->name );
-   temp->gfx_target = gl_loadImagePad( buf, gfx, OPENGL_TEX_VFLIP, sw, sh, 1, 1, 1 );
+   /* Copy over for store. */
+   if (temp->gfx_store == NULL) {
+      gfx_store = SDL_CreateRGBSurface( 0, SHIP_TARGET_W, SHIP_TARGET_H,
+            surface->format->BytesPerPixel*8, RGBAMASK );
+      if (gfx_store == NULL) {
+         WARN( _("Unable to create ship '%s' store surface."), temp->name );
+         return -1;
+      }
+      dstrect.x = (SHIP_TARGET_W - sw) / 2;
+      dstrect.y = (SHIP_TARGET_H - sh) / 2;
+      dstrect.w = rtemp.w;
+      dstrect.h = rtemp.h;
+      SDL_BlitSurface( surface, &rtemp, gfx_store, &dstrect );
+
+      /* Load the store surface. */
+      snprintf( buf, sizeof(buf), "%s_gfx_store", temp->name );
+      temp->gfx_store = gl_loadImagePad( buf, gfx_store, OPENGL_TEX_VFLIP, SHIP_TARGET_W, SHIP_TARGET_H, 1, 1, 1 );
+      temp->gfx_store_used = SDL_GetTicks();
+   }
 
    return 0;
 }
 
 /**
- * @brief Loads the space graphics for a ship from an image.
+ * @brief Loads the space graphics for a ship from its sprite sheet.
  *
  *    @param temp Ship to load into.
- *    @param str Path of the image to use.
- *    @param sx Number of X sprites in image.
- *    @param sy Number of Y sprites in image.
+ *    @param space Whether to load the space and target graphics or only the store graphic.
  */
-static int ship_loadSpaceImage( Ship *temp, char *str, int sx, int sy )
+static int ship_loadSpaceImage( Ship *temp, int space )
 {
    SDL_RWops *rw;
    SDL_Surface *surface;
    int ret;
 
    /* Load the space sprite. */
-   rw    = PHYSFSRWOPS_openRead( str );
+   rw    = PHYSFSRWOPS_openRead( temp->gfx_path );
    if (rw==NULL) {
-      WARN(_("Unable to open '%s' for reading!"), str);
+      WARN(_("Unable to open '%s' for reading!"), temp->gfx_path);
       return -1;
    }
    surface = IMG_Load_RW( rw, 0 );
+   if (surface==NULL) {
+      WARN(_("Unable to load '%s'!"), temp->gfx_path);
+      SDL_RWclose( rw );
+      return -1;
+   }
 
    /* Load the texture. */
    /* Don't try to be smart here and avoid loading the transparency map or
     * we'll hit issues with collisions. */
-   /*
-   if (temp->polygon != NULL)
-      temp->gfx_space = gl_loadImagePad( str, surface,
-            OPENGL_TEX_MIPMAPS | OPENGL_TEX_VFLIP,
-            surface->w, surface->h, sx, sy, 0 );
-   else
-   */
-      temp->gfx_space = gl_loadImagePadTrans( str, surface, rw,
+   if (space && (temp->gfx_space == NULL))
+      temp->gfx_space = gl_loadImagePadTrans( temp->gfx_path, surface, rw,
             OPENGL_TEX_MAPTRANS | OPENGL_TEX_MIPMAPS | OPENGL_TEX_VFLIP,
-            surface->w, surface->h, sx, sy, 0 );
+            surface->w, surface->h, temp->gfx_sx, temp->gfx_sy, 0 );
 
    /* Create the target graphic. */
-   ret = ship_genTargetGFX( temp, surface, sx, sy );
-   if (ret != 0)
-      return ret;
+   ret = ship_genTargetGFX( temp, surface, temp->gfx_sx, temp->gfx_sy, space );
 
    /* Free stuff. */
    SDL_RWclose( rw );
    SDL_FreeSurface( surface );
 
-   /* Calculate mount angle. */
-   temp->mangle  = 2.*M_PI;
-   temp->mangle /= temp->gfx_space->sx * temp->gfx_space->sy;
-   return 0;
-}
-
-/**
- * @brief Loads the space graphics for a ship from an image.
- *
- *    @param temp Ship to load into.
- *    @param str Path of the image to use.
- *    @param sx Number of X sprites in image.
- *    @param sy Number of Y sprites in image.
- */
-static int ship_loadEngineImage( Ship *temp, char *str, int sx, int sy )
-{
-   temp->gfx_engine = gl_newSprite( str, sx, sy, OPENGL_TEX_MIPMAPS );
-   return (temp->gfx_engine != NULL);
+   return ret;
 }
 
 /**
  * @brief Loads the graphics for a ship.
  *
+ * Only the paths are stored, the textures are loaded by ship_gfxLoad() when a
+ * pilot using the ship is created.
+ *
  *    @param temp Ship to load into.
  *    @param buf Name of the texture to work with.
- *    @param sx Number of X sprites in image.
- *    @param sy Number of Y sprites in image.
  *    @param engine Whether there is also an engine image to load.
  */
-static int ship_loadGFX( Ship *temp, const char *buf, int sx, int sy, int engine )
+static int ship_loadGFX( Ship *temp, const char *buf, int engine )
 {
    char str[PATH_MAX], *ext, *base, *delim;
 
@@ -482,20 +488,24 @@ static int ship_loadGFX( Ship *temp, const char *buf, int sx, int sy, int engine
       temp->gfx_3d = object_loadFromFile(str);
    }
 
-   /* Load the space sprite. */
+   /* Get the space sprite. */
    ext = ".webp";
    snprintf( str, sizeof(str), SHIP_GFX_PATH"%s/%s%s", base, buf, ext );
    if (!PHYSFS_exists(str)) {
       ext = ".png";
       snprintf( str, sizeof(str), SHIP_GFX_PATH"%s/%s%s", base, buf, ext );
    }
-   ship_loadSpaceImage( temp, str, sx, sy );
+   free( temp->gfx_path );
+   temp->gfx_path = strdup( str );
 
-   /* Load the engine sprite .*/
+   /* Get the engine sprite .*/
    if (engine) {
       snprintf( str, sizeof(str), SHIP_GFX_PATH"%s/%s"SHIP_ENGINE"%s", base, buf, ext );
-      ship_loadEngineImage( temp, str, sx, sy );
-      if (temp->gfx_engine == NULL)
+      if (PHYSFS_exists(str)) {
+         free( temp->gfx_engine_path );
+         temp->gfx_engine_path = strdup( str );
+      }
+      else
          WARN(_("Ship '%s' does not have an engine sprite (%s)."), temp->name, str );
    }
 
@@ -506,6 +516,70 @@ static int ship_loadGFX( Ship *temp, const char *buf, int sx, int sy, int engine
    return 0;
 }
 
+/**
+ * @brief Loads the space, engine and target graphics of a ship if necessary.
+ *
+ * Ship graphics are loaded on demand, and this must be called before using
+ * any of them. Once loaded they are kept until the ships are freed, as pilots
+ * use them directly.
+ *
+ *    @param s Ship to load graphics of.
+ *    @return 0 on success.
+ */
+int ship_gfxLoad( const Ship *s )
+{
+   Ship *temp = (Ship*) s;
+   int ret = 0;
+
+   if (temp->gfx_space != NULL)
+      return 0;
+   if (temp->gfx_path == NULL)
+      return -1;
+
+   ret = ship_loadSpaceImage( temp, 1 );
+   if ((temp->gfx_engine_path != NULL) && (temp->gfx_engine == NULL)) {
+      temp->gfx_engine = gl_newSprite( temp->gfx_engine_path,
+            temp->gfx_sx, temp->gfx_sy, OPENGL_TEX_MIPMAPS );
+      if (temp->gfx_engine == NULL)
+         WARN(_("Ship '%s' failed to load engine sprite (%s)."), temp->name, temp->gfx_engine_path );
+   }
+   return ret;
+}
+
+/**
+ * @brief Gets the store graphic of a ship, loading it if necessary.
+ *
+ *    @param s Ship to get store graphic of.
+ *    @return The store graphic of the ship (not duplicated).
+ */
+glTexture* ship_gfxStore( const Ship *s )
+{
+   Ship *temp = (Ship*) s;
+   if ((temp->gfx_store == NULL) && (temp->gfx_path != NULL))
+      ship_loadSpaceImage( temp, 0 );
+   temp->gfx_store_used = SDL_GetTicks();
+   return temp->gfx_store;
+}
+
+/**
+ * @brief Frees the store graphics that have not been used for a while.
+ *
+ * Anything still holding a duplicate of the texture keeps it alive.
+ */
+void ship_gfxStoreEvict (void)
+{
+   Uint32 t = SDL_GetTicks();
+   for (int i=0; i<array_size(ship_stack); i++) {
+      Ship *s = &ship_stack[i];
+      if (s->gfx_store == NULL)
+         continue;
+      if (t - s->gfx_store_used < SHIP_GFX_STORE_TIMEOUT)
+         continue;
+      gl_freeTexture( s->gfx_store );
+      s->gfx_store = NULL;
+   }
+}
+
 /**
  * @brief Loads the collision polygon for a ship.
  *
@@ -728,7 +802,9 @@ static int ship_parse( Ship *temp, const char *filename )
          ship_loadPLG( temp, buf, sx*sy );
 
          /* Load the graphics. */
-         ship_loadGFX( temp, buf, sx, sy, !noengine );
+         temp->gfx_sx = sx;
+         temp->gfx_sy = sy;
+         ship_loadGFX( temp, buf, !noengine );
 
          /* Validity check: there must be 1 polygon per sprite. */
          if ((temp->polygon != NULL) && array_size(temp->polygon) != sx*sy) {
@@ -753,8 +829,11 @@ static int ship_parse( Ship *temp, const char *filename )
          xmlr_attr_int_def( node, "sx", sx, 8 );
          xmlr_attr_int_def( node, "sy", sy, 8 );
 
-         /* Load the graphics. */
-         ship_loadSpaceImage( temp, str, sx, sy );
+         /* Graphics are loaded on demand. */
+         temp->gfx_sx = sx;
+         temp->gfx_sy = sy;
+         free( temp->gfx_path );
+         temp->gfx_path = strdup( str );
 
          continue;
       }
@@ -768,12 +847,10 @@ static int ship_parse( Ship *temp, const char *filename )
          }
          snprintf( str, sizeof(str), GFX_PATH"%s", buf );
 
-         /* Get sprite size. */
-         xmlr_attr_int_def( node, "sx", sx, 8 );
-         xmlr_attr_int_def( node, "sy", sy, 8 );
-
-         /* Load the graphics. */
-         ship_loadEngineImage( temp, str, sx, sy );
+         /* Graphics are loaded on demand, the engine shares the sprite
+          * layout of the space graphics. */
+         free( temp->gfx_engine_path );
+         temp->gfx_engine_path = strdup( str );
 
          continue;
       }
@@ -986,6 +1063,10 @@ static int ship_parse( Ship *temp, const char *filename )
    temp->dmg_absorb   /= 100.;
    temp->turn         *= M_PI / 180.; /* Convert to rad. */
 
+   /* Calculate mount angle. */
+   if (temp->gfx_sx*temp->gfx_sy > 0)
+      temp->mangle = 2.*M_PI / (temp->gfx_sx*temp->gfx_sy);
+
    /* Check license. */
    if (temp->license && !outfit_licenseExists(temp->license))
       WARN(_("Ship '%s' has inexistent license requirement '%s'!"), temp->name, temp->license);
@@ -994,7 +1075,7 @@ static int ship_parse( Ship *temp, const char *filename )
 #define MELEMENT(o,s)      if (o) WARN( _("Ship '%s' missing '%s' element"), temp->name, s)
    MELEMENT(temp->name==NULL,"name");
    MELEMENT(temp->base_type==NULL,"base_type");
-   MELEMENT((temp->gfx_space==NULL) || (temp->gfx_comm==NULL),"GFX");
+   MELEMENT((temp->gfx_path==NULL) || (temp->gfx_comm==NULL),"GFX");
    MELEMENT(temp->gui==NULL,"GUI");
    MELEMENT(temp->class==SHIP_CLASS_NULL,"class");
    MELEMENT(temp->points==0,"points");
@@ -1063,6 +1144,8 @@ int ships_load (void)
       free( ship_files[i] );
    }
    qsort( ship_stack, array_size(ship_stack), sizeof(Ship), ship_cmp );
+   for (int i=0; i<array_size(ship_stack); i++)
+      intern_mapSet( &ship_idmap, ship_stack[i].name, i );
 
    /* Shrink stack. */
    array_shrink(&ship_stack);
@@ -1160,16 +1243,16 @@ void ships_free (void)
       gl_freeTexture(s->gfx_engine);
       gl_freeTexture(s->gfx_target);
       gl_freeTexture(s->gfx_store);
+      free(s->gfx_path);
+      free(s->gfx_engine_path);
       free(s->gfx_comm);
       for (int j=0; j<array_size(s->gfx_overlays); j++)
          gl_freeTexture(s->gfx_overlays[j]);
       array_free(s->gfx_overlays);
 
       /* Free collision polygons. */
-      for (int j=0; j<array_size(s->polygon); j++) {
-         free(s->polygon[j].x);
-         free(s->polygon[j].y);
-      }
+      for (int j=0; j<array_size(s->polygon); j++)
+         FreePolygon( &s->polygon[j] );
 
       array_free(s->trail_emitters);
       array_free(s->polygon);
@@ -1187,6 +1270,8 @@ void ships_free (void)
 
    array_free(ship_stack);
    ship_stack = NULL;
+   array_free(ship_idmap);
+   ship_idmap = NULL;
 }
 
 static void ship_freeSlot( ShipOutfitSlot* s )
@@ -134,10 +134,15 @@ typedef struct Ship_ {
    /* Graphics */
    Object *gfx_3d;         /**< 3d model of the ship */
    double gfx_3d_scale;    /**< scale for 3d model of the ship */
-   glTexture *gfx_space;   /**< Space sprite sheet. */
-   glTexture *gfx_engine;  /**< Space engine glow sprite sheet. */
-   glTexture *gfx_target;  /**< Targeting window graphic. */
-   glTexture *gfx_store;   /**< Store graphic. */
+   char *gfx_path;         /**< Path of the space sprite sheet. */
+   char *gfx_engine_path;  /**< Path of the engine glow sprite sheet, NULL if none. */
+   int gfx_sx;             /**< Number of X sprites in the sprite sheets. */
+   int gfx_sy;             /**< Number of Y sprites in the sprite sheets. */
+   glTexture *gfx_space;   /**< Space sprite sheet, loaded by ship_gfxLoad(). */
+   glTexture *gfx_engine;  /**< Space engine glow sprite sheet, loaded by ship_gfxLoad(). */
+   glTexture *gfx_target;  /**< Targeting window graphic, loaded by ship_gfxLoad(). */
+   glTexture *gfx_store;   /**< Store graphic, use ship_gfxStore() to access. */
+   Uint32 gfx_store_used;  /**< Last time the store graphic was used in ticks. */
    char* gfx_comm;         /**< Name of graphic for communication. */
    glTexture **gfx_overlays; /**< Array (array.h): Store overlay graphics. */
    ShipTrailEmitter *trail_emitters; /**< Trail emitters. */
@@ -198,6 +203,9 @@ ShipClass ship_classFromString( const char* str );
 credits_t ship_basePrice( const Ship* s );
 credits_t ship_buyPrice( const Ship* s );
 glTexture* ship_loadCommGFX( const Ship* s );
+int ship_gfxLoad( const Ship *s );
+glTexture* ship_gfxStore( const Ship *s );
+void ship_gfxStoreEvict (void);
 int ship_size( const Ship *s );
 
 /*
@@ -51,6 +51,7 @@
 #include "log.h"
 #include "music.h"
 #include "ndata.h"
+#include "nmemory.h"
 #include "nstring.h"
 #include "physics.h"
 #include "player.h"
@@ -159,6 +160,9 @@ static double snd_compression_gain = 0.; /**< Current compression gain. */
 /* General. */
 static int sound_makeList (void);
 static void sound_free( alSound *snd );
+#if DEBUG_ALLOC
+static long sound_bufSize( ALuint buf );
+#endif /* DEBUG_ALLOC */
 /* Voices. */
 
 /*
@@ -1321,6 +1325,7 @@ static void sound_free( alSound *snd )
    /* Free general stuff. */
    free(snd->name);
    free(snd->filename);
+   nmem_count( MEM_SOUND, -sound_bufSize( snd->buf ) );
 
    /* Free internals. */
    soundLock();
@@ -1791,6 +1796,20 @@ alVoice* voice_get( int id )
    return v;
 }
 
+#if DEBUG_ALLOC
+/**
+ * @brief Gets the size of the data in a buffer.
+ */
+static long sound_bufSize( ALuint buf )
+{
+   ALint size = 0;
+   soundLock();
+   alGetBufferi( buf, AL_SIZE, &size );
+   soundUnlock();
+   return size;
+}
+#endif /* DEBUG_ALLOC */
+
 /**
  * @brief Loads a new sound source from a RWops.
  */
@@ -1811,6 +1830,7 @@ int source_newRW( SDL_RWops *rw, const char *name, unsigned int flags )
    sndl = &array_grow( &sound_list );
    memcpy( sndl, &snd, sizeof(alSound) );
    sndl->name = strdup( name );
+   nmem_count( MEM_SOUND, sound_bufSize( sndl->buf ) );
 
    return sndl-sound_list;
 }
@@ -25,6 +25,7 @@
 #include "gatherable.h"
 #include "gui.h"
 #include "hook.h"
+#include "intern.h"
 #include "land.h"
 #include "log.h"
 #include "map.h"
@@ -72,13 +73,19 @@
 
 #define DEBRIS_BUFFER         1000 /**< Buffer to smooth appearance of debris */
 
+#define SPOB_LUA_EXTRA        8 /**< Spob Lua environments kept for scripts used by a single spob. */
+
 typedef struct spob_lua_file_s {
    const char *filename;   /**< Name of the spob Lua file. */
    nlua_env env;           /**< Lua environment. */
    int lua_mem;            /**< Global memory. */
+   unsigned int used;      /**< When it was last needed, to evict the oldest. */
 } spob_lua_file;
 
 static spob_lua_file *spob_lua_stack = NULL; /**< Handles spob Lua chunks. */
+static unsigned int spob_lua_used = 0; /**< Counter to order the spob Lua chunks by use. */
+static int spob_lua_max = SPOB_LUA_EXTRA; /**< Spob Lua environments kept loaded, sized from the data. */
+static int spob_lua_hold = 0; /**< Spob Lua environments are not evicted while positive. */
 
 /*
  * spob <-> system name stack
@@ -96,6 +103,23 @@ static VirtualSpob *vspob_stack = NULL; /**< Virtual spob stack. */
 static int systemstack_changed = 0; /**< Whether or not the systems_stack was changed after loading. */
 static int spobstack_changed = 0; /**< Whether or not the spob_stack was changed after loading. */
 #endif /* DEBUGGING */
+static int *system_idmap = NULL; /**< Array (array.h): Maps interned system names to systems_stack indices. */
+static int *spob_idmap = NULL; /**< Array (array.h): Maps interned spob names to spob_stack indices. */
+static const uint8_t *presence_mask = NULL; /**< When set, only systems with a non-zero entry get presence added. */
+
+/*
+ * Spatial index over system positions, a uniform grid stored as cell offsets
+ * into a single array of system ids.
+ */
+static int sysgrid_dirty   = 1; /**< Whether the grid needs to be rebuilt. */
+static int sysgrid_w       = 0; /**< Grid width in cells. */
+static int sysgrid_h       = 0; /**< Grid height in cells. */
+static double sysgrid_x    = 0.; /**< Left edge of the grid. */
+static double sysgrid_y    = 0.; /**< Bottom edge of the grid. */
+static double sysgrid_cell = 1.; /**< Size of a grid cell. */
+static int *sysgrid_start  = NULL; /**< Offset of each cell in sysgrid_ids (w*h+1 entries). */
+static int *sysgrid_ids    = NULL; /**< System ids sorted by cell. */
+static int *sysgrid_query  = NULL; /**< Array (array.h): Reused buffer for space_sysClosest(). */
 static MapShader **mapshaders = NULL; /**< Map shaders. */
 
 /*
@@ -133,6 +157,8 @@ static int system_parseAsteroidField( const xmlNodePtr node, StarSystem *sys );
 static int system_parseAsteroidExclusion( const xmlNodePtr node, StarSystem *sys );
 /* misc */
 static int spob_cmp( const void *p1, const void *p2 );
+static void space_sysGridBuild (void);
+static void space_sysGridCell( double x, double y, int *cx, int *cy );
 static int getPresenceIndex( StarSystem *sys, int faction );
 static void system_scheduler( double dt, int init );
 /* Markers. */
@@ -150,6 +176,8 @@ static const MapShader *mapshader_get( const char *name );
 static int spob_lua_cmp( const void *a, const void *b );
 static nlua_env spob_lua_get( int *mem, const char *filename );
 static void spob_lua_free( spob_lua_file *lf );
+static int spob_lua_evict (void);
+static void spob_luaClear( Spob *spob );
 /*
  * Externed prototypes.
  */
@@ -439,12 +467,11 @@ int spob_rename( Spob *p, char *newname )
    }
    if (!found)
       WARN(_("Renaming spob '%s', but not found in name stack!"),p->name);
+   intern_mapUnset( spob_idmap, p->name );
+   intern_mapSet( &spob_idmap, newname, p->id );
    free( p->name );
    p->name = newname;
 
-   /* Order changed, so no more bsearch for us. */
-   spobstack_changed = 1;
-
    return 0;
 }
 
@@ -589,6 +616,7 @@ int space_calcJumpInPos( const StarSystem *in, const StarSystem *out, vec2 *pos,
 char** space_getFactionSpob( int *factions, int landable )
 {
    char **tmp = array_create( char* );
+   spob_luaHold();
    for (int i=0; i<array_size(systems_stack); i++) {
       for (int j=0; j<array_size(systems_stack[i].spobs); j++) {
          Spob *spob = systems_stack[i].spobs[j];
@@ -617,6 +645,7 @@ char** space_getFactionSpob( int *factions, int landable )
          break; /* no need to check all factions */
       }
    }
+   spob_luaRelease();
 
    return tmp;
 }
@@ -651,6 +680,7 @@ const char* space_getRndSpob( int landable, unsigned int services,
 
    /* Second filter. */
    arrayShuffle( (void**)tmp );
+   spob_luaHold();
    for (int i=0; i < array_size(tmp); i++) {
       Spob *pnt = tmp[i];
 
@@ -667,6 +697,7 @@ const char* space_getRndSpob( int landable, unsigned int services,
       res = tmp[i]->name;
       break;
    }
+   spob_luaRelease();
    array_free(tmp);
 
    return res;
@@ -872,6 +903,151 @@ int space_sysReachableFromSys( const StarSystem *target, const StarSystem *sys )
    return 0;
 }
 
+/**
+ * @brief Marks the system spatial index as needing a rebuild.
+ *
+ * Must be called whenever systems are added or moved.
+ */
+void space_sysGridDirty (void)
+{
+   sysgrid_dirty = 1;
+}
+
+/**
+ * @brief Gets the (clamped) grid cell of a position.
+ */
+static void space_sysGridCell( double x, double y, int *cx, int *cy )
+{
+   *cx = CLAMP( 0, sysgrid_w-1, (int)floor( (x-sysgrid_x) / sysgrid_cell ) );
+   *cy = CLAMP( 0, sysgrid_h-1, (int)floor( (y-sysgrid_y) / sysgrid_cell ) );
+}
+
+/**
+ * @brief Rebuilds the system spatial index.
+ */
+static void space_sysGridBuild (void)
+{
+   int n = array_size(systems_stack);
+   double xmin, xmax, ymin, ymax;
+   int *fill;
+
+   sysgrid_dirty = 0;
+   free( sysgrid_start );
+   free( sysgrid_ids );
+   sysgrid_start = NULL;
+   sysgrid_ids   = NULL;
+   sysgrid_w = sysgrid_h = 0;
+   if (n <= 0)
+      return;
+
+   /* Bounds. */
+   xmin = xmax = systems_stack[0].pos.x;
+   ymin = ymax = systems_stack[0].pos.y;
+   for (int i=1; i<n; i++) {
+      const vec2 *p = &systems_stack[i].pos;
+      xmin = MIN( xmin, p->x );
+      xmax = MAX( xmax, p->x );
+      ymin = MIN( ymin, p->y );
+      ymax = MAX( ymax, p->y );
+   }
+
+   /* Aim for a couple of systems per cell. */
+   sysgrid_cell = MAX( 1., sqrt( 2. * (xmax-xmin+1.) * (ymax-ymin+1.) / (double)n ) );
+   sysgrid_x = xmin;
+   sysgrid_y = ymin;
+   sysgrid_w = (int)floor( (xmax-xmin) / sysgrid_cell ) + 1;
+   sysgrid_h = (int)floor( (ymax-ymin) / sysgrid_cell ) + 1;
+
+   /* Counting sort of the systems into cells. */
+   sysgrid_start = calloc( sysgrid_w*sysgrid_h+1, sizeof(int) );
+   sysgrid_ids   = malloc( n * sizeof(int) );
+   for (int i=0; i<n; i++) {
+      int cx, cy;
+      space_sysGridCell( systems_stack[i].pos.x, systems_stack[i].pos.y, &cx, &cy );
+      sysgrid_start[ cy*sysgrid_w+cx+1 ]++;
+   }
+   for (int i=0; i<sysgrid_w*sysgrid_h; i++)
+      sysgrid_start[i+1] += sysgrid_start[i];
+   fill = malloc( sysgrid_w*sysgrid_h * sizeof(int) );
+   memcpy( fill, sysgrid_start, sysgrid_w*sysgrid_h * sizeof(int) );
+   for (int i=0; i<n; i++) {
+      int cx, cy;
+      space_sysGridCell( systems_stack[i].pos.x, systems_stack[i].pos.y, &cx, &cy );
+      sysgrid_ids[ fill[cy*sysgrid_w+cx]++ ] = i;
+   }
+   free( fill );
+}
+
+/**
+ * @brief Gets the systems inside a rectangle.
+ *
+ *    @param[in, out] ids Array (array.h) to fill with system ids, created if NULL.
+ *    @param x1 Left edge.
+ *    @param y1 Bottom edge.
+ *    @param x2 Right edge.
+ *    @param y2 Top edge.
+ *    @return The ids array.
+ */
+int *space_sysInRect( int *ids, double x1, double y1, double x2, double y2 )
+{
+   int cx1, cy1, cx2, cy2;
+
+   if (ids == NULL)
+      ids = array_create( int );
+   else
+      array_resize( &ids, 0 );
+
+   if (sysgrid_dirty)
+      space_sysGridBuild();
+   if ((sysgrid_w <= 0) || (x2 < x1) || (y2 < y1))
+      return ids;
+
+   space_sysGridCell( x1, y1, &cx1, &cy1 );
+   space_sysGridCell( x2, y2, &cx2, &cy2 );
+   for (int cy=cy1; cy<=cy2; cy++) {
+      for (int cx=cx1; cx<=cx2; cx++) {
+         int c = cy*sysgrid_w+cx;
+         for (int k=sysgrid_start[c]; k<sysgrid_start[c+1]; k++) {
+            const vec2 *p = &systems_stack[ sysgrid_ids[k] ].pos;
+            if ((p->x >= x1) && (p->x <= x2) && (p->y >= y1) && (p->y <= y2))
+               array_push_back( &ids, sysgrid_ids[k] );
+         }
+      }
+   }
+   return ids;
+}
+
+/**
+ * @brief Gets the closest system to a position.
+ *
+ *    @param x X position.
+ *    @param y Y position.
+ *    @param r Maximum distance to the system.
+ *    @param filter Only systems for which it returns non-zero are considered (NULL for all).
+ *    @return The closest system within r or NULL if there is none.
+ */
+StarSystem *space_sysClosest( double x, double y, double r, int (*filter)( const StarSystem *sys ) )
+{
+   StarSystem *best = NULL;
+   double dbest = pow2(r);
+
+   sysgrid_query = space_sysInRect( sysgrid_query, x-r, y-r, x+r, y+r );
+   for (int i=0; i<array_size(sysgrid_query); i++) {
+      StarSystem *sys = &systems_stack[ sysgrid_query[i] ];
+      double d = pow2(sys->pos.x-x) + pow2(sys->pos.y-y);
+      if (d > dbest)
+         continue;
+      /* Ties go to the first system in the stack as before. */
+      if ((d == dbest) && (best != NULL) && (best->id < sys->id))
+         continue;
+      if ((filter != NULL) && !filter( sys ))
+         continue;
+      best  = sys;
+      dbest = d;
+   }
+   return best;
+}
+
 /**
  * @brief Gets an array (array.h) of all star systems.
  */
@@ -957,10 +1133,9 @@ StarSystem* system_get( const char* sysname )
    }
 #endif /* DEBUGGING */
 
-   const StarSystem s = {.name = (char*)sysname};
-   StarSystem *found = bsearch( &s, systems_stack, array_size(systems_stack), sizeof(StarSystem), system_cmp );
-   if (found != NULL)
-      return found;
+   int id = intern_mapGet( system_idmap, sysname );
+   if (id >= 0)
+      return &systems_stack[id];
 
    WARN(_("System '%s' not found in stack"), sysname);
    return NULL;
@@ -996,8 +1171,9 @@ int system_index( const StarSystem *sys )
  */
 int spob_hasSystem( const Spob *spb )
 {
+   /* The name stack holds the spobs' own name pointers. */
    for (int i=0; i<array_size(spobname_stack); i++)
-      if (strcmp(spobname_stack[i],spb->name)==0)
+      if (spobname_stack[i]==spb->name)
          return 1;
    return 0;
 }
@@ -1010,8 +1186,13 @@ int spob_hasSystem( const Spob *spb )
  */
 const char* spob_getSystem( const char* spobname )
 {
+   /* Pointer comparisons are enough once the spob is known, spobs created in
+    * the editor are not in the map so fall back to comparing strings. */
+   int id = intern_mapGet( spob_idmap, spobname );
+   const char *name = (id >= 0) ? spob_stack[id].name : NULL;
    for (int i=0; i<array_size(spobname_stack); i++)
-      if (strcmp(spobname_stack[i],spobname)==0)
+      if ((spobname_stack[i]==name) ||
+            ((name==NULL) && (strcmp(spobname_stack[i],spobname)==0)))
          return systemname_stack[i];
    DEBUG(_("Spob '%s' is not placed in a system"), spobname);
    return NULL;
@@ -1051,10 +1232,9 @@ Spob* spob_get( const char* spobname )
    }
 #endif /* DEBUGGING */
 
-   const Spob p = {.name = (char*)spobname};
-   Spob *found = bsearch( &p, spob_stack, array_size(spob_stack), sizeof(Spob), spob_cmp );
-   if (found != NULL)
-      return found;
+   int id = intern_mapGet( spob_idmap, spobname );
+   if (id >= 0)
+      return &spob_stack[id];
 
    WARN(_("Spob '%s' not found in the universe"), spobname);
    return NULL;
@@ -1776,8 +1956,10 @@ static int spobs_load (void)
       free( spob_files[i] );
    }
    qsort( spob_stack, array_size(spob_stack), sizeof(Spob), spob_cmp );
-   for (int j=0; j<array_size(spob_stack); j++)
+   for (int j=0; j<array_size(spob_stack); j++) {
       spob_stack[j].id = j;
+      intern_mapSet( &spob_idmap, spob_stack[j].name, j );
+   }
 
    /* Clean up. */
    array_free( spob_files );
@@ -1926,6 +2108,9 @@ const glColour* spob_getColour( const Spob *p )
  */
 void spob_updateLand( Spob *p )
 {
+   /* Make sure the Lua is there. */
+   spob_luaLoad( p );
+
    /* Clean up old stuff. */
    free( p->land_msg );
    p->can_land    = 0;
@@ -1966,15 +2151,14 @@ void spob_luaInitMem( const Spob *spob )
 }
 
 /**
- * @brief Updatse the spob's internal Lua stuff.
+ * @brief Clears the references a spob has to its Lua environment.
  *
- *    @param spob Spob to update.
+ * The memory of the spob is kept.
+ *
+ *    @param spob Spob to clear.
  */
-int spob_luaInit( Spob *spob )
+static void spob_luaClear( Spob *spob )
 {
-   int mem;
-
-   /* Just clear everything. */
 #define UNREF( x ) \
    do { if ((x) != LUA_NOREF) { \
       luaL_unref( naevL, LUA_REGISTRYINDEX, (x) ); \
@@ -1989,17 +2173,53 @@ int spob_luaInit( Spob *spob )
    UNREF( spob->lua_render );
    UNREF( spob->lua_update );
    UNREF( spob->lua_comm );
-   UNREF( spob->lua_mem );
 #undef UNREF
+}
+
+/**
+ * @brief Updatse the spob's internal Lua stuff.
+ *
+ * Only clears everything, the Lua gets loaded by spob_luaLoad() when needed.
+ *
+ *    @param spob Spob to update.
+ */
+int spob_luaInit( Spob *spob )
+{
+   spob_luaClear( spob );
+   if (spob->lua_mem != LUA_NOREF) {
+      luaL_unref( naevL, LUA_REGISTRYINDEX, spob->lua_mem );
+      spob->lua_mem = LUA_NOREF;
+   }
+   spob_rmFlag( spob, SPOB_LUAFAIL );
+   return 0;
+}
+
+/**
+ * @brief Loads the spob's Lua if it isn't loaded yet.
+ *
+ * Spobs get loaded when their system is entered or their Lua is first
+ * needed. Environments may get evicted afterwards, but the memory of the spob
+ * is kept so init is only run once.
+ *
+ *    @param spob Spob to load Lua of.
+ *    @return 0 on success.
+ */
+int spob_luaLoad( Spob *spob )
+{
+   int mem;
+   nlua_env env;
 
-   /* Initialize. */
-   if (spob->lua_file == NULL)
+   /* Nothing to do. */
+   if ((spob->lua_file == NULL) || (spob->lua_env != LUA_NOREF) ||
+         spob_isFlag( spob, SPOB_LUAFAIL ))
       return 0;
 
    /* Try to get the environment, will create a new one as necessary. */
-   nlua_env env = spob_lua_get( &mem, spob->lua_file );
-   if (env==LUA_NOREF)
+   env = spob_lua_get( &mem, spob->lua_file );
+   if (env==LUA_NOREF) {
+      spob_setFlag( spob, SPOB_LUAFAIL );
       return -1;
+   }
 
    spob->lua_env = env;
 
@@ -2013,6 +2233,10 @@ int spob_luaInit( Spob *spob )
    spob->lua_update   = nlua_refenvtype( env, "update",   LUA_TFUNCTION );
    spob->lua_comm     = nlua_refenvtype( env, "comm",     LUA_TFUNCTION );
 
+   /* Already initialized before the environment got evicted. */
+   if (spob->lua_mem != LUA_NOREF)
+      return 0;
+
    /* Set up local memory. */
    lua_newtable( naevL );        /* m */
    lua_pushvalue( naevL, -1 );   /* m, m */
@@ -2049,6 +2273,7 @@ int spob_luaInit( Spob *spob )
  */
 void spob_gfxLoad( Spob *spob )
 {
+   spob_luaLoad( spob );
    if (spob->lua_load != LUA_NOREF) {
       spob_luaInitMem( spob );
       lua_rawgeti(naevL, LUA_REGISTRYINDEX, spob->lua_load); /* f */
@@ -2174,6 +2399,7 @@ static int spob_parse( Spob *spob, const char *filename, Commodity **stdList )
    comms             = array_create( Commodity* );
    /* Lua stuff. */
    spob->lua_env     = LUA_NOREF;
+   spob->lua_mem     = LUA_NOREF;
    spob->lua_init    = LUA_NOREF;
    spob->lua_load    = LUA_NOREF;
    spob->lua_unload  = LUA_NOREF;
@@ -2424,7 +2650,7 @@ int system_addSpob( StarSystem *sys, const char *spobname )
    economy_clearSingleSpob(spob);
 
    /* Reload graphics if necessary. */
-   if (cur_system != NULL)
+   if (sys == cur_system)
       space_gfxLoad( cur_system );
 
    /* Initialize economy if applicable. */
@@ -2468,7 +2694,7 @@ int system_rmSpob( StarSystem *sys, const char *spobname )
    array_erase( &sys->spobsid, &sys->spobsid[i], &sys->spobsid[i+1] );
 
    /* Remove the presence. */
-   space_reconstructPresences(); /* TODO defer this if removing multiple spobs at once. */
+   space_reconstructPresencesAround( &sys->id, 1 );
 
    /* Remove from the name stack thingy. */
    found = 0;
@@ -2544,7 +2770,7 @@ int system_rmVirtualSpob( StarSystem *sys, const char *spobname )
    array_erase( &sys->spobs_virtual, &sys->spobs_virtual[i], &sys->spobs_virtual[i+1] );
 
    /* Remove the presence. */
-   space_reconstructPresences(); /* TODO defer this if removing multiple spobs at once. */
+   space_reconstructPresencesAround( &sys->id, 1 );
    system_setFaction(sys);
 
    economy_addQueuedUpdate();
@@ -2663,6 +2889,7 @@ StarSystem *system_new (void)
    /* Reconstruct the jumps, only truely necessary if the systems realloced. */
    if (!systems_loading)
       systems_reconstructJumps();
+   space_sysGridDirty();
 
    return sys;
 }
@@ -3341,15 +3568,64 @@ int space_load (void)
 
 /**
  * @brief initializes the Lua for all the spobs.
+ *
+ * The environments are only created once the spobs need them. How many are
+ * kept loaded is sized so that all the scripts shared by several spobs, like
+ * the landing services, fit with some room for those used by a single spob.
  */
 int space_loadLua (void)
 {
    int ret = 0;
-   for (int i=0; i<array_size(spob_stack); i++)
+   const char **files = array_create_size( const char*, array_size(spob_stack) );
+   for (int i=0; i<array_size(spob_stack); i++) {
       ret |= spob_luaInit( &spob_stack[i] );
+      if (spob_stack[i].lua_file != NULL)
+         array_push_back( &files, spob_stack[i].lua_file );
+   }
+
+   /* Count the scripts used by more than one spob. */
+   qsort( files, array_size(files), sizeof(const char*), strsort );
+   spob_lua_max = SPOB_LUA_EXTRA;
+   for (int i=1; i<array_size(files); i++)
+      if ((strcmp( files[i], files[i-1] )==0) &&
+            ((i < 2) || (strcmp( files[i-1], files[i-2] )!=0)))
+         spob_lua_max++;
+   array_free( files );
+   DEBUG(_("Keeping up to %d spob Lua environments loaded"), spob_lua_max);
    return ret;
 }
 
+/**
+ * @brief Stops spob Lua environments from being evicted.
+ *
+ * Used around code that goes over the spobs of the whole universe, so the
+ * environments needed again a few spobs later are not freed and reloaded.
+ * Calls can be nested and must be matched by spob_luaRelease().
+ */
+void spob_luaHold (void)
+{
+   spob_lua_hold++;
+}
+
+/**
+ * @brief Allows spob Lua environments to be evicted again.
+ *
+ * Once nothing holds them anymore, the environments loaded in the meantime
+ * are evicted down to the limit.
+ */
+void spob_luaRelease (void)
+{
+   if (spob_lua_hold <= 0) {
+      WARN(_("Spob Lua released more times than held!"));
+      return;
+   }
+   if (--spob_lua_hold > 0)
+      return;
+   while (array_size(spob_lua_stack) > spob_lua_max)
+      if (spob_lua_evict())
+         break;
+}
+
 /**
  * @brief Loads the entire systems, needs to be called after spobs_load.
  *
@@ -3398,7 +3674,9 @@ static int systems_load (void)
    for (int j=0; j<array_size(systems_stack); j++) {
       systems_stack[j].id = j;
       systems_stack[j].note = NULL; /* just to be sure */
+      intern_mapSet( &system_idmap, systems_stack[j].name, j );
    }
+   space_sysGridDirty();
 
    /*
     * Second pass - loads all the jump routes.
@@ -3565,6 +3843,17 @@ void space_exit (void)
    /* Free the names. */
    array_free(spobname_stack);
    array_free(systemname_stack);
+   array_free(system_idmap);
+   system_idmap = NULL;
+   array_free(spob_idmap);
+   spob_idmap = NULL;
+   free(sysgrid_start);
+   sysgrid_start = NULL;
+   free(sysgrid_ids);
+   sysgrid_ids = NULL;
+   array_free(sysgrid_query);
+   sysgrid_query = NULL;
+   sysgrid_dirty = 1;
 
    /* Free the spobs. */
    for (int i=0; i < array_size(spob_stack); i++) {
@@ -4076,15 +4365,17 @@ void system_presenceAddSpob( StarSystem *sys, const SpobPresence *ap )
    fgens = faction_generators( faction );
 
    /* Add the presence to the current system. */
-   id = getPresenceIndex(sys, faction);
-   sys->presence[id].base   = MAX( sys->presence[id].base, base );
-   sys->presence[id].bonus += bonus;
-   sys->presence[id].value  = sys->presence[id].base + sys->presence[id].bonus;
-   for (int i=0; i<array_size(fgens); i++) {
-      int x = getPresenceIndex(sys, fgens[i].id);
-      sys->presence[x].base   = MAX( sys->presence[x].base, MAX(0., base*fgens[i].weight) );
-      sys->presence[x].bonus += MAX(0., bonus*fgens[i].weight);
-      sys->presence[x].value  = sys->presence[x].base + sys->presence[x].bonus;
+   if ((presence_mask == NULL) || presence_mask[sys->id]) {
+      id = getPresenceIndex(sys, faction);
+      sys->presence[id].base   = MAX( sys->presence[id].base, base );
+      sys->presence[id].bonus += bonus;
+      sys->presence[id].value  = sys->presence[id].base + sys->presence[id].bonus;
+      for (int i=0; i<array_size(fgens); i++) {
+         int x = getPresenceIndex(sys, fgens[i].id);
+         sys->presence[x].base   = MAX( sys->presence[x].base, MAX(0., base*fgens[i].weight) );
+         sys->presence[x].bonus += MAX(0., bonus*fgens[i].weight);
+         sys->presence[x].value  = sys->presence[x].base + sys->presence[x].bonus;
+      }
    }
 
    /* If there's no range, we're done here. */
@@ -4133,6 +4424,10 @@ void system_presenceAddSpob( StarSystem *sys, const SpobPresence *ap )
          }
       }
 
+      /* Only systems being reconstructed get presence. */
+      if ((presence_mask != NULL) && !presence_mask[cur->id])
+         goto spill_next;
+
       /* Spill some presence. */
       x = getPresenceIndex(cur, faction);
       spillfactor = 1. / (2. + (double)curSpill);
@@ -4147,6 +4442,7 @@ void system_presenceAddSpob( StarSystem *sys, const SpobPresence *ap )
          cur->presence[y].value  = cur->presence[y].base + cur->presence[y].bonus;
       }
 
+spill_next:
       /* Check to see if we've finished this range and grab the next queue. */
       if (q_isEmpty(q)) {
          curSpill++;
@@ -4281,6 +4577,104 @@ void space_reconstructPresences( void )
       system_scheduler( 0., 1 );
 }
 
+/**
+ * @brief Marks all the systems within a number of jumps of the marked systems.
+ *
+ *    @param mark Marks to expand, indexed by system id.
+ *    @param range Number of jumps to expand.
+ *    @param reverse Whether to follow jumps backwards (towards the systems that reach the marked ones).
+ */
+static void space_markAround( uint8_t *mark, int range, int reverse )
+{
+   int n = array_size(systems_stack);
+   uint8_t *next = malloc( n );
+   for (int r=0; r<range; r++) {
+      memcpy( next, mark, n );
+      for (int i=0; i<n; i++) {
+         const StarSystem *sys = &systems_stack[i];
+         for (int j=0; j<array_size(sys->jumps); j++) {
+            int t = sys->jumps[j].targetid;
+            if (reverse) {
+               if (mark[t])
+                  next[i] = 1;
+            }
+            else if (mark[i])
+               next[t] = 1;
+         }
+      }
+      memcpy( mark, next, n );
+   }
+   free( next );
+}
+
+/**
+ * @brief Reconstructs the presences of only the systems that can be affected
+ *        by changes in some systems.
+ *
+ * Presence spills at most the largest spob range in jumps, so only the
+ * systems that close to the changed ones have to be reset, and only spobs
+ * that close to those have to be added again.
+ *
+ *    @param sysids IDs of the systems that changed.
+ *    @param nsys Number of systems in sysids.
+ */
+void space_reconstructPresencesAround( const int *sysids, int nsys )
+{
+   int n = array_size(systems_stack);
+   int range = 0;
+   uint8_t *affected, *sources;
+
+   if (nsys <= 0)
+      return;
+
+   /* Largest spill range. */
+   for (int i=0; i<array_size(spob_stack); i++)
+      range = MAX( range, spob_stack[i].presence.range );
+   for (int i=0; i<array_size(vspob_stack); i++)
+      for (int j=0; j<array_size(vspob_stack[i].presences); j++)
+         range = MAX( range, vspob_stack[i].presences[j].range );
+
+   /* Systems whose presence may change, and the systems that spill into them. */
+   affected = calloc( n, sizeof(uint8_t) );
+   for (int i=0; i<nsys; i++)
+      affected[ sysids[i] ] = 1;
+   space_markAround( affected, range, 0 );
+   sources = malloc( n );
+   memcpy( sources, affected, n );
+   space_markAround( sources, range, 1 );
+
+   /* Reset the presence of the affected systems. */
+   for (int i=0; i<n; i++) {
+      if (!affected[i])
+         continue;
+      array_free(systems_stack[i].presence);
+      systems_stack[i].presence  = array_create( SystemPresence );
+      systems_stack[i].ownerpresence = 0.;
+   }
+
+   /* Re-add presence only to the affected systems. */
+   presence_mask = affected;
+   for (int i=0; i<n; i++)
+      if (sources[i])
+         system_addAllSpobsPresence(&systems_stack[i]);
+   presence_mask = NULL;
+
+   /* Determine dominant faction. */
+   for (int i=0; i<n; i++) {
+      if (!affected[i])
+         continue;
+      system_setFaction( &systems_stack[i] );
+      systems_stack[i].ownerpresence = system_getPresence( &systems_stack[i], systems_stack[i].faction );
+   }
+
+   /* Have to redo the scheduler if the current system changed. */
+   if ((cur_system != NULL) && affected[cur_system->id])
+      system_scheduler( 0., 1 );
+
+   free( affected );
+   free( sources );
+}
+
 /**
  * @brief See if the system has a spob.
  *
@@ -4458,6 +4852,7 @@ static nlua_env spob_lua_get( int *mem, const char *filename )
 
    lf = bsearch( &key, spob_lua_stack, array_size(spob_lua_stack), sizeof(spob_lua_file), spob_lua_cmp );
    if (lf != NULL) {
+      lf->used = ++spob_lua_used;
       *mem = lf->lua_mem;
       return lf->env;
    }
@@ -4468,6 +4863,10 @@ static nlua_env spob_lua_get( int *mem, const char *filename )
       return LUA_NOREF;
    }
 
+   /* Make room if there are too many. */
+   if ((spob_lua_hold <= 0) && (array_size(spob_lua_stack) >= spob_lua_max))
+      spob_lua_evict();
+
    nlua_env env = nlua_newEnv();
    nlua_loadStandard( env );
    nlua_loadGFX( env );
@@ -4477,6 +4876,7 @@ static nlua_env spob_lua_get( int *mem, const char *filename )
    lf = &array_grow( &spob_lua_stack );
    lf->filename = strdup( filename );
    lf->env = env;
+   lf->used = ++spob_lua_used;
 
    /* Add the spob memory table. */
    lua_newtable(naevL);              /* m */
@@ -4507,3 +4907,42 @@ static void spob_lua_free( spob_lua_file *lf )
    nlua_freeEnv( lf->env );
    luaL_unref( naevL, LUA_REGISTRYINDEX, lf->lua_mem );
 }
+
+/**
+ * @brief Frees the least recently used spob Lua environment.
+ *
+ * Environments used by the spobs of the current system are never evicted.
+ * Spobs that were using it keep their memory and get reloaded when needed.
+ *
+ *    @return 0 if an environment was evicted.
+ */
+static int spob_lua_evict (void)
+{
+   spob_lua_file *lf = NULL;
+
+   for (int i=0; i<array_size(spob_lua_stack); i++) {
+      spob_lua_file *cand = &spob_lua_stack[i];
+      int inuse = 0;
+      if ((lf != NULL) && (cand->used >= lf->used))
+         continue;
+      if (cur_system != NULL) {
+         for (int j=0; j<array_size(cur_system->spobs); j++) {
+            if (cur_system->spobs[j]->lua_env == cand->env) {
+               inuse = 1;
+               break;
+            }
+         }
+      }
+      if (!inuse)
+         lf = cand;
+   }
+   if (lf == NULL)
+      return -1;
+
+   for (int i=0; i<array_size(spob_stack); i++)
+      if (spob_stack[i].lua_env == lf->env)
+         spob_luaClear( &spob_stack[i] );
+   spob_lua_free( lf );
+   array_erase( &spob_lua_stack, lf, lf+1 );
+   return 0;
+}
@@ -44,6 +44,7 @@
 #define SPOB_MARKED      (1<<4) /**< Spob is marked. */
 #define SPOB_NOLANES     (1<<5) /**< Spob doesn't connect with lanes. */
 #define SPOB_RADIUS      (1<<10) /**< Spob has radius defined. */
+#define SPOB_LUAFAIL     (1<<11) /**< Spob Lua failed to load, so it isn't tried again. */
 #define spob_isFlag(p,f)    ((p)->flags & (f)) /**< Checks spob flag. */
 #define spob_setFlag(p,f)   ((p)->flags |= (f)) /**< Sets a spob flag. */
 #define spob_rmFlag(p,f)    ((p)->flags &= ~(f)) /**< Removes a spob flag. */
@@ -290,6 +291,7 @@ struct StarSystem_ {
    ShipStatList *stats; /**< System stats. */
    char *note;          /**< Note to player marked system */
    int claims_soft;     /**< Number of soft claims on the system. */
+   Uint32 ovr_hash;     /**< Hash of the state the overlay layout was computed from, 0 if none. */
 };
 
 /* Some useful externs. */
@@ -340,7 +342,10 @@ const char *spob_getSymbol( const Spob *p );
 const glColour* spob_getColour( const Spob *p );
 void spob_updateLand( Spob *p );
 /* Lua stuff. */
+int spob_luaLoad( Spob *spob );
 void spob_luaInitMem( const Spob *spob );
+void spob_luaHold (void);
+void spob_luaRelease (void);
 
 /*
  * Virtual spob stuff.
@@ -385,6 +390,7 @@ double system_getPresence( const StarSystem *sys, int faction );
 double system_getPresenceFull( const StarSystem *sys, int faction, double *base, double *bonus );
 void system_addAllSpobsPresence( StarSystem *sys );
 void space_reconstructPresences( void );
+void space_reconstructPresencesAround( const int *sysids, int nsys );
 void system_rmCurrentPresence( StarSystem *sys, int faction, double amount );
 
 /*
@@ -412,6 +418,9 @@ int system_index( const StarSystem *sys );
 int space_sysReachable( const StarSystem *sys );
 int space_sysReallyReachable( const char* sysname );
 int space_sysReachableFromSys( const StarSystem *target, const StarSystem *sys );
+void space_sysGridDirty (void);
+int *space_sysInRect( int *ids, double x1, double y1, double x2, double y2 );
+StarSystem *space_sysClosest( double x, double y, double r, int (*filter)( const StarSystem *sys ) );
 char** space_getFactionSpob( int *factions, int landable );
 const char* space_getRndSpob( int landable, unsigned int services,
       int (*filter)(Spob *p));
@@ -22,6 +22,7 @@
 #include "debris.h"
 #include "log.h"
 #include "ndata.h"
+#include "nmemory.h"
 #include "nxml.h"
 #include "opengl.h"
 #include "pause.h"
@@ -674,11 +675,11 @@ static void spfx_updateDamage( double dt )
  */
 Trail_spfx* spfx_trail_create( const TrailSpec* spec )
 {
-   Trail_spfx *trail = calloc( 1, sizeof(Trail_spfx) );
+   Trail_spfx *trail = nmem_calloc( MEM_TRAIL, 1, sizeof(Trail_spfx) );
    trail->spec       = spec;
    trail->capacity   = 1;
    trail->iread      = trail->iwrite = 0;
-   trail->point_ringbuf = calloc( trail->capacity, sizeof(TrailPoint) );
+   trail->point_ringbuf = nmem_calloc( MEM_TRAIL, trail->capacity, sizeof(TrailPoint) );
    trail->refcount   = 1;
    trail->r          = RNGF();
    trail->ontop      = 0;
@@ -762,7 +763,7 @@ void spfx_trail_sample( Trail_spfx* trail, double x, double y, TrailMode mode, i
    /* If the last time we inserted a control point was recent enough, we don't need a new one. */
    if (trail_size(trail) == trail->capacity) {
       /* Full! Double capacity, and make the elements contiguous. (We've made space to grow rightward.) */
-      trail->point_ringbuf = realloc( trail->point_ringbuf, 2 * trail->capacity * sizeof(TrailPoint) );
+      trail->point_ringbuf = nmem_realloc( MEM_TRAIL, trail->point_ringbuf, 2 * trail->capacity * sizeof(TrailPoint) );
       trail->iread %= trail->capacity;
       trail->iwrite = trail->iread + trail->capacity;
       memmove( &trail->point_ringbuf[trail->capacity], trail->point_ringbuf, trail->iread * sizeof(TrailPoint) );
@@ -788,8 +789,8 @@ void spfx_trail_remove( Trail_spfx* trail )
 static void spfx_trail_free( Trail_spfx* trail )
 {
    assert(trail->refcount == 0);
-   free(trail->point_ringbuf);
-   free(trail);
+   nmem_free(MEM_TRAIL, trail->point_ringbuf);
+   nmem_free(MEM_TRAIL, trail);
 }
 
 /**
@@ -996,6 +997,8 @@ void spfx_cinematic (void)
 
 static void spfx_renderStack( SPFX *spfx_stack )
 {
+   /* Sprite effects get batched by texture. */
+   gl_batchBegin();
    for (int i=array_size(spfx_stack)-1; i>=0; i--) {
       SPFX *spfx        = &spfx_stack[i];
       SPFX_Base *effect = &spfx_effects[ spfx->effect ];
@@ -1017,6 +1020,10 @@ static void spfx_renderStack( SPFX *spfx_stack )
                (y < -h) || (y > SCREEN_H+h))
             continue;
 
+         /* Draw queued sprites first to keep the order. */
+         gl_batchEnd();
+         gl_batchBegin();
+
          /* Let's get to business. */
          glUseProgram( effect->shader );
 
@@ -1036,6 +1043,7 @@ static void spfx_renderStack( SPFX *spfx_stack )
 
          /* Draw. */
          glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+         gl_drawCalls++;
 
          /* Clear state. */
          glDisableVertexAttribArray( shaders.texture.vertex );
@@ -1067,6 +1075,7 @@ static void spfx_renderStack( SPFX *spfx_stack )
                NULL );
       }
    }
+   gl_batchEnd();
 }
 
 /**
@@ -25,6 +25,8 @@
 #define XML_TECH_ID   "Techs" /**< Tech xml document tag. */
 #define XML_TECH_TAG  "tech"  /**< Individual tech xml tag. */
 
+#define TECH_FLAT_TYPES 2 /**< Item types that get flattened into cached bitsets (outfits and ships). */
+
 /**
  * @brief Different tech types.
  */
@@ -58,13 +60,32 @@ struct tech_group_s {
    char *name;          /**< Name of the tech group. */
    char *filename;      /**< Name of the file. */
    tech_item_t *items;  /**< Items in the tech group. */
+   uint64_t *flat[TECH_FLAT_TYPES]; /**< Cached bitsets of all the items including subgroups. */
+   unsigned int flat_gen[TECH_FLAT_TYPES]; /**< Generation the bitsets were built at. */
 };
 
+/**
+ * @brief Ordering of all the items of a type, used to index the bitsets.
+ */
+typedef struct tech_order_s {
+   const void **items;  /**< All items sorted by their tech comparison function (array.h). */
+   int *rank;           /**< Position in items, indexed by position in the item stack. */
+   const char *base;    /**< Start of the item stack. */
+   size_t size;         /**< Size of an item in the stack. */
+   int words;           /**< Number of words in a bitset. */
+} tech_order_t;
+
 /*
  * Group list.
  */
 static tech_group_t *tech_groups = NULL;
 
+/*
+ * Flattened group caches.
+ */
+static tech_order_t tech_order[TECH_FLAT_TYPES]; /**< Bitset ordering of outfits and ships. */
+static unsigned int tech_generation = 1; /**< Increased whenever any group changes, invalidating the caches. */
+
 /*
  * Prototypes.
  */
@@ -84,6 +105,9 @@ static int tech_addItemGroupPointer( tech_group_t *grp, const tech_group_t *ptr
 static int tech_addItemGroup( tech_group_t *grp, const char* name );
 /* Getting by tech. */
 static void** tech_addGroupItem( void **items, tech_item_type_t type, const tech_group_t *tech );
+static const tech_order_t* tech_orderGet( tech_item_type_t type );
+static const uint64_t* tech_flatten( const tech_group_t *tech, tech_item_type_t type );
+static void** tech_flatItems( const tech_group_t *tech, tech_item_type_t type );
 
 /**
  * @brief Loads the tech information.
@@ -144,6 +168,13 @@ void tech_free (void)
 
    /* Free the tech array. */
    array_free( tech_groups );
+
+   /* Free the orderings. */
+   for (int i=0; i<TECH_FLAT_TYPES; i++) {
+      array_free( tech_order[i].items );
+      free( tech_order[i].rank );
+   }
+   memset( tech_order, 0, sizeof(tech_order) );
 }
 
 /**
@@ -154,6 +185,8 @@ static void tech_freeGroup( tech_group_t *grp )
    free(grp->name);
    free(grp->filename);
    array_free( grp->items );
+   for (int i=0; i<TECH_FLAT_TYPES; i++)
+      free( grp->flat[i] );
 }
 
 /**
@@ -442,6 +475,7 @@ int tech_addItem( const char *name, const char *value )
 
    /* Comfort. */
    tech  = &tech_groups[id];
+   tech_generation++;
 
    /* Try to add the tech. */
    ret = tech_addItemGroup( tech, value );
@@ -464,8 +498,11 @@ int tech_addItem( const char *name, const char *value )
  */
 int tech_addItemTech( tech_group_t *tech, const char *value )
 {
+   int ret;
+   tech_generation++;
+
    /* Try to add the tech. */
-   int ret = tech_addItemGroup( tech, value );
+   ret = tech_addItemGroup( tech, value );
    if (ret)
       ret = tech_addItemOutfit( tech, value );
    if (ret)
@@ -484,8 +521,11 @@ int tech_addItemTech( tech_group_t *tech, const char *value )
  */
 int tech_rmItemTech( tech_group_t *tech, const char *value )
 {
+   int s;
+   tech_generation++;
+
    /* Iterate over to find it. */
-   int s = array_size( tech->items );
+   s = array_size( tech->items );
    for (int i=0; i<s; i++) {
       char *buf = tech_getItemName( &tech->items[i] );
       if (strcmp(buf, value)==0) {
@@ -515,6 +555,7 @@ int tech_rmItem( const char *name, const char *value )
 
    /* Comfort. */
    tech  = &tech_groups[id];
+   tech_generation++;
 
    /* Iterate over to find it. */
    s = array_size( tech->items );
@@ -645,6 +686,123 @@ static void** tech_addGroupItem( void **items, tech_item_type_t type, const tech
    return items;
 }
 
+/**
+ * @brief Gets the bitset ordering of a type of item, creating it if necessary.
+ *
+ * Items are ordered by their tech comparison function so that iterating
+ *  over a bitset gives them already sorted.
+ */
+static const tech_order_t* tech_orderGet( tech_item_type_t type )
+{
+   tech_order_t *ord = &tech_order[type];
+   int (*cmp)( const void*, const void* );
+   int n;
+
+   if (ord->items != NULL)
+      return ord;
+
+   if (type == TECH_TYPE_OUTFIT) {
+      ord->base = (const char*) outfit_getAll();
+      ord->size = sizeof(Outfit);
+      cmp       = outfit_compareTech;
+   }
+   else {
+      ord->base = (const char*) ship_getAll();
+      ord->size = sizeof(Ship);
+      cmp       = ship_compareTech;
+   }
+   n = array_size( ord->base );
+
+   ord->items = array_create_size( const void*, MAX(n,1) );
+   for (int i=0; i<n; i++)
+      array_push_back( &ord->items, ord->base + i*ord->size );
+   qsort( ord->items, n, sizeof(void*), cmp );
+
+   ord->rank = malloc( MAX(n,1) * sizeof(int) );
+   for (int i=0; i<n; i++)
+      ord->rank[ ((const char*)ord->items[i] - ord->base) / ord->size ] = i;
+   ord->words = (n+63) / 64;
+
+   return ord;
+}
+
+/**
+ * @brief Gets the bitset of all the items of a type in a group and its subgroups.
+ *
+ * The bitset is cached in the group until any tech group is modified.
+ *
+ *    @param tech Tech group to flatten.
+ *    @param type Type of the items to get (outfits or ships).
+ *    @return Bitset indexed by the item ordering.
+ */
+static const uint64_t* tech_flatten( const tech_group_t *tech, tech_item_type_t type )
+{
+   /* The cache is not part of the group's logical state. */
+   tech_group_t *grp = (tech_group_t*) tech;
+   const tech_order_t *ord = tech_orderGet( type );
+   uint64_t *set;
+
+   if ((grp->flat[type] != NULL) && (grp->flat_gen[type] == tech_generation))
+      return grp->flat[type];
+
+   if (grp->flat[type] == NULL)
+      grp->flat[type] = calloc( MAX(ord->words,1), sizeof(uint64_t) );
+   else
+      memset( grp->flat[type], 0, ord->words * sizeof(uint64_t) );
+   set = grp->flat[type];
+
+   for (int i=0; i<array_size(grp->items); i++) {
+      const tech_item_t *item = &grp->items[i];
+      const uint64_t *sub;
+
+      if (item->type == type) {
+         int r = ord->rank[ ((const char*)item->u.ptr - ord->base) / ord->size ];
+         set[ r/64 ] |= (uint64_t)1 << (r%64);
+         continue;
+      }
+      else if (item->type == TECH_TYPE_GROUP)
+         sub = tech_flatten( &tech_groups[ item->u.grp ], type );
+      else if (item->type == TECH_TYPE_GROUP_POINTER)
+         sub = tech_flatten( item->u.grpptr, type );
+      else
+         continue;
+
+      /* Union with the subgroup. */
+      for (int w=0; w<ord->words; w++)
+         set[w] |= sub[w];
+   }
+
+   grp->flat_gen[type] = tech_generation;
+   return set;
+}
+
+/**
+ * @brief Gets the items of a type in a group as a sorted array.
+ *
+ *    @param tech Tech group to get items from.
+ *    @param type Type of the items to get (outfits or ships).
+ *    @return Array (array.h) of the items sorted by tech order or NULL if none.
+ */
+static void** tech_flatItems( const tech_group_t *tech, tech_item_type_t type )
+{
+   const tech_order_t *ord = tech_orderGet( type );
+   const uint64_t *set = tech_flatten( tech, type );
+   void **items = NULL;
+
+   for (int w=0; w<ord->words; w++) {
+      uint64_t m = set[w];
+      for (int b=0; m!=0; b++, m>>=1) {
+         if (!(m & 1))
+            continue;
+         if (items == NULL)
+            items = array_create( void* );
+         array_push_back( &items, (void*)ord->items[ w*64+b ] );
+      }
+   }
+
+   return items;
+}
+
 /**
  * @brief Checks whether a given tech group has the specified item.
  *
@@ -724,18 +882,11 @@ char** tech_getAllItemNames( int *n )
  */
 Outfit** tech_getOutfit( const tech_group_t *tech )
 {
-   Outfit **o;
-
    if (tech==NULL)
       return NULL;
 
-   o  = (Outfit**)tech_addGroupItem( NULL, TECH_TYPE_OUTFIT, tech );
-
-   /* Sort. */
-   if (o != NULL)
-      qsort( o, array_size(o), sizeof(Outfit*), outfit_compareTech );
-
-   return o;
+   /* Comes out already sorted. */
+   return (Outfit**) tech_flatItems( tech, TECH_TYPE_OUTFIT );
 }
 
 /**
@@ -772,19 +923,11 @@ Outfit** tech_getOutfitArray( tech_group_t **tech, int num )
  */
 Ship** tech_getShip( const tech_group_t *tech )
 {
-   Ship **s;
-
    if (tech==NULL)
       return NULL;
 
-   /* Get the outfits. */
-   s  = (Ship**) tech_addGroupItem( NULL, TECH_TYPE_SHIP, tech );
-
-   /* Sort. */
-   if (s != NULL)
-      qsort( s, array_size(s), sizeof(Ship*), ship_compareTech );
-
-   return s;
+   /* Comes out already sorted. */
+   return (Ship**) tech_flatItems( tech, TECH_TYPE_SHIP );
 }
 
 /**
@@ -61,6 +61,7 @@ typedef enum WidgetStatus_ {
 #define WGT_FLAG_RAWINPUT     (1<<1)   /**< Widget should always get raw input. */
 #define WGT_FLAG_ALWAYSMMOVE  (1<<2)   /**< Widget should always get mouse motion events. */
 #define WGT_FLAG_FOCUSED      (1<<3)   /**< Widget is focused. */
+#define WGT_FLAG_DYNAMIC      (1<<4)   /**< Widget can change without going through the toolkit, so it can't be cached. */
 #define WGT_FLAG_KILL         (1<<9)   /**< Widget should die. */
 #define wgt_setFlag(w,f)      ((w)->flags |= (f)) /**< Sets a widget flag. */
 #define wgt_rmFlag(w,f)       ((w)->flags &= ~(f)) /**< Removes a widget flag. */
@@ -179,6 +180,14 @@ typedef struct Window_ {
    int focus; /**< Current focused widget. */
    Widget *widgets; /**< Widget storage. */
    void *udata; /**< Custom data of the window. */
+
+   /* Render cache. */
+   GLuint fbo; /**< Framebuffer with the static part of the window, 0 if not allocated. */
+   GLuint fbo_tex; /**< Texture of the cache framebuffer. */
+   int fbo_w; /**< Width of the cache framebuffer in pixels. */
+   int fbo_h; /**< Height of the cache framebuffer in pixels. */
+   int fbo_split; /**< ID of the first widget not in the cache, -1 if all are. */
+   int dirty; /**< Cache has to be redrawn. */
 } Window;
 
 /* Window stuff. */
@@ -64,6 +64,7 @@ void window_addCust( unsigned int wid,
 
    /* specific */
    wgt_setFlag(wgt, WGT_FLAG_CANFOCUS);
+   wgt_setFlag(wgt, WGT_FLAG_DYNAMIC);
    wgt->cleanup         = cst_cleanup;
    wgt->focusGain       = cst_focusGain;
    wgt->focusLose       = cst_focusLose;
@@ -207,6 +208,29 @@ void window_custSetClipping( unsigned int wid, const char *name, int clip )
 }
 
 
+/**
+ * @brief Sets whether or not a custom widget has to be redrawn every frame.
+ *
+ * Custom widgets are dynamic by default. Static ones only get drawn when the
+ *  window changes, which is much cheaper for windows left open.
+ *
+ *    @param wid Window to which widget belongs.
+ *    @param name Name of the widget.
+ *    @param dynamic If 0 the widget only depends on input and toolkit calls.
+ */
+void window_custSetDynamic( unsigned int wid, const char *name, int dynamic )
+{
+   Widget *wgt = cst_getWidget( wid, name );
+   if (wgt == NULL)
+      return;
+
+   if (dynamic)
+      wgt_setFlag( wgt, WGT_FLAG_DYNAMIC );
+   else
+      wgt_rmFlag( wgt, WGT_FLAG_DYNAMIC );
+}
+
+
 /**
  * @brief Sets the widget overlay.
  *
@@ -34,6 +34,7 @@ void window_addCust( unsigned int wid,
       void *data );
 
 void window_custSetClipping( unsigned int wid, const char *name, int clip );
+void window_custSetDynamic( unsigned int wid, const char *name, int dynamic );
 void window_custSetOverlay( unsigned int wid, const char *name,
       void (*renderOverlay) (double bx, double by, double bw, double bh, void* data) );
 void *window_custGetData( unsigned int wid, const char *name );
@@ -356,8 +356,8 @@ static void tab_render( Widget* tab, double bx, double by )
    int i, x, y;
    Window *wdw;
 
-   /** Get window. */
-   wdw = window_wget( tab->dat.tab.windows[ tab->dat.tab.active ] );
+   /** Get window (without marking it as changed). */
+   wdw = window_wgetW( tab->dat.tab.windows[ tab->dat.tab.active ] );
    if (wdw == NULL) {
       WARN( _("Active window in widget '%s' not found in stack."), tab->name);
       return;
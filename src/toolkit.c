@@ -82,6 +82,10 @@ static Widget* toolkit_getFocus( Window *wdw );
 static void toolkit_expose( Window *wdw, int expose );
 /* render */
 static void window_renderBorder( Window* w );
+static void window_renderWidgets( Window *w, Widget *first, int last );
+static int window_renderCached( Window *w );
+static int window_cacheCheck( Window *w );
+static int widget_isDynamic( const Widget *wgt );
 /* Death. */
 static void widget_kill( Widget *wgt );
 static void window_remove( Window *wdw );
@@ -286,6 +290,7 @@ Widget* window_newWidget( Window* w, const char *name )
       w->widgets  = wgt;
    else
       wlast->next = wgt;
+   w->dirty = 1;
 
    return wgt;
 }
@@ -305,6 +310,8 @@ Window* window_wget( unsigned int wid )
    Window *w = window_wgetW( wid );
    if (w==NULL)
       WARN(_("Window '%u' not found in list!"), wid );
+   else
+      w->dirty = 1; /* Assume the caller is going to change it. */
    return w;
 }
 
@@ -1115,6 +1122,10 @@ static void window_remove( Window *wdw )
    wdw->cleanup_fptr = NULL;
 
    /* Destroy the window. */
+   if (wdw->fbo != 0) {
+      glDeleteFramebuffers( 1, &wdw->fbo );
+      glDeleteTextures( 1, &wdw->fbo_tex );
+   }
    free(wdw->name);
    free(wdw->displayname);
    wgt = wdw->widgets;
@@ -1497,6 +1508,32 @@ static void window_renderBorder( Window* w )
          &cFontWhite, -1., w->displayname );
 }
 
+/**
+ * @brief Renders a range of widgets of a window.
+ *
+ *    @param w Window to render widgets of.
+ *    @param first First widget to render.
+ *    @param last ID of the widget to stop at, -1 to render until the end.
+ */
+static void window_renderWidgets( Window *w, Widget *first, int last )
+{
+   double x = w->x;
+   double y = w->y;
+   for (Widget *wgt=first; wgt!=NULL; wgt=wgt->next) {
+      if (wgt->id == last)
+         break;
+      if ((wgt->render != NULL) && !wgt_isFlag(wgt, WGT_FLAG_KILL)) {
+         wgt->render( wgt, x, y );
+
+         if (wgt->id == w->focus) {
+            double wx  = x + wgt->x - 2;
+            double wy  = y + wgt->y - 2;
+            toolkit_drawOutlineThick( wx, wy, wgt->w+4, wgt->h+4, 0, 2, (wgt->type == WIDGET_BUTTON ? &cGrey70 : &cGrey30), NULL );
+         }
+      }
+   }
+}
+
 /**
  * @brief Renders a window.
  *
@@ -1504,16 +1541,10 @@ static void window_renderBorder( Window* w )
  */
 void window_render( Window *w )
 {
-   double x, y;
-
    /* Do not render dead windows. */
    if (window_isFlag( w, WINDOW_KILL ))
       return;
 
-   /* position */
-   x = w->x;
-   y = w->y;
-
    /* We're on top of anything previously drawn. */
    glClear( GL_DEPTH_BUFFER_BIT );
 
@@ -1524,17 +1555,131 @@ void window_render( Window *w )
    /*
     * widgets
     */
+   window_renderWidgets( w, w->widgets, -1 );
+}
+
+/**
+ * @brief Checks to see if a widget has to be drawn every frame.
+ *
+ * Tabbed windows are dynamic if anything in their active tab is.
+ */
+static int widget_isDynamic( const Widget *wgt )
+{
+   const Window *wdw;
+
+   if (wgt_isFlag( wgt, WGT_FLAG_DYNAMIC ))
+      return 1;
+   if (wgt->type != WIDGET_TABBEDWINDOW)
+      return 0;
+
+   wdw = window_wgetW( wgt->dat.tab.windows[ wgt->dat.tab.active ] );
+   if (wdw == NULL)
+      return 0;
+   for (Widget *w=wdw->widgets; w!=NULL; w=w->next)
+      if ((w->render != NULL) && !wgt_isFlag(w, WGT_FLAG_KILL) && widget_isDynamic( w ))
+         return 1;
+   return 0;
+}
+
+/**
+ * @brief Checks to see if a window or any of its tabs changed, clearing the flags.
+ *
+ *    @param w Window to check.
+ *    @return 1 if the window changed since the last check.
+ */
+static int window_cacheCheck( Window *w )
+{
+   int dirty = w->dirty;
+   w->dirty = 0;
    for (Widget *wgt=w->widgets; wgt!=NULL; wgt=wgt->next) {
-      if ((wgt->render != NULL) && !wgt_isFlag(wgt, WGT_FLAG_KILL)) {
-         wgt->render( wgt, x, y );
+      if (wgt->type != WIDGET_TABBEDWINDOW)
+         continue;
+      for (int i=0; i<wgt->dat.tab.ntabs; i++) {
+         Window *wtab = window_wgetW( wgt->dat.tab.windows[i] );
+         if (wtab != NULL)
+            dirty |= window_cacheCheck( wtab );
+      }
+   }
+   return dirty;
+}
 
-         if (wgt->id == w->focus) {
-            double wx  = x + wgt->x - 2;
-            double wy  = y + wgt->y - 2;
-            toolkit_drawOutlineThick( wx, wy, wgt->w+4, wgt->h+4, 0, 2, (wgt->type == WIDGET_BUTTON ? &cGrey70 : &cGrey30), NULL );
-         }
+/**
+ * @brief Renders a window through its cache.
+ *
+ * The border and the widgets up to the first dynamic one are drawn into a
+ *  framebuffer only when the window changes, the rest is drawn on top of it
+ *  every frame so the stacking order is preserved.
+ *
+ *    @param w Window to render.
+ *    @return 1 if the window was rendered, 0 if it can't be cached.
+ */
+static int window_renderCached( Window *w )
+{
+   Widget *split;
+   int dirty, fw, fh, ox, oy, ow, oh;
+
+   /* Borderless windows are drawn over the game and need proper transparency. */
+   if (window_isFlag( w, WINDOW_NOBORDER | WINDOW_KILL ))
+      return 0;
+
+   /* Only widgets before the first dynamic one can be cached. */
+   for (split=w->widgets; split!=NULL; split=split->next)
+      if ((split->render != NULL) && !wgt_isFlag(split, WGT_FLAG_KILL) && widget_isDynamic( split ))
+         break;
+
+   /* See if it has to be redrawn. */
+   dirty = window_cacheCheck( w );
+   if (w->fbo_split != ((split==NULL) ? -1 : split->id)) {
+      w->fbo_split = (split==NULL) ? -1 : split->id;
+      dirty = 1;
+   }
+   fw = ceil( w->w / gl_screen.mxscale );
+   fh = ceil( w->h / gl_screen.myscale );
+   if ((w->fbo == 0) || (w->fbo_w != fw) || (w->fbo_h != fh)) {
+      if (w->fbo != 0) {
+         glDeleteFramebuffers( 1, &w->fbo );
+         glDeleteTextures( 1, &w->fbo_tex );
       }
+      if (!gl_fboCreate( &w->fbo, &w->fbo_tex, fw, fh )) {
+         glDeleteFramebuffers( 1, &w->fbo );
+         glDeleteTextures( 1, &w->fbo_tex );
+         w->fbo = 0;
+         return 0;
+      }
+      w->fbo_w = fw;
+      w->fbo_h = fh;
+      dirty = 1;
+   }
+
+   /* Redraw the cache with the window at the origin. */
+   if (dirty) {
+      ox = gl_screen.x;
+      oy = gl_screen.y;
+      ow = gl_screen.w;
+      oh = gl_screen.h;
+      glBindFramebuffer( GL_FRAMEBUFFER, w->fbo );
+      glClearColor( 0., 0., 0., 0. );
+      glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+      /* Alpha has to accumulate so the cache stays opaque. */
+      glBlendFuncSeparate( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+      gl_viewport( ox - w->x, oy - w->y, ow, oh );
+
+      window_renderBorder( w );
+      window_renderWidgets( w, w->widgets, w->fbo_split );
+
+      gl_viewport( ox, oy, ow, oh );
+      glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+      glBindFramebuffer( GL_FRAMEBUFFER, gl_screen.current_fbo );
+      glClearColor( 0., 0., 0., 1. );
    }
+
+   /* Draw the cache and the live widgets on top. */
+   glClear( GL_DEPTH_BUFFER_BIT );
+   gl_renderTextureRaw( w->fbo_tex, 0, w->x, w->y, w->w, w->h,
+         0., 0., w->w / gl_screen.mxscale / fw, w->h / gl_screen.myscale / fh, NULL, 0. );
+   if (split != NULL)
+      window_renderWidgets( w, split, -1 );
+   return 1;
 }
 
 /**
@@ -1623,7 +1768,8 @@ void toolkit_render( double dt )
       }
 
       /* The actual rendering. */
-      window_render(w);
+      if (use_fb || !window_renderCached(w))
+         window_render(w);
       window_renderOverlay(w);
 
       /* Drawing directly to the main framebuffer. */
@@ -1689,6 +1835,9 @@ int toolkit_inputWindow( Window *wdw, SDL_Event *event, int purge )
 {
    int ret;
 
+   /* Widgets may change with any event. */
+   wdw->dirty = 1;
+
    /* See if widget needs event. */
    for (Widget *wgt=wdw->widgets; wgt!=NULL; wgt=wgt->next) {
       if (wgt_isFlag( wgt, WGT_FLAG_RAWINPUT )) {
@@ -2377,6 +2526,7 @@ void toolkit_focusWidget( Window *wdw, Widget *wgt )
       return;
 
    wdw->focus = wgt->id;
+   wdw->dirty = 1;
    wgt_setFlag( wgt, WGT_FLAG_FOCUSED );
    if (wgt->focusGain != NULL)
       wgt->focusGain( wgt );
@@ -2392,6 +2542,7 @@ void toolkit_defocusWidget( Window *wdw, Widget *wgt )
       return;
 
    wdw->focus = -1;
+   wdw->dirty = 1;
    wgt_rmFlag( wgt, WGT_FLAG_FOCUSED );
    if (wgt->focusLose != NULL)
       wgt->focusLose( wgt );
@@ -2584,6 +2735,9 @@ void toolkit_reposition (void)
    for (Window *w = windows; w != NULL; w = w->next) {
       int xorig, yorig, xdiff, ydiff;
 
+      /* Scale or fonts may have changed. */
+      w->dirty = 1;
+
       /* Fullscreen windows must always be full size, though their widgets
        * don't auto-scale. */
       if (window_isFlag( w, WINDOW_FULLSCREEN )) {
@@ -153,9 +153,22 @@ typedef struct UniDiff_ {
  */
 static UniDiff_t *diff_stack = NULL; /**< Currently applied universe diffs. */
 
+/*
+ * Parts of the universe that have to be updated after diffs are applied.
+ */
+#define DIFF_UPDATE_PRESENCE  (1<<0) /**< Presence has to be recomputed. */
+#define DIFF_UPDATE_LANES     (1<<1) /**< Safe lanes have to be recomputed. */
+#define DIFF_UPDATE_ECONOMY   (1<<2) /**< Commodity prices have to be recomputed. */
+#define DIFF_UPDATE_GFX       (1<<3) /**< Graphics of the current system have to be reloaded. */
+#define DIFF_UPDATE_NAV       (1<<4) /**< Spob and jump targets have to be reset. */
+#define DIFF_UPDATE_FULL      (1<<5) /**< Update all systems instead of only the touched ones. */
+#define DIFF_UPDATE_SPOB      (DIFF_UPDATE_PRESENCE | DIFF_UPDATE_LANES | DIFF_UPDATE_ECONOMY | DIFF_UPDATE_GFX | DIFF_UPDATE_NAV) /**< Spob added or removed from a system. */
+#define DIFF_UPDATE_JUMP      (DIFF_UPDATE_PRESENCE | DIFF_UPDATE_LANES | DIFF_UPDATE_ECONOMY | DIFF_UPDATE_NAV) /**< Jump added or removed from a system. */
+
 /* Useful variables. */
-static int diff_universe_changed = 0; /**< Whether or not the universe changed. */
+static unsigned int diff_universe_changed = 0; /**< What parts of the universe changed (DIFF_UPDATE_*). */
 static int diff_universe_defer = 0; /**< Defers changes to later. */
+static int *diff_touched = NULL; /**< Array (array.h): IDs of the systems touched since the last update. */
 
 /*
  * Prototypes.
@@ -173,6 +186,9 @@ static void diff_hunkSuccess( UniDiff_t *diff, UniHunk_t *hunk );
 static void diff_cleanup( UniDiff_t *diff );
 static void diff_cleanupHunk( UniHunk_t *hunk );
 /* Misc. */;
+static void diff_touchSystem( const StarSystem *sys, unsigned int flags );
+static void diff_touchSpob( const Spob *p, unsigned int flags );
+static void diff_resetChanges (void);
 static int diff_checkUpdateUniverse (void);
 /* Externed. */
 int diff_save( xmlTextWriterPtr writer ); /**< Used in save.c */
@@ -303,7 +319,7 @@ static int diff_applyInternal( const char *name, int oneshot )
 
    /* Reset change variable. */
    if (oneshot && !diff_universe_defer)
-      diff_universe_changed = 0;
+      diff_resetChanges();
 
    const UniDiffData_t q = { .name = (char*)name };
    d = bsearch( &q, diff_available, array_size(diff_available), sizeof(UniDiffData_t), diff_cmp );
@@ -895,20 +911,14 @@ static int diff_patch( xmlNodePtr parent )
    node = parent->xmlChildrenNode;
    do {
       xml_onlyNodes(node);
-      if (xml_isNode(node,"system")) {
-         diff_universe_changed = 1;
+      if (xml_isNode(node,"system"))
          diff_patchSystem( diff, node );
-      }
       else if (xml_isNode(node, "tech"))
          diff_patchTech( diff, node );
-      else if (xml_isNode(node, "spob")) {
-         diff_universe_changed = 1;
+      else if (xml_isNode(node, "spob"))
          diff_patchSpob( diff, node );
-      }
-      else if (xml_isNode(node, "faction")) {
-         diff_universe_changed = 1;
+      else if (xml_isNode(node, "faction"))
          diff_patchFaction( diff, node );
-      }
       else
          WARN(_("Unidiff '%s' has unknown node '%s'."), diff->name, node->name);
    } while (xml_nextNode(node));
@@ -1090,30 +1100,38 @@ static int diff_patchHunk( UniHunk_t *hunk )
       /* Adding an spob. */
       case HUNK_TYPE_SPOB_ADD:
          spob_luaInit( spob_get(hunk->u.name) );
-         diff_universe_changed = 1;
-         return system_addSpob( system_get(hunk->target.u.name), hunk->u.name );
+         ssys = system_get(hunk->target.u.name);
+         diff_touchSystem( ssys, DIFF_UPDATE_SPOB );
+         return system_addSpob( ssys, hunk->u.name );
       /* Removing an spob. */
       case HUNK_TYPE_SPOB_REMOVE:
-         diff_universe_changed = 1;
-         return system_rmSpob( system_get(hunk->target.u.name), hunk->u.name );
+         ssys = system_get(hunk->target.u.name);
+         diff_touchSystem( ssys, DIFF_UPDATE_SPOB );
+         return system_rmSpob( ssys, hunk->u.name );
 
       /* Adding an spob. */
       case HUNK_TYPE_VSPOB_ADD:
-         diff_universe_changed = 1;
-         return system_addVirtualSpob( system_get(hunk->target.u.name), hunk->u.name );
+         ssys = system_get(hunk->target.u.name);
+         diff_touchSystem( ssys, DIFF_UPDATE_PRESENCE | DIFF_UPDATE_LANES );
+         return system_addVirtualSpob( ssys, hunk->u.name );
       /* Removing an spob. */
       case HUNK_TYPE_VSPOB_REMOVE:
-         diff_universe_changed = 1;
-         return system_rmVirtualSpob( system_get(hunk->target.u.name), hunk->u.name );
+         ssys = system_get(hunk->target.u.name);
+         diff_touchSystem( ssys, DIFF_UPDATE_PRESENCE | DIFF_UPDATE_LANES );
+         return system_rmVirtualSpob( ssys, hunk->u.name );
 
       /* Adding a Jump. */
       case HUNK_TYPE_JUMP_ADD:
-         diff_universe_changed = 1;
-         return system_addJumpDiff( system_get(hunk->target.u.name), hunk->node );
+         ssys = system_get(hunk->target.u.name);
+         diff_touchSystem( ssys, DIFF_UPDATE_JUMP );
+         diff_touchSystem( system_get(hunk->u.name), DIFF_UPDATE_JUMP );
+         return system_addJumpDiff( ssys, hunk->node );
       /* Removing a jump. */
       case HUNK_TYPE_JUMP_REMOVE:
-         diff_universe_changed = 1;
-         return system_rmJump( system_get(hunk->target.u.name), hunk->u.name );
+         ssys = system_get(hunk->target.u.name);
+         diff_touchSystem( ssys, DIFF_UPDATE_JUMP );
+         diff_touchSystem( system_get(hunk->u.name), DIFF_UPDATE_JUMP );
+         return system_rmJump( ssys, hunk->u.name );
 
       /* Changing system background. */
       case HUNK_TYPE_SSYS_BACKGROUND:
@@ -1153,13 +1171,13 @@ static int diff_patchHunk( UniHunk_t *hunk )
             hunk->o.name = NULL;
          else
             hunk->o.name = faction_name( p->presence.faction );
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_PRESENCE | DIFF_UPDATE_LANES | DIFF_UPDATE_ECONOMY );
          return spob_setFaction( p, faction_get(hunk->u.name) );
       case HUNK_TYPE_SPOB_FACTION_REMOVE:
          p = spob_get( hunk->target.u.name );
          if (p==NULL)
             return -1;
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_PRESENCE | DIFF_UPDATE_LANES | DIFF_UPDATE_ECONOMY );
          if (hunk->o.name==NULL)
             return spob_setFaction( p, -1 );
          else
@@ -1172,12 +1190,14 @@ static int diff_patchHunk( UniHunk_t *hunk )
             return -1;
          hunk->o.data = p->population;
          p->population = hunk->u.data;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY );
          return 0;
       case HUNK_TYPE_SPOB_POPULATION_REMOVE:
          p = spob_get( hunk->target.u.name );
          if (p==NULL)
             return -1;
          p->population = hunk->o.data;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY );
          return 0;
 
       /* Changing spob displayname. */
@@ -1233,7 +1253,7 @@ static int diff_patchHunk( UniHunk_t *hunk )
          if (spob_hasService( p, hunk->u.data ))
             return -1;
          spob_addService( p, hunk->u.data );
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY );
          return 0;
       case HUNK_TYPE_SPOB_SERVICE_REMOVE:
          p = spob_get( hunk->target.u.name );
@@ -1242,7 +1262,7 @@ static int diff_patchHunk( UniHunk_t *hunk )
          if (!spob_hasService( p, hunk->u.data ))
             return -1;
          spob_rmService( p, hunk->u.data );
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY );
          return 0;
 
       /* Modifying tech stuff. */
@@ -1296,14 +1316,14 @@ static int diff_patchHunk( UniHunk_t *hunk )
             return -1;
          hunk->o.name = p->gfx_spaceName;
          p->gfx_spaceName = hunk->u.name;
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY | DIFF_UPDATE_GFX );
          return 0;
       case HUNK_TYPE_SPOB_SPACE_REVERT:
          p = spob_get( hunk->target.u.name );
          if (p==NULL)
             return -1;
          p->gfx_spaceName = (char*)hunk->o.name;
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY | DIFF_UPDATE_GFX );
          return 0;
 
       /* Changing spob exterior graphics. */
@@ -1313,12 +1333,14 @@ static int diff_patchHunk( UniHunk_t *hunk )
             return -1;
          hunk->o.name = p->gfx_exterior;
          p->gfx_exterior = hunk->u.name;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY );
          return 0;
       case HUNK_TYPE_SPOB_EXTERIOR_REVERT:
          p = spob_get( hunk->target.u.name );
          if (p==NULL)
             return -1;
          p->gfx_exterior = (char*)hunk->o.name;
+         diff_touchSpob( p, DIFF_UPDATE_ECONOMY );
          return 0;
 
       /* Change Lua stuff. */
@@ -1329,7 +1351,7 @@ static int diff_patchHunk( UniHunk_t *hunk )
          hunk->o.name = p->lua_file;
          p->lua_file = hunk->u.name;
          spob_luaInit( p );
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_GFX );
          return 0;
       case HUNK_TYPE_SPOB_LUA_REVERT:
          p = spob_get( hunk->target.u.name );
@@ -1337,14 +1359,17 @@ static int diff_patchHunk( UniHunk_t *hunk )
             return -1;
          p->lua_file = (char*)hunk->o.name;
          spob_luaInit( p );
-         diff_universe_changed = 1;
+         diff_touchSpob( p, DIFF_UPDATE_GFX );
          return 0;
 
       /* Making a faction visible. */
+      /* Only visible factions build safe lanes. */
       case HUNK_TYPE_FACTION_VISIBLE:
+         diff_universe_changed |= DIFF_UPDATE_LANES;
          return faction_setInvisible( faction_get(hunk->target.u.name), 0 );
       /* Making a faction invisible. */
       case HUNK_TYPE_FACTION_INVISIBLE:
+         diff_universe_changed |= DIFF_UPDATE_LANES;
          return faction_setInvisible( faction_get(hunk->target.u.name), 1 );
       /* Making two factions allies. */
       case HUNK_TYPE_FACTION_ALLY:
@@ -1492,6 +1517,8 @@ void diff_free (void)
    }
    array_free(diff_available);
    diff_available = NULL;
+   array_free(diff_touched);
+   diff_touched = NULL;
 }
 
 /**
@@ -1744,7 +1771,7 @@ int diff_load( xmlNodePtr parent )
 
    /* Don't update universe here. */
    diff_universe_defer = 1;
-   diff_universe_changed = 0;
+   diff_resetChanges();
    diff_clear();
    diff_universe_defer = defer;
 
@@ -1765,35 +1792,119 @@ int diff_load( xmlNodePtr parent )
       }
    } while (xml_nextNode(node));
 
+   /* Loading is not time critical, so just recompute everything. */
+   if (diff_universe_changed)
+      diff_universe_changed |= DIFF_UPDATE_SPOB | DIFF_UPDATE_FULL;
+
    /* Update as necessary. */
    diff_checkUpdateUniverse();
 
    return 0;
 }
 
+/**
+ * @brief Marks a system as touched by a diff.
+ *
+ *    @param sys System that was changed.
+ *    @param flags Parts of the universe that have to be updated (DIFF_UPDATE_*).
+ */
+static void diff_touchSystem( const StarSystem *sys, unsigned int flags )
+{
+   if (sys == NULL)
+      return;
+
+   /* Graphics only matter for the current system. */
+   if (sys != cur_system)
+      flags &= ~DIFF_UPDATE_GFX;
+   diff_universe_changed |= flags;
+
+   if (diff_touched == NULL)
+      diff_touched = array_create( int );
+   for (int i=0; i<array_size(diff_touched); i++)
+      if (diff_touched[i] == sys->id)
+         return;
+   array_push_back( &diff_touched, sys->id );
+}
+
+/**
+ * @brief Marks the system of a spob as touched by a diff.
+ *
+ *    @param p Spob that was changed.
+ *    @param flags Parts of the universe that have to be updated (DIFF_UPDATE_*).
+ */
+static void diff_touchSpob( const Spob *p, unsigned int flags )
+{
+   const char *sysname;
+   if (p == NULL)
+      return;
+   /* Spobs that aren't in a system don't affect anything. */
+   sysname = spob_getSystem( p->name );
+   if (sysname == NULL)
+      return;
+   diff_touchSystem( system_get( sysname ), flags );
+}
+
+/**
+ * @brief Forgets about all the pending universe changes.
+ */
+static void diff_resetChanges (void)
+{
+   diff_universe_changed = 0;
+   if (diff_touched != NULL)
+      array_resize( &diff_touched, 0 );
+}
+
 /**
  * @brief Checks and updates the universe if necessary.
+ *
+ * Only the parts of the universe affected by the touched systems are
+ * recomputed, unless there are so many of them a full update is cheaper.
  */
 static int diff_checkUpdateUniverse (void)
 {
    Pilot *const* pilots;
+   unsigned int changed;
+   int full;
 
    if (!diff_universe_changed || diff_universe_defer)
       return 0;
 
-   space_reconstructPresences();
-   safelanes_recalculate();
+   changed = diff_universe_changed;
+   full = (changed & DIFF_UPDATE_FULL) ||
+      (array_size(diff_touched) > array_size(system_getAll())/4);
+
+   if (changed & DIFF_UPDATE_PRESENCE) {
+      if (full)
+         space_reconstructPresences();
+      else
+         space_reconstructPresencesAround( diff_touched, array_size(diff_touched) );
+   }
+
+   /* Safe lanes are a global optimization so they are either all computed or
+    * left untouched. */
+   if ((changed & DIFF_UPDATE_LANES) || !safelanes_calculated())
+      safelanes_recalculate();
 
    /* Re-compute the economy. */
-   economy_execQueued();
-   economy_initialiseCommodityPrices();
+   if (changed & DIFF_UPDATE_ECONOMY) {
+      economy_execQueued();
+      if (full)
+         economy_initialiseCommodityPrices();
+      else
+         economy_initialiseCommodityPricesAround( diff_touched, array_size(diff_touched) );
+   }
 
    /* Have to update planet graphics if necessary. */
-   if (cur_system != NULL) {
+   if ((changed & DIFF_UPDATE_GFX) && (cur_system != NULL)) {
       space_gfxUnload( cur_system );
       space_gfxLoad( cur_system );
    }
 
+   diff_resetChanges();
+
+   if (!(changed & DIFF_UPDATE_NAV))
+      return 1;
+
    /* Have to pilot targetting just in case. */
    pilots = pilot_getAll();
    for (int i=0; i<array_size(pilots); i++) {
@@ -1820,7 +1931,6 @@ static int diff_checkUpdateUniverse (void)
    player_targetSpobSet( -1 );
    player_targetHyperspaceSet( -1, 0 );
 
-   diff_universe_changed = 0;
    return 1;
 }
 
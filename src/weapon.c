@@ -25,6 +25,7 @@
 #include "explosion.h"
 #include "gui.h"
 #include "log.h"
+#include "nmemory.h"
 #include "nstring.h"
 #include "nlua_pilot.h"
 #include "nlua_vec2.h"
@@ -547,6 +548,9 @@ static void think_beam( Weapon* w, const double dt )
  */
 void weapons_update( const double dt )
 {
+   /* Collisions use the pilot positions. */
+   pilots_hotSync();
+
    /* When updating, just mark weapons for deletion. */
    weapons_updateLayer(dt,WEAPON_LAYER_BG);
    weapons_updateLayer(dt,WEAPON_LAYER_FG);
@@ -729,8 +733,11 @@ void weapons_render( const WeaponLayer layer, const double dt )
          return;
    }
 
+   /* Sprites get batched by texture. */
+   gl_batchBegin();
    for (int i=0; i<array_size(wlayer); i++)
       weapon_render( wlayer[i], dt );
+   gl_batchEnd();
 }
 
 static void weapon_renderBeam( Weapon* w, const double dt )
@@ -774,6 +781,7 @@ static void weapon_renderBeam( Weapon* w, const double dt )
 
    /* Draw. */
    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   gl_drawCalls++;
 
    /* Clear state. */
    glDisableVertexAttribArray( shaders.beam.vertex );
@@ -813,6 +821,9 @@ static void weapon_render( Weapon* w, const double dt )
             col_blend( &col, &cYellow, &cRed, st );
             col.a = 0.5;
 
+            /* Draw queued sprites first to keep the order. */
+            gl_batchEnd();
+            gl_batchBegin();
             glUseProgram( shaders.iflockon.program );
             glUniform1f( shaders.iflockon.paramf, st );
             gl_renderShader( x, y, r, r, r, &shaders.iflockon, &col, 1 );
@@ -862,6 +873,9 @@ static void weapon_render( Weapon* w, const double dt )
       /* Beam weapons. */
       case OUTFIT_TYPE_BEAM:
       case OUTFIT_TYPE_TURRET_BEAM:
+         /* Draw queued sprites first to keep the order. */
+         gl_batchEnd();
+         gl_batchBegin();
          weapon_renderBeam(w, dt);
          break;
 
@@ -955,17 +969,19 @@ static void weapon_update( Weapon* w, const double dt, WeaponLayer layer )
    const glTexture *gfx;
    const CollPoly *plg, *polygon;
    vec2 crash[2];
-   Pilot *const* pilot_stack;
+   const PilotHot *ph;
+   double wr, wdx, wdy;
    int isjammed;
 
    gfx = NULL;
    polygon = NULL;
-   pilot_stack = pilot_getAll();
+   ph = pilot_getAllHot();
 
    /* Get the sprite direction to speed up calculations. */
    b     = outfit_isBeam(w->outfit);
    if (!b) {
       gfx = outfit_gfx(w->outfit);
+      wr  = hypot( gfx->sw, gfx->sh ) / 2.;
       gl_getSpriteFromDir( &w->sx, &w->sy, gfx, w->solid->dir );
       n = gfx->sx * w->sy + w->sx;
       plg = outfit_plg(w->outfit);
@@ -983,6 +999,7 @@ static void weapon_update( Weapon* w, const double dt, WeaponLayer layer )
    }
    else {
       Pilot *p = pilot_get( w->parent );
+      wr = 0.;
       if (p != NULL) {
          /* Beams need to update their properties online. */
          if (w->outfit->type == OUTFIT_TYPE_BEAM) {
@@ -997,18 +1014,35 @@ static void weapon_update( Weapon* w, const double dt, WeaponLayer layer )
       }
    }
 
-   for (int i=0; i<array_size(pilot_stack); i++) {
-      Pilot *p = pilot_stack[i];
+   wdx = cos( w->solid->dir );
+   wdy = sin( w->solid->dir );
+   for (int i=0; i<array_size(ph); i++) {
+      Pilot *p;
+
+      /* Quick rejection on the bounding circles so far away pilots are
+       * never touched. */
+      if (b) {
+         /* Closest point on the beam. */
+         double t = (ph[i].pos.x - w->solid->pos.x) * wdx + (ph[i].pos.y - w->solid->pos.y) * wdy;
+         t = CLAMP( 0., w->outfit->u.bem.range, t );
+         if (pow2( w->solid->pos.x + t*wdx - ph[i].pos.x ) +
+               pow2( w->solid->pos.y + t*wdy - ph[i].pos.y ) > pow2( ph[i].radius ))
+            continue;
+      }
+      else if (vec2_dist2( &w->solid->pos, &ph[i].pos ) > pow2( ph[i].radius + wr ))
+         continue;
+
+      p = ph[i].p;
 
       /* Ignore pilots being deleted. */
       if (pilot_isFlag(p, PILOT_DELETE))
          continue;
 
-      if (w->parent == pilot_stack[i]->id)
+      if (w->parent == p->id)
          continue; /* pilot is self */
 
-      psx = pilot_stack[i]->tsx;
-      psy = pilot_stack[i]->tsy;
+      psx = p->tsx;
+      psy = p->tsy;
 
       /* See if the ship has a collision polygon. */
       usePoly = usePolyW;
@@ -1030,16 +1064,18 @@ static void weapon_update( Weapon* w, const double dt, WeaponLayer layer )
                      w->outfit->u.bem.range, p->ship->gfx_space, psx, psy,
                      &p->solid->pos, crash);
             }
-            if (coll)
+            if (coll) {
                weapon_hitBeam( w, p, layer, crash, dt );
                /* No return because beam can still think, it's not
                 * destroyed like the other weapons.*/
+               ph = pilot_getAllHot(); /* Hooks may have added pilots. */
+            }
          }
       }
       /* smart weapons only collide with their target */
       else if (weapon_isSmart(w)) {
          isjammed = ((w->status == WEAPON_STATUS_JAMMED) || (w->status == WEAPON_STATUS_JAMMED_SLOWED));
-         if ((((pilot_stack[i]->id == w->target) && !isjammed) || isjammed) &&
+         if ((((p->id == w->target) && !isjammed) || isjammed) &&
                weapon_checkCanHit(w,p) ) {
             if (usePoly) {
                int k = p->ship->gfx_space->sx * psy + psx;
@@ -1109,8 +1145,7 @@ static void weapon_update( Weapon* w, const double dt, WeaponLayer layer )
                RotatePolygon( &rpoly, a->polygon, (float) a->ang );
                coll = CollidePolygon( &rpoly, &a->pos,
                         polygon, &w->solid->pos, &crash[0] );
-               free(rpoly.x);
-               free(rpoly.y);
+               FreePolygon( &rpoly );
             }
             else {
                coll = CollideSprite( gfx, w->sx, w->sy, &w->solid->pos,
@@ -1154,8 +1189,7 @@ static void weapon_update( Weapon* w, const double dt, WeaponLayer layer )
                coll = CollideLinePolygon( &w->solid->pos, w->solid->dir,
                                     w->outfit->u.bem.range,
                                     &rpoly, &a->pos, crash );
-               free(rpoly.x);
-               free(rpoly.y);
+               FreePolygon( &rpoly );
             }
             else {
                coll = CollideLineSprite( &w->solid->pos, w->solid->dir,
@@ -1845,7 +1879,7 @@ static Weapon* weapon_create( PilotOutfitSlot *po, double T,
    const Outfit *outfit = po->outfit;
 
    /* Create basic features */
-   w           = calloc( 1, sizeof(Weapon) );
+   w           = nmem_calloc( MEM_WEAPON, 1, sizeof(Weapon) );
    w->dam_mod  = 1.; /* Default of 100% damage. */
    w->dam_as_dis_mod = 0.; /* Default of 0% damage to disable. */
    w->faction  = parent->faction; /* non-changeable */
@@ -2152,7 +2186,7 @@ static void weapon_free( Weapon* w )
    memset(w, 0, sizeof(Weapon));
 #endif /* DEBUGGING */
 
-   free(w);
+   nmem_free(MEM_WEAPON, w);
 }
 
 /**
@@ -0,0 +1,62 @@
+--[[
+   Times polygon collision tests between pairs of ships over the shipped
+   collision polygons. Run it on two builds to compare collision code.
+--]]
+local common = require "utils.benchmark.common"
+
+local reps = 10
+local samples = 2000
+
+local ships = {
+   "Llama",
+   "Hyena",
+   "Ancestor",
+   "Vendetta",
+   "Lancelot",
+   "Admonisher",
+   "Pacifier",
+   "Vigilance",
+   "Kestrel",
+   "Goddard",
+}
+
+pilot.clear()
+local pilots = {}
+for k,s in ipairs(ships) do
+   local p = pilot.add( s, "Dummy", vec2.new(0,0), nil, {naked=true, ai="dummy"} )
+   table.insert( pilots, p )
+end
+
+-- Offsets are fixed so both builds test the same configurations.
+local offsets = {}
+for i=1,samples do
+   offsets[i] = vec2.newP( 300*math.sqrt(i/samples), i*2.39996 )
+end
+
+print("====== BENCHMARK START ======")
+local vals = {}
+local hits
+for r=1,reps do
+   hits = 0
+   local rstart = naev.clock()
+   for i,p in ipairs(pilots) do
+      for j,t in ipairs(pilots) do
+         if i~=j then
+            for k,o in ipairs(offsets) do
+               t:setPos( o )
+               if p:collisionTest( t ) then
+                  hits = hits + 1
+               end
+            end
+         end
+      end
+   end
+   table.insert( vals, (naev.clock()-rstart)*1000 )
+end
+
+local mean, stddev = common.mean_stddev( vals )
+
+print(string.format("%d tests, %d hits: %.3f ms (stddev %.3f ms)",
+      #pilots*(#pilots-1)*samples, hits, mean, stddev ))
+print("====== BENCHMARK END ======")
+pilot.clear()
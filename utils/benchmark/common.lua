@@ -0,0 +1,23 @@
+--[[
+   Helpers shared by the benchmark scripts.
+--]]
+local common = {}
+
+--[[
+   Computes the mean and standard deviation of a list of values.
+--]]
+function common.mean_stddev( vals )
+   local mean = 0
+   for k,v in ipairs(vals) do
+      mean = mean + v
+   end
+   mean = mean / #vals
+   local stddev = 0
+   for k,v in ipairs(vals) do
+      stddev = stddev + math.pow(v-mean, 2)
+   end
+   stddev = math.sqrt(stddev / #vals)
+   return mean, stddev
+end
+
+return common
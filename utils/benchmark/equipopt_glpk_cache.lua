@@ -0,0 +1,61 @@
+--[[
+   Measures how long equipping takes to block spawning. First with the
+   default randomness, where no problems repeat, then without randomness so
+   that repeated ship/faction pairs are served by the solution cache. Finally
+   compares solving uncached problems to solving the same problems again.
+--]]
+local benchmark = require "utils.benchmark.equipopt_glpk_common"
+
+local reps = 10
+
+print("====== BENCHMARK START ======")
+local rnd_mean, rnd_stddev = benchmark.run( "Random", reps, {} )
+print( string.format( "% 10s: %.3f (%.3f) ms", "Random", rnd_mean, rnd_stddev ) )
+-- First repetition fills the cache, the rest should hit it
+local det_mean, det_stddev, det_vals = benchmark.run( "Cached", reps, {}, {rnd=0} )
+print( string.format( "% 10s: %.3f (%.3f) ms, first %.3f ms", "Cached", det_mean, det_stddev, det_vals[1] ) )
+
+-- Knapsack-like problems, perturbed so they never hit the cache
+local ncols = 60
+local nrows = 8
+local nprob = 50
+local function build()
+   local lp = linopt.new( "bench", ncols, nrows, true )
+   for j=1,ncols do
+      lp:set_col( j, tostring(j), rnd.rnd()*100, "integer", 0, 3 )
+   end
+   local ia, ja, ar = {}, {}, {}
+   for i=1,nrows do
+      lp:set_row( i, tostring(i), nil, 100 )
+      for j=1,ncols do
+         table.insert( ia, i )
+         table.insert( ja, j )
+         table.insert( ar, rnd.rnd()*20 )
+      end
+   end
+   lp:load_matrix( ia, ja, ar )
+   return lp
+end
+
+local problems = {}
+for i=1,nprob do
+   table.insert( problems, build() )
+end
+
+local uncached = 0
+for k,lp in ipairs(problems) do
+   local t = naev.clock()
+   lp:solve()
+   uncached = uncached + naev.clock()-t
+end
+
+local cached = 0
+for k,lp in ipairs(problems) do
+   local t = naev.clock()
+   lp:solve()
+   cached = cached + naev.clock()-t
+end
+
+print( string.format( "% 10s: %.3f ms per problem", "Uncached", uncached*1000/nprob ) )
+print( string.format( "% 10s: %.3f ms per problem", "Resolved", cached*1000/nprob ) )
+print("====== BENCHMARK END ======")
@@ -1,6 +1,6 @@
 local equipopt = require 'equipopt'
 local benchmark = {}
-function benchmark.run( _testname, reps, sparams )
+function benchmark.run( _testname, reps, sparams, eparams )
    local ships = {
       "Llama",
       "Hyena",
@@ -37,8 +37,7 @@ function benchmark.run( _testname, reps, sparams )
             local p = pilot.add( s, "Dummy", pos, nil, {naked=true} )
             if sparams then
                equipopt.optimize.sparams = sparams
-               f( p )
-               --f( p, {rnd=0.0})
+               f( p, eparams )
             end
             p:rm()
          end
@@ -0,0 +1,57 @@
+--[[
+   Times looking up universe objects by name through the Lua API. Run it on
+   two builds to compare the name lookup code.
+--]]
+local common = require "utils.benchmark.common"
+
+local reps = 10
+local passes = 20
+
+local function names( all )
+   local t = {}
+   for k,v in ipairs(all) do
+      table.insert( t, v:nameRaw() )
+   end
+   return t
+end
+
+-- There is no faction.getAll(), so use the factions owning spobs.
+local factions = {}
+local seen = {}
+for k,s in ipairs(spob.getAll()) do
+   local f = s:faction()
+   if f and not seen[f:nameRaw()] then
+      seen[f:nameRaw()] = true
+      table.insert( factions, f )
+   end
+end
+
+local tests = {
+   { "system",    system.get,    names( system.getAll() ) },
+   { "spob",      spob.get,      names( spob.getAll() ) },
+   { "outfit",    outfit.get,    names( outfit.getAll() ) },
+   { "ship",      ship.get,      names( ship.getAll() ) },
+   { "faction",   faction.get,   names( factions ) },
+   { "commodity", commodity.get, names( commodity.getStandard() ) },
+}
+
+print("====== BENCHMARK START ======")
+for i,t in ipairs(tests) do
+   local name, get, list = t[1], t[2], t[3]
+   local vals = {}
+   for r=1,reps do
+      local rstart = naev.clock()
+      for p=1,passes do
+         for k,n in ipairs(list) do
+            get( n )
+         end
+      end
+      table.insert( vals, (naev.clock()-rstart)*1000 )
+   end
+
+   local mean, stddev = common.mean_stddev( vals )
+
+   print(string.format("%s: %d lookups: %.3f ms (stddev %.3f ms)",
+         name, #list*passes, mean, stddev ))
+end
+print("====== BENCHMARK END ======")
@@ -0,0 +1,32 @@
+--[[
+   Times spawning and removing batches of pilots of increasing size. The
+   time per pilot should stay flat as the batch grows; if it grows with the
+   batch, something done on every spawn is scanning the whole pilot stack.
+--]]
+local common = require "utils.benchmark.common"
+
+local reps = 5
+local sizes = { 100, 200, 400, 800, 1600 }
+
+print("====== BENCHMARK START ======")
+for i,n in ipairs(sizes) do
+   local vals = {}
+   for r=1,reps do
+      local plts = {}
+      local rstart = naev.clock()
+      for k=1,n do
+         local pos = vec2.newP( 5e3*rnd.rnd(), rnd.angle() )
+         table.insert( plts, pilot.add( "Llama", "Independent", pos, nil, {ai="dummy", naked=true} ) )
+      end
+      table.insert( vals, (naev.clock()-rstart)*1000 )
+      for k,p in ipairs(plts) do
+         p:rm()
+      end
+   end
+
+   local mean, stddev = common.mean_stddev( vals )
+
+   print(string.format("%d pilots: %.3f ms (stddev %.3f ms), %.2f us per pilot",
+         n, mean, stddev, mean * 1000 / n ))
+end
+print("====== BENCHMARK END ======")
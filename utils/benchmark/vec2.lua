@@ -0,0 +1,105 @@
+--[[
+   Compares vec2 code written with operators, which create a new vector for
+   every result, with the in-place methods and the bulk functions. Both the
+   time and the memory allocated by Lua are measured.
+--]]
+local common = require "utils.benchmark.common"
+
+local reps = 10
+local passes = 200
+local npoints = 100
+
+-- Random lanes and points to look them up from, like the AI does
+local lanes = {}
+local points = {}
+for i=1,npoints do
+   local a = vec2.newP( 10e3*rnd.rnd(), rnd.angle() )
+   table.insert( lanes, { a, a + vec2.newP( 3e3*rnd.rnd(), rnd.angle() ) } )
+   table.insert( points, vec2.newP( 10e3*rnd.rnd(), rnd.angle() ) )
+end
+
+local function closestPointLine( a, b, p )
+   local ap = p-a
+   local ab = b-a
+   local t  = ap:dot( ab ) / ab:dist2()
+   t = math.max( 0, math.min( 1, t ) )
+   return a + ab * t
+end
+
+local tests = {
+   { "lane distance (operators)", function ()
+      for i,p in ipairs(points) do
+         local d = math.huge
+         for k,v in ipairs(lanes) do
+            local dp = p:dist2( closestPointLine( v[1], v[2], p ) )
+            if dp < d then
+               d = dp
+            end
+         end
+      end
+   end },
+   { "lane distance (nearestLine)", function ()
+      for i,p in ipairs(points) do
+         p:nearestLine( lanes )
+      end
+   end },
+   { "nearest point (dist2)", function ()
+      for i,p in ipairs(points) do
+         local d = math.huge
+         for k,v in ipairs(points) do
+            local dp = v:dist2( p )
+            if dp < d then
+               d = dp
+            end
+         end
+      end
+   end },
+   { "nearest point (nearest)", function ()
+      for i,p in ipairs(points) do
+         p:nearest( points )
+      end
+   end },
+   { "steering (operators)", function ()
+      for i,p in ipairs(points) do
+         local v = vec2.new()
+         for k,t in ipairs(points) do
+            v = v + (t - p) * 0.5
+         end
+      end
+   end },
+   { "steering (in-place)", function ()
+      local d = vec2.new()
+      for i,p in ipairs(points) do
+         local v = vec2.new()
+         for k,t in ipairs(points) do
+            d:set( t )
+            v:add( d:sub( p ):mul( 0.5 ) )
+         end
+      end
+   end },
+}
+
+print("====== BENCHMARK START ======")
+for i,t in ipairs(tests) do
+   local name, func = t[1], t[2]
+   local vals = {}
+   local mem = 0
+   for r=1,reps do
+      collectgarbage()
+      collectgarbage("stop")
+      local mstart = collectgarbage("count")
+      local rstart = naev.clock()
+      for p=1,passes do
+         func()
+      end
+      table.insert( vals, (naev.clock()-rstart)*1000 )
+      mem = mem + collectgarbage("count") - mstart
+      collectgarbage("restart")
+   end
+
+   local mean, stddev = common.mean_stddev( vals )
+
+   print(string.format("%s: %.3f ms (stddev %.3f ms), %.1f KiB allocated per pass",
+         name, mean, stddev, mem / reps / passes ))
+end
+print("====== BENCHMARK END ======")